@@ -0,0 +1,5 @@
+function(hscopt_setup_features target)
+  if (HSCOPT_FEATURE_HHO_DEBUG_PASSES)
+    target_compile_definitions(${target} PRIVATE HSCOPT_HHO_DEBUG_PASSES=1)
+  endif()
+endfunction()
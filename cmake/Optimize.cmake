@@ -1,4 +1,5 @@
 include(CheckIPOSupported)
+include(CheckCSourceCompiles)
 
 function(hscopt_setup_optimization target)
   if (CMAKE_C_COMPILER_ID MATCHES "GNU|Clang")
@@ -21,6 +22,20 @@ function(hscopt_setup_optimization target)
       )
     endif()
 
+    # Com -march=native os kernels ja sao da maquina atual: sem clones.
+    if (HSCOPT_ENABLE_CPU_DISPATCH AND NOT HSCOPT_ENABLE_NATIVE)
+      check_c_source_compiles("
+        __attribute__((target_clones(\"default\", \"arch=x86-64-v3\",
+                                     \"arch=x86-64-v4\")))
+        int hscopt_tc(int x) { return x + 1; }
+        int main(void) { return hscopt_tc(-1); }" HSCOPT_HAVE_TARGET_CLONES)
+      if (HSCOPT_HAVE_TARGET_CLONES)
+        target_compile_definitions(${target} PRIVATE HSCOPT_CPU_DISPATCH=1)
+        # Sem contracao em FMA: todos os clones dao o mesmo resultado.
+        target_compile_options(${target} PRIVATE -ffp-contract=off)
+      endif()
+    endif()
+
     if (HSCOPT_ENABLE_VISIBILITY_HIDDEN)
       target_compile_options(${target} PRIVATE -fvisibility=hidden)
     endif()
@@ -2,11 +2,14 @@
 
 option(HSCOPT_ENABLE_OPENMP "Habilita OpenMP quando disponivel" ON)
 option(HSCOPT_ENABLE_LTO "Habilita IPO/LTO quando suportado" ON)
-option(HSCOPT_ENABLE_NATIVE "Habilita -march=native/-mtune=native" ON)
+option(HSCOPT_ENABLE_NATIVE "Habilita -march=native/-mtune=native" OFF)
+option(HSCOPT_ENABLE_CPU_DISPATCH
+  "Clona os kernels quentes para x86-64-v3/v4 com escolha em runtime" ON)
 option(HSCOPT_ENABLE_FAST_MATH "Habilita fast-math (pode mudar resultados)" OFF)
 option(HSCOPT_ENABLE_WARNINGS "Habilita avisos do compilador" ON)
 option(HSCOPT_ENABLE_STRICT_ALIASING "Habilita -fstrict-aliasing" ON)
 option(HSCOPT_ENABLE_VISIBILITY_HIDDEN "Habilita -fvisibility=hidden" ON)
 
-# Flags futuras (feature flags) - reserve este namespace
-# option(HSCOPT_FEATURE_X "Descricao" OFF)
+# Feature flags - reserve este namespace
+option(HSCOPT_FEATURE_HHO_DEBUG_PASSES
+  "HHO: refaz o clamp e as somas da populacao a cada iteracao (depuracao)" OFF)
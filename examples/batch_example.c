@@ -0,0 +1,79 @@
+/*
+ * batch_example.c
+ *
+ * Resolve um lote de instâncias pequenas, alternando HHO e RVNS, com
+ * hscopt_batch_solve() e recebe cada resultado em um callback.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hscopt/batch.h"
+#include "hscopt/solver.h"
+
+#define N_JOBS 1000
+
+// Cada instância é uma esfera com centro próprio.
+static double sphere(const double *keys, size_t n_keys,
+                     hscopt_decode_ctx *ctx) {
+  const double center = *(const double *)ctx->user;
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    const double d = keys[i] - center;
+    total += d * d;
+  }
+  return total;
+}
+
+static void on_done(const hscopt_batch_result *r, void *user) {
+  ((double *)user)[r->job] = r->best_fitness;
+}
+
+int main(void) {
+  static double centers[N_JOBS];
+  static double fitness[N_JOBS];
+  static hscopt_decode_ctx dctx[N_JOBS];
+  static hscopt_batch_job jobs[N_JOBS];
+  const hscopt_hho_params hho = {.n_agents = 10};
+  const hscopt_rvns_params rvns = {.k_max = 3, .x0 = NULL};
+
+  for (size_t i = 0; i < N_JOBS; ++i) {
+    centers[i] = 0.2 + 0.6 * (double)i / N_JOBS;
+    dctx[i].user = &centers[i];
+    const int use_hho = (i % 2 == 0);
+    jobs[i] = (hscopt_batch_job){
+        .vt = use_hho ? &hscopt_hho_solver : &hscopt_rvns_solver,
+        .cfg =
+            {
+                .dim = 8u + i % 24u,
+                .max_iters = 50,
+                .decoder = sphere,
+                .dctx = &dctx[i],
+                .params = use_hho ? (const void *)&hho : (const void *)&rvns,
+            },
+    };
+  }
+
+  hscopt_batch_opts opts;
+  hscopt_batch_opts_default(&opts);
+  opts.threads = 4;
+  opts.seed = 42;
+  opts.on_done = on_done;
+  opts.user = fitness;
+
+  hscopt_batch_stats st;
+  const int rc = hscopt_batch_solve(jobs, N_JOBS, &opts, &st);
+  if (rc != 0) {
+    fprintf(stderr, "Erro no lote: %d\n", rc);
+    return 1;
+  }
+
+  double worst = 0.0;
+  for (size_t i = 0; i < N_JOBS; ++i) {
+    if (fitness[i] > worst) worst = fitness[i];
+  }
+  printf("jobs: %d, pior fitness: %.6e\n", N_JOBS, worst);
+  printf("roubos: %zu, reaproveitados: %zu, criados: %zu\n", st.steals,
+         st.reuses, st.creates);
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hscopt/hybrid.h"
+#include "hscopt/rng.h"
+
+static double sphere_decoder(const double *keys, size_t n_keys,
+                             HSCOPT_UNUSED hscopt_decode_ctx *ctx) {
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    const double d = keys[i] - 0.3;
+    total += d * d;
+  }
+  return total;
+}
+
+int main(void) {
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, 42);
+
+  // 4 threads: 3 para o HHO e 1 dedicada ao RVNS.
+  hscopt_hybrid_ctx *ctx = hscopt_hybrid_create(
+      100, 50, 500, 4, 50, 4, sphere_decoder, NULL, &rng);
+  if (!ctx) {
+    fprintf(stderr, "Erro ao criar contexto hibrido\n");
+    return 1;
+  }
+
+  if (hscopt_hybrid_iterate(ctx, 500) != 0) {
+    fprintf(stderr, "Erro na execucao\n");
+    hscopt_hybrid_destroy(ctx);
+    return 1;
+  }
+
+  hscopt_hybrid_stats stats;
+  hscopt_hybrid_get_stats(ctx, &stats);
+  printf("Melhor: %.6f\n", hscopt_hybrid_best_fitness(ctx));
+  printf("Iteracoes RVNS: %llu, reinicios: %u, injecoes: %u\n",
+         stats.rvns_iters, stats.reseeds, stats.injections);
+
+  hscopt_hybrid_destroy(ctx);
+  return 0;
+}
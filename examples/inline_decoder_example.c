@@ -0,0 +1,57 @@
+/*
+ * inline_decoder_example.c
+ *
+ * Instancia HHO e RVNS com um decoder barato conhecido em tempo de
+ * compilação (HSCOPT_DEFINE_HHO / HSCOPT_DEFINE_RVNS), para que ele seja
+ * expandido inline nos laços de avaliação.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hscopt/hho_impl.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns_impl.h"
+
+static double sphere_decoder(const double *keys, size_t n_keys,
+                             HSCOPT_UNUSED hscopt_decode_ctx *ctx) {
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    const double d = keys[i] - 0.3;
+    total += d * d;
+  }
+  return total;
+}
+
+HSCOPT_DEFINE_HHO(sphere_hho, sphere_decoder)
+HSCOPT_DEFINE_RVNS(sphere_rvns, sphere_decoder)
+
+int main(void) {
+  const size_t dim = 32;  // usa também o kernel de dimensão fixa
+
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, 42);
+  hscopt_hho_ctx *hho = sphere_hho_create(dim, 30, 500, 1, NULL, &rng);
+  hscopt_rvns_ctx *rvns = sphere_rvns_create(NULL, dim, 5, 500, 1, NULL, &rng);
+  if (!hho || !rvns) {
+    fprintf(stderr, "Erro ao criar os contextos\n");
+    hscopt_hho_destroy(hho);
+    hscopt_rvns_destroy(rvns);
+    return 1;
+  }
+
+  if (sphere_hho_iterate(hho, 500) != 0 ||
+      sphere_rvns_iterate(rvns, 500) != 0) {
+    fprintf(stderr, "Erro na execucao\n");
+    hscopt_hho_destroy(hho);
+    hscopt_rvns_destroy(rvns);
+    return 1;
+  }
+
+  printf("HHO: %.6e  RVNS: %.6e\n", hscopt_hho_best_fitness(hho),
+         hscopt_rvns_best_fitness(rvns));
+
+  hscopt_hho_destroy(hho);
+  hscopt_rvns_destroy(rvns);
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * instance_example.c
+ *
+ * Grava uma instância de TSP (matriz de distâncias) no contêiner binário,
+ * mapeia o arquivo e a usa em um decoder via hscopt_decode_ctx::inst.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hscopt/hho.h"
+#include "hscopt/instance.h"
+#include "hscopt/keys.h"
+#include "hscopt/rng.h"
+
+#define N_CITIES 64
+
+typedef struct tsp_user {
+  const double *dist;  // [n * n], aponta para o arquivo mapeado
+  size_t n;
+} tsp_user;
+
+static double tsp_decoder(const double *keys, size_t n_keys,
+                          hscopt_decode_ctx *ctx) {
+  const tsp_user *u = (const tsp_user *)ctx->user;
+  size_t perm[N_CITIES];
+  hscopt_keys_argsort(keys, n_keys, perm, ctx->ws);
+
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    total += u->dist[perm[i] * u->n + perm[(i + 1) % n_keys]];
+  }
+  return total;
+}
+
+static int write_instance(const char *path) {
+  double xy[2 * N_CITIES];
+  double dist[N_CITIES * N_CITIES];
+
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, 7);
+  for (size_t i = 0; i < 2 * N_CITIES; ++i) xy[i] = hscopt_rng_next_u01(&rng);
+  for (size_t i = 0; i < N_CITIES; ++i) {
+    for (size_t j = 0; j < N_CITIES; ++j) {
+      const double dx = xy[2 * i] - xy[2 * j];
+      const double dy = xy[2 * i + 1] - xy[2 * j + 1];
+      dist[i * N_CITIES + j] = sqrt(dx * dx + dy * dy);
+    }
+  }
+
+  hscopt_instance_writer *w = hscopt_instance_writer_open(path);
+  if (!w) return 1;
+  hscopt_instance_write_dense(w, "coords", HSCOPT_ELEM_F64, xy, N_CITIES, 2);
+  hscopt_instance_write_dense(w, "dist", HSCOPT_ELEM_F64, dist, N_CITIES,
+                              N_CITIES);
+  return hscopt_instance_writer_close(w);
+}
+
+int main(void) {
+  const char *path = "tsp64.hsci";
+  if (write_instance(path) != 0) {
+    fprintf(stderr, "Erro ao gravar a instancia\n");
+    return 1;
+  }
+
+  // Em um serviço, só esta parte roda na inicialização: mmap sem cópia.
+  hscopt_instance *inst = hscopt_instance_open(path);
+  hscopt_section dist;
+  if (!inst || hscopt_instance_find(inst, "dist", &dist) != 0 ||
+      dist.elem != HSCOPT_ELEM_F64) {
+    fprintf(stderr, "Erro ao abrir a instancia\n");
+    hscopt_instance_close(inst);
+    return 1;
+  }
+
+  tsp_user user = {.dist = (const double *)dist.data, .n = dist.rows};
+  hscopt_workspace *ws = hscopt_workspace_create(N_CITIES);
+  hscopt_decode_ctx dctx = {.inst = inst, .user = &user, .ws = ws};
+
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, 42);
+  hscopt_hho_ctx *hho = hscopt_hho_create(N_CITIES, 30, 200, 1, tsp_decoder,
+                                          &dctx, &rng);
+  if (!hho || hscopt_hho_iterate(hho, 200) != 0) {
+    fprintf(stderr, "Erro na execucao\n");
+    hscopt_hho_destroy(hho);
+    hscopt_workspace_destroy(ws);
+    hscopt_instance_close(inst);
+    return 1;
+  }
+
+  printf("Secoes: %zu, melhor tour: %.6f\n", hscopt_instance_n_sections(inst),
+         hscopt_hho_best_fitness(hho));
+
+  hscopt_hho_destroy(hho);
+  hscopt_workspace_destroy(ws);
+  hscopt_instance_close(inst);
+  remove(path);
+  return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * pool_example.c
+ *
+ * Serve vários jobs pequenos, de tamanhos diferentes, em threads
+ * trabalhadoras que pegam contextos HHO já alocados de um pool.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <threads.h>
+
+#include "hscopt/hho.h"
+#include "hscopt/pool.h"
+#include "hscopt/rng.h"
+#include "hscopt/solver.h"
+
+#define N_WORKERS 4
+#define JOBS_PER_WORKER 50
+
+static double sphere(const double *keys, size_t n_keys,
+                     HSCOPT_UNUSED hscopt_decode_ctx *ctx) {
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    const double d = keys[i] - 0.5;
+    total += d * d;
+  }
+  return total;
+}
+
+static hscopt_solver_pool *pool;
+
+static int worker(void *arg) {
+  const unsigned id = (unsigned)(size_t)arg;
+  for (unsigned j = 0; j < JOBS_PER_WORKER; ++j) {
+    hscopt_rng rng;
+    hscopt_rng_seed(&rng, 1000u * id + j);
+
+    // Dimensão e população variam de job para job.
+    const hscopt_hho_params params = {.n_agents = 8u + j % 24u};
+    const hscopt_solver_config cfg = {
+        .dim = 16u + (size_t)((id * 37u + j * 11u) % 100u),
+        .max_iters = 100,
+        .max_threads = 1,
+        .decoder = sphere,
+        .rng = &rng,
+        .params = &params,
+    };
+
+    void *s = hscopt_solver_pool_acquire(pool, &cfg);
+    if (!s) return 1;
+    hscopt_hho_solver.iterate(s, cfg.max_iters);
+    if (j == 0) {
+      printf("worker %u: dim %zu -> %.6e\n", id, cfg.dim,
+             hscopt_hho_solver.best_fitness(s));
+    }
+    hscopt_solver_pool_release(pool, s);
+  }
+  return 0;
+}
+
+int main(void) {
+  pool = hscopt_solver_pool_create(&hscopt_hho_solver, N_WORKERS);
+  if (!pool) {
+    fprintf(stderr, "Erro ao criar o pool\n");
+    return 1;
+  }
+
+  thrd_t threads[N_WORKERS];
+  for (unsigned i = 0; i < N_WORKERS; ++i) {
+    thrd_create(&threads[i], worker, (void *)(size_t)i);
+  }
+  int rc = 0;
+  for (unsigned i = 0; i < N_WORKERS; ++i) {
+    int res = 0;
+    thrd_join(threads[i], &res);
+    rc |= res;
+  }
+
+  hscopt_solver_pool_stats st;
+  hscopt_solver_pool_get_stats(pool, &st);
+  printf("jobs: %llu, reaproveitados: %llu, criados: %llu\n",
+         (unsigned long long)st.acquires, (unsigned long long)st.reuses,
+         (unsigned long long)st.creates);
+
+  hscopt_solver_pool_destroy(pool);
+  return rc;
+}
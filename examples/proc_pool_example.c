@@ -0,0 +1,71 @@
+/*
+ * proc_pool_example.c
+ *
+ * Roda em paralelo um decoder que não é thread-safe (usa um buffer
+ * estático), com um pool de processos no lugar de threads.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hscopt/hho.h"
+#include "hscopt/proc_pool.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+
+#define DIM 64
+
+// Decoder legado: estado global, não pode rodar em duas threads ao mesmo
+// tempo. Em processos separados, cada um tem a sua cópia.
+static double scratch[DIM];
+
+static double legacy_decoder(const double *keys, size_t n_keys,
+                             HSCOPT_UNUSED hscopt_decode_ctx *ctx) {
+  double total = 0.0;
+  for (size_t i = 0; i < n_keys; ++i) {
+    scratch[i] = keys[i] - 0.5;
+  }
+  for (size_t i = 0; i < n_keys; ++i) {
+    total += scratch[i] * scratch[i];
+  }
+  return total;
+}
+
+int main(void) {
+  // Crie o pool antes de qualquer região paralela.
+  hscopt_proc_pool *pool = hscopt_proc_pool_create(DIM, 4, 0, legacy_decoder,
+                                                   NULL);
+  if (!pool) {
+    fprintf(stderr, "Erro ao criar o pool\n");
+    return 1;
+  }
+  hscopt_async_decoder ad;
+  hscopt_proc_pool_get(pool, &ad);
+
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, 42);
+
+  // max_threads = 1: o paralelismo vem dos processos.
+  hscopt_hho_ctx *hho = hscopt_hho_create(DIM, 128, 200, 1, legacy_decoder,
+                                          NULL, &rng);
+  hscopt_rvns_ctx *rvns = hscopt_rvns_create(NULL, DIM, 5, 200, 1,
+                                             legacy_decoder, NULL, &rng);
+  int rc = (!hho || !rvns);
+  rc = rc || hscopt_hho_set_async(hho, &ad) != 0;
+  rc = rc || hscopt_rvns_set_async(rvns, &ad) != 0;
+  rc = rc || hscopt_rvns_set_candidates(rvns, 32) != 0;
+  rc = rc || hscopt_hho_reset(hho) != 0 || hscopt_rvns_reset(rvns, NULL) != 0;
+  rc = rc || hscopt_hho_iterate(hho, 200) != 0;
+  rc = rc || hscopt_rvns_iterate(rvns, 200) != 0;
+  if (rc) {
+    fprintf(stderr, "Erro na execucao\n");
+  } else {
+    printf("HHO:  %.6e\n", hscopt_hho_best_fitness(hho));
+    printf("RVNS: %.6e\n", hscopt_rvns_best_fitness(rvns));
+  }
+
+  hscopt_rvns_destroy(rvns);
+  hscopt_hho_destroy(hho);
+  hscopt_proc_pool_destroy(pool);
+  return rc;
+}
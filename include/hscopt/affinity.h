@@ -0,0 +1,74 @@
+#ifndef HSCOPT_AFFINITY_H
+#define HSCOPT_AFFINITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file affinity.h
+ * @brief Políticas de afinidade de CPU para as threads de avaliação.
+ *
+ * Em máquinas NUMA, fixar cada thread de avaliação em uma CPU mantém as
+ * linhas da população (inicializadas por first-touch pela própria thread) no
+ * nó de memória local. A topologia é lida de `/sys/devices/system/cpu` e
+ * restrita às CPUs permitidas ao processo.
+ *
+ * Os solvers fixam as threads só durante as suas regiões paralelas: ao fim
+ * de cada uma, cada thread (inclusive a chamadora) volta à máscara que
+ * tinha, e o resto do processo não herda a afinidade.
+ */
+
+/**
+ * @enum hscopt_affinity
+ * @brief Política de distribuição das threads nas CPUs.
+ */
+typedef enum hscopt_affinity {
+  HSCOPT_AFFINITY_NONE = 0,  // não fixa as threads (default)
+  HSCOPT_AFFINITY_COMPACT,   // preenche um socket (e seus SMT) antes do próximo
+  HSCOPT_AFFINITY_SCATTER,   // alterna entre sockets
+  HSCOPT_AFFINITY_SMT_AWARE  // um núcleo físico por thread antes de usar SMT
+} hscopt_affinity;
+
+/**
+ * @brief Calcula a CPU de cada thread segundo a política.
+ *
+ * Com mais threads do que CPUs permitidas, a lista é repetida.
+ *
+ * @param policy Política (diferente de ::HSCOPT_AFFINITY_NONE).
+ * @param n_threads Número de threads (>= 1).
+ * @param cpus Saída com a CPU da thread t em `cpus[t]` (tamanho @p n_threads).
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se a plataforma não
+ * suportar afinidade.
+ */
+int hscopt_affinity_plan(hscopt_affinity policy, unsigned n_threads,
+                         int *cpus);
+
+/**
+ * @brief Fixa a thread chamadora na CPU @p cpu.
+ *
+ * Chamadas repetidas com a mesma CPU na mesma thread não refazem a chamada de
+ * sistema. A primeira fixação guarda a máscara que a thread tinha, restaurada
+ * por hscopt_affinity_unpin_current().
+ *
+ * @param cpu Índice da CPU.
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_affinity_pin_current(int cpu);
+
+/**
+ * @brief Devolve a thread chamadora à máscara que ela tinha antes de
+ * hscopt_affinity_pin_current().
+ *
+ * Sem fixação pendente na thread, não faz nada.
+ *
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_affinity_unpin_current(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_AFFINITY_H */
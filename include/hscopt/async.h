@@ -0,0 +1,158 @@
+#ifndef HSCOPT_ASYNC_H
+#define HSCOPT_ASYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file async.h
+ * @brief Contrato de decoder assíncrono (submit/poll) para avaliadores fora
+ * do processo.
+ *
+ * Quando a função objetivo roda em outro processo (um simulador acessado por
+ * pipe ou socket), um ::hscopt_decoder_fn síncrono bloqueia uma thread
+ * inteira por avaliação. Com o contrato assíncrono, o solver envia várias
+ * avaliações (`submit`) e coleta as que terminarem (`poll`/`wait_any`), em
+ * qualquer ordem, identificando cada uma pela tag que escolheu: uma única
+ * thread mantém centenas de avaliações em andamento.
+ *
+ * HHO e RVNS usam o contrato via hscopt_hho_set_async() e
+ * hscopt_rvns_set_async(). Para testes, hscopt_pipe_eval_create() cria
+ * processos avaliadores locais que executam um decoder comum.
+ */
+
+/**
+ * @struct hscopt_async_result
+ * @brief Avaliação concluída.
+ */
+typedef struct hscopt_async_result {
+  uint64_t tag;    // tag passada em submit
+  double fitness;  // valor da função objetivo
+} hscopt_async_result;
+
+/**
+ * @struct hscopt_async_decoder
+ * @brief Vtable de um avaliador assíncrono.
+ *
+ * - `submit` inicia a avaliação de @p keys e retorna 0 se aceitou, 1 se não
+ *   há vaga no momento (colete resultados e tente de novo) ou 2 em erro. As
+ *   chaves são copiadas ou enviadas antes do retorno.
+ * - `poll` copia até @p max resultados prontos para @p out, sem bloquear, e
+ *   retorna quantos copiou (-1 em erro).
+ * - `wait_any` faz o mesmo, mas bloqueia até haver ao menos um resultado;
+ *   retorna 0 se não há avaliações pendentes.
+ *
+ * Os resultados podem chegar em qualquer ordem. As funções são chamadas por
+ * uma thread de cada vez.
+ */
+typedef struct hscopt_async_decoder {
+  int (*submit)(void *self, const double *keys, size_t n, uint64_t tag);
+  int (*poll)(void *self, hscopt_async_result *out, size_t max);
+  int (*wait_any)(void *self, hscopt_async_result *out, size_t max);
+  size_t max_in_flight;  // limite de avaliações pendentes (0 = sem limite)
+  void *self;            // estado do avaliador
+} hscopt_async_decoder;
+
+/**
+ * @brief Avalia um lote de vetores de chaves via contrato assíncrono.
+ *
+ * Mantém até `max_in_flight` avaliações pendentes e aceita os resultados em
+ * qualquer ordem. A linha k usa a tag k.
+ *
+ * @param ad Avaliador.
+ * @param rows Ponteiros para os vetores de chaves [count].
+ * @param n Número de chaves de cada vetor.
+ * @param count Número de vetores.
+ * @param out Saída: out[k] recebe o objetivo de rows[k].
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 em erro do avaliador.
+ */
+int hscopt_async_eval(const hscopt_async_decoder *ad,
+                      const double *const *rows, size_t n, size_t count,
+                      double *out);
+
+/**
+ * @brief Decoder síncrono que delega a um avaliador assíncrono.
+ *
+ * Use `ctx->user` = ponteiro para o ::hscopt_async_decoder. Útil como
+ * decoder de criação dos solvers quando a função objetivo só existe no
+ * avaliador externo.
+ *
+ * @param keys Chaves.
+ * @param n Número de chaves.
+ * @param ctx Contexto (`user` = avaliador).
+ * @return Objetivo, ou INFINITY em erro.
+ *
+ * @note Não é thread-safe e não deve ser usado enquanto houver um lote em
+ * andamento no mesmo avaliador.
+ */
+double hscopt_async_decode(const double *keys, size_t n,
+                           hscopt_decode_ctx *ctx);
+
+/**
+ * @brief Avaliador local em processos filhos, ligados por sockets.
+ */
+typedef struct hscopt_pipe_eval hscopt_pipe_eval;
+
+/**
+ * @brief Cria processos avaliadores que executam @p decoder.
+ *
+ * Cada processo (criado via `fork`) lê pedidos `(tag, chaves)` do seu
+ * socket, avalia em ordem e devolve `(tag, objetivo)`. Os pedidos vão para o
+ * processo com menos avaliações pendentes, então os resultados de processos
+ * diferentes chegam fora de ordem.
+ *
+ * @param n_keys Número de chaves de cada pedido.
+ * @param n_procs Número de processos (0 = 1).
+ * @param slots Avaliações pendentes por processo (0 = 64).
+ * @param decoder Decoder executado nos processos filhos.
+ * @param dctx Contexto do decoder (copiado pelo fork).
+ * @return Avaliador, ou NULL em erro (ou plataforma sem suporte).
+ *
+ * @note Crie o avaliador antes de iniciar regiões paralelas: o filho herda
+ * apenas a thread que chamou `fork`.
+ */
+hscopt_pipe_eval *hscopt_pipe_eval_create(size_t n_keys, unsigned n_procs,
+                                          size_t slots,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx);
+
+/**
+ * @brief Cria processos avaliadores com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global. O alocador só é usado no
+ * processo que cria o avaliador; os filhos usam a libc.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Avaliador, ou NULL em erro (ou plataforma sem suporte).
+ */
+hscopt_pipe_eval *hscopt_pipe_eval_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t slots, hscopt_decoder_fn decoder,
+    hscopt_decode_ctx *dctx, const hscopt_allocator *alloc);
+
+/**
+ * @brief Encerra os processos e libera o avaliador.
+ *
+ * @param pe Avaliador.
+ */
+void hscopt_pipe_eval_destroy(hscopt_pipe_eval *pe);
+
+/**
+ * @brief Preenche um ::hscopt_async_decoder que usa o avaliador.
+ *
+ * @param pe Avaliador.
+ * @param out Saída.
+ */
+void hscopt_pipe_eval_get(hscopt_pipe_eval *pe, hscopt_async_decoder *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_ASYNC_H */
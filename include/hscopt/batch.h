@@ -0,0 +1,134 @@
+#ifndef HSCOPT_BATCH_H
+#define HSCOPT_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/solver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file batch.h
+ * @brief Resolução em lote de muitas instâncias pequenas e independentes.
+ *
+ * Em instâncias pequenas, paralelizar dentro de uma execução não compensa.
+ * hscopt_batch_solve() distribui execuções inteiras entre threads: cada job
+ * roda com uma thread, do início ao fim, na thread que o pegou.
+ *
+ * - Os jobs são repartidos em faixas contíguas, uma por thread. Cada faixa
+ *   é um par (início, fim) em um único inteiro atômico de 64 bits: a dona
+ *   consome pelo início, e uma thread sem trabalho rouba a metade final da
+ *   faixa de outra com um único CAS.
+ * - Cada thread guarda um solver por vtable e o reaproveita entre jobs via
+ *   `reconfigure` (hscopt_hho_reconfigure(), hscopt_rvns_reconfigure()).
+ * - O RNG do job i é semeado a partir de (seed, i): o resultado de cada job
+ *   não depende do número de threads nem da ordem de execução.
+ * - Cada resultado é entregue ao callback assim que o job termina.
+ *
+ * @code
+ * static void done(const hscopt_batch_result *r, void *user) {
+ *   ((double *)user)[r->job] = r->best_fitness;
+ * }
+ *
+ * hscopt_batch_opts o;
+ * hscopt_batch_opts_default(&o);
+ * o.threads = 8;
+ * o.on_done = done;
+ * o.user = fitness_out;
+ * hscopt_batch_solve(jobs, n_jobs, &o, NULL);
+ * @endcode
+ */
+
+/**
+ * @struct hscopt_batch_job
+ * @brief Um job: algoritmo, instância, decoder e orçamento.
+ *
+ * `cfg.dctx` aponta para a instância, e `cfg.max_iters` é o orçamento (o job
+ * roda todas as iterações). `cfg.rng` e `cfg.max_threads` são ignorados: o
+ * lote define o RNG e usa uma thread por job. Jobs com a mesma vtable devem
+ * usar o mesmo `cfg.alloc`.
+ */
+typedef struct hscopt_batch_job {
+  const hscopt_solver_vtable *vt;  // algoritmo (ex.: &hscopt_hho_solver)
+  hscopt_solver_config cfg;        // instância, decoder e orçamento
+  void *user;                      // repassado em ::hscopt_batch_result
+} hscopt_batch_job;
+
+/**
+ * @struct hscopt_batch_result
+ * @brief Resultado de um job, entregue ao callback.
+ */
+typedef struct hscopt_batch_result {
+  size_t job;              // índice do job
+  void *user;              // hscopt_batch_job::user
+  int status;              // 0, código de `iterate`, ou -1 se não criou
+  double best_fitness;     // melhor fitness (INFINITY se não criou)
+  const double *best_keys; // melhores chaves, válidas só durante o callback
+  unsigned iterations;     // iterações executadas
+} hscopt_batch_result;
+
+/**
+ * @brief Callback de conclusão de um job.
+ *
+ * Chamado pela thread que rodou o job, logo ao terminar; várias threads
+ * podem chamá-lo ao mesmo tempo.
+ */
+typedef void (*hscopt_batch_done_fn)(const hscopt_batch_result *r,
+                                     void *user);
+
+/**
+ * @struct hscopt_batch_opts
+ * @brief Opções do lote.
+ */
+typedef struct hscopt_batch_opts {
+  unsigned threads;              // threads (a chamadora é uma delas)
+  uint64_t seed;                 // semente dos RNGs dos jobs
+  hscopt_batch_done_fn on_done;  // callback (pode ser NULL)
+  void *user;                    // repassado ao callback
+} hscopt_batch_opts;
+
+/**
+ * @struct hscopt_batch_stats
+ * @brief Contadores de uma chamada de hscopt_batch_solve().
+ */
+typedef struct hscopt_batch_stats {
+  size_t failed;   // jobs com status != 0
+  size_t steals;   // faixas roubadas
+  size_t reuses;   // jobs que reaproveitaram um solver da thread
+  size_t creates;  // solvers criados
+} hscopt_batch_stats;
+
+/**
+ * @brief Preenche as opções default (1 thread, seed 0, sem callback).
+ *
+ * @param out Saída.
+ */
+void hscopt_batch_opts_default(hscopt_batch_opts *out);
+
+/**
+ * @brief Resolve todos os jobs.
+ *
+ * @param jobs Jobs [n].
+ * @param n Número de jobs (>= 1, < 2^32).
+ * @param opts Opções (NULL = default).
+ * @param stats Contadores (pode ser NULL).
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se algum job falhar
+ * (os demais rodam normalmente), 3 se alguma thread não puder ser criada
+ * (os jobs dela são roubados pelas demais), 4 se faltar memória para os
+ * workers (nenhum job roda).
+ *
+ * @note Decoders de jobs diferentes rodam ao mesmo tempo; o mesmo decoder
+ * e o mesmo dctx podem estar em uso por várias threads.
+ */
+int hscopt_batch_solve(const hscopt_batch_job *jobs, size_t n,
+                       const hscopt_batch_opts *opts,
+                       hscopt_batch_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_BATCH_H */
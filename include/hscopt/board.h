@@ -0,0 +1,144 @@
+#ifndef HSCOPT_BOARD_H
+#define HSCOPT_BOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/alloc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file board.h
+ * @brief Quadro da melhor solução, para leitores e escritores concorrentes.
+ *
+ * Os ponteiros de hscopt_hho_best_keys() e hscopt_rvns_best_keys() só valem
+ * entre chamadas de iterate, e hscopt_hho_try_update_rabbit() não é
+ * thread-safe. O quadro guarda a melhor solução publicada e pode ser lido e
+ * escrito por qualquer thread a qualquer momento, sem mutex:
+ *
+ * - o fitness publicado é um atômico, lido sem copiar as chaves;
+ * - as chaves ficam em dois buffers: a publicação escreve no inativo e só
+ *   então o torna ativo, então quem está lendo o ativo não é atrapalhado;
+ * - cada buffer tem um contador de sequência (seqlock), e o leitor refaz a
+ *   cópia se o buffer mudar durante a leitura (duas publicações no meio
+ *   dela);
+ * - um contador de versão conta as publicações.
+ *
+ * As publicações são serializadas entre si por uma tentativa atômica, sem
+ * espera: quem encontra outra em andamento recebe -2 e tenta de novo depois
+ * (ou desiste, se a publicação em andamento já for tão boa quanto a sua).
+ *
+ * Com hscopt_hho_set_board() e hscopt_rvns_set_board(), o solver publica o
+ * seu melhor e adota soluções melhores do quadro ao fim de cada iteração,
+ * na sua própria thread.
+ *
+ * @code
+ * hscopt_board *b = hscopt_board_create(dim);
+ * hscopt_hho_set_board(hho, b);
+ *
+ * // thread de monitoramento
+ * double keys[DIM], f;
+ * uint64_t v;
+ * hscopt_board_read(b, keys, &f, &v);
+ *
+ * // heurística externa
+ * hscopt_board_offer(b, my_keys, my_fitness);
+ * @endcode
+ */
+
+/**
+ * @brief Quadro opaco da melhor solução.
+ */
+typedef struct hscopt_board hscopt_board;
+
+/**
+ * @brief Cria um quadro vazio (fitness INFINITY, versão 0).
+ *
+ * @param dim Número de chaves (>= 1).
+ * @return Quadro, ou NULL em erro.
+ */
+hscopt_board *hscopt_board_create(size_t dim);
+
+/**
+ * @brief Cria um quadro com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Quadro, ou NULL em erro.
+ */
+hscopt_board *hscopt_board_create_with_allocator(
+    size_t dim, const hscopt_allocator *alloc);
+
+/**
+ * @brief Libera o quadro.
+ *
+ * Nenhuma thread pode estar usando o quadro, e os solvers ligados a ele
+ * devem ser desligados (`set_board(ctx, NULL)`) ou destruídos antes.
+ *
+ * @param b Quadro.
+ */
+void hscopt_board_destroy(hscopt_board *b);
+
+/**
+ * @brief Retorna o número de chaves do quadro.
+ *
+ * @param b Quadro.
+ * @return dim.
+ */
+size_t hscopt_board_dim(const hscopt_board *b);
+
+/**
+ * @brief Publica (@p keys, @p fitness) se @p fitness for menor que o do
+ * quadro.
+ *
+ * O quadro confia em @p fitness; solvers ligados ao quadro reavaliam as
+ * chaves antes de adotá-las.
+ *
+ * @param b Quadro.
+ * @param keys Chaves (tamanho dim).
+ * @param fitness Objetivo das chaves.
+ * @return 1 se publicou, 0 se não melhora o quadro (nem a publicação em
+ * andamento), -1 em argumentos inválidos, -2 se outra publicação estava em
+ * andamento (nada foi escrito; ofereça de novo).
+ */
+int hscopt_board_offer(hscopt_board *b, const double *keys, double fitness);
+
+/**
+ * @brief Copia a solução publicada, de forma consistente.
+ *
+ * Nunca bloqueia os escritores. Com o quadro vazio, @p keys não é alterado.
+ *
+ * @param b Quadro.
+ * @param keys Saída com as chaves (tamanho dim).
+ * @param fitness Saída com o objetivo das chaves (pode ser NULL).
+ * @param version Saída com a versão lida (pode ser NULL).
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ */
+int hscopt_board_read(const hscopt_board *b, double *keys, double *fitness,
+                      uint64_t *version);
+
+/**
+ * @brief Fitness publicado (INFINITY com o quadro vazio).
+ *
+ * @param b Quadro.
+ * @return Fitness.
+ */
+double hscopt_board_fitness(const hscopt_board *b);
+
+/**
+ * @brief Número de publicações desde a criação.
+ *
+ * @param b Quadro.
+ * @return Versão.
+ */
+uint64_t hscopt_board_version(const hscopt_board *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_BOARD_H */
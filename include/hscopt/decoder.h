@@ -1,6 +1,7 @@
 #ifndef HSCOPT_DECODER_H
 #define HSCOPT_DECODER_H
 
+#include <math.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -23,9 +24,46 @@ typedef struct hscopt_instance hscopt_instance;
  * @brief Tipo opaco para workspace reutilizável.
  *
  * Pode armazenar buffers temporários para evitar alocações repetidas.
+ * Criado com hscopt_workspace_create() (ver keys.h).
  */
 typedef struct hscopt_workspace hscopt_workspace;
 
+/**
+ * @brief Tipo opaco para a permutação induzida pelas chaves.
+ *
+ * Mantida incrementalmente pelos solvers que a suportam (ver keys.h e
+ * hscopt_rvns_set_track_perm()).
+ */
+typedef struct hscopt_keys_perm hscopt_keys_perm;
+
+/**
+ * @struct hscopt_keys_delta
+ * @brief Diferença entre as chaves avaliadas e uma avaliação anterior.
+ *
+ * Preenchida pelos solvers que mudam só parte das chaves por movimento (ver
+ * hscopt_hho_set_block()): `keys[j]` só difere da avaliação de base para j
+ * em [lo, hi), e `old` guarda os valores de base desse trecho. Um decoder
+ * com avaliação incremental pode partir de `base_fitness` e recalcular só
+ * o trecho:
+ *
+ * @code
+ * const hscopt_keys_delta *d = ctx->delta;
+ * if (d) {
+ *   double f = d->base_fitness;
+ *   for (size_t j = d->lo; j < d->hi; ++j) {
+ *     f += cost(keys[j], j) - cost(d->old[j - d->lo], j);
+ *   }
+ *   return f;
+ * }
+ * @endcode
+ */
+typedef struct hscopt_keys_delta {
+  size_t lo;            // primeira chave alterada
+  size_t hi;            // uma depois da última chave alterada
+  const double *old;    // valores de base de keys[lo, hi) [hi - lo]
+  double base_fitness;  // objetivo exato das chaves de base
+} hscopt_keys_delta;
+
 /**
  * @struct hscopt_decode_ctx
  * @brief Contexto passado ao decoder.
@@ -33,15 +71,50 @@ typedef struct hscopt_workspace hscopt_workspace;
  * Permite ao decoder acessar:
  * - a instância do problema (somente leitura),
  * - um ponteiro de usuário (opcional),
- * - um workspace reutilizável (opcional).
+ * - um workspace reutilizável (opcional),
+ * - a permutação induzida pelas chaves avaliadas (opcional),
+ * - um limite de corte para avaliação limitada (opcional),
+ * - as chaves alteradas desde uma avaliação anterior (opcional).
  */
 typedef struct hscopt_decode_ctx {
   const hscopt_instance *inst;  // Instância do problema (somente leitura)
   void *user;  // Ponteiro opcional para dados do usuário (pode ser NULL)
   hscopt_workspace *ws;  // Workspace reutilizável (pode ser NULL), use isso
                          // para evitar alocações durante as execuções
+  const hscopt_keys_perm *perm;  // Ordem das keys avaliadas (pode ser NULL),
+                                 // preenchida pelo solver quando mantida
+                                 // incrementalmente
+  double cutoff;  // Limite de corte, válido só se bounded != 0
+  int bounded;    // 1 quando o solver só precisa saber se objetivo < cutoff
+  const hscopt_keys_delta *delta;  // Chaves alteradas (pode ser NULL),
+                                   // preenchido pelo solver; NULL no dctx
+                                   // do usuário
 } hscopt_decode_ctx;
 
+/**
+ * @brief Limite de corte da avaliação atual.
+ *
+ * Com `ctx->bounded`, o solver só aproveita o objetivo se ele for menor que
+ * `ctx->cutoff` (ex.: o objetivo atual do hawk ou da incumbente). Um decoder
+ * que acumula o custo aos poucos pode parar assim que o custo parcial
+ * atingir o corte e retornar qualquer valor >= cutoff (o próprio custo
+ * parcial ou INFINITY):
+ *
+ * @code
+ * const double cut = hscopt_decode_cutoff(ctx);
+ * for (...) {
+ *   cost += ...;
+ *   if (cost >= cut) return cost;  // pior que o corte: resultado limitado
+ * }
+ * @endcode
+ *
+ * @param ctx Contexto (pode ser NULL).
+ * @return `ctx->cutoff`, ou INFINITY se não houver corte.
+ */
+static inline double hscopt_decode_cutoff(const hscopt_decode_ctx *ctx) {
+  return (ctx && ctx->bounded) ? ctx->cutoff : INFINITY;
+}
+
 /**
  * @typedef hscopt_decoder_fn
  * @brief Assinatura de função decoder: keys -> objetivo.
@@ -58,6 +131,8 @@ typedef struct hscopt_decode_ctx {
  * - Evitar alocações e I/O no hot loop.
  * - Ser determinístico para a mesma entrada (keys, ctx).
  * - Se usado com OpenMP, deve ser thread-safe quando chamado em paralelo.
+ * - Com `ctx->bounded`, pode retornar cedo qualquer valor >= `ctx->cutoff`
+ *   (ver hscopt_decode_cutoff()); abaixo do corte, o valor deve ser exato.
  */
 typedef double (*hscopt_decoder_fn)(const double *keys, size_t n,
                                     hscopt_decode_ctx *ctx);
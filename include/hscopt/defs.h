@@ -40,6 +40,23 @@
   #define HSCOPT_UNLIKELY(x) (x)
 #endif
 
+/**
+ * @brief Compila a função também para x86-64-v3 (AVX2/FMA) e x86-64-v4
+ * (AVX-512), com a versão escolhida em runtime (ifunc) pela CPU que executa.
+ *
+ * Usado nos kernels quentes (iteração do HHO e do RVNS, preenchimento do RNG).
+ * Só tem efeito com `HSCOPT_CPU_DISPATCH` definido, o que a opção CMake
+ * `HSCOPT_ENABLE_CPU_DISPATCH` faz quando o compilador suporta; senão, expande
+ * para nada.
+ */
+#if defined(HSCOPT_CPU_DISPATCH) && defined(__x86_64__) && defined(__GNUC__)
+  #define HSCOPT_TARGET_CLONES                                  \
+    __attribute__((target_clones("default", "arch=x86-64-v3", \
+                                 "arch=x86-64-v4")))
+#else
+  #define HSCOPT_TARGET_CLONES
+#endif
+
 /**
  * @brief Restringe um valor ao intervalo [lo, hi].
  * @param x Valor.
@@ -84,6 +101,15 @@
     (b) = _tmp;                 \
   } while (0)
 
+/**
+ * @brief Dimensões com kernels especializados em tempo de compilação.
+ *
+ * X-macro: `HSCOPT_FOR_EACH_FIXED_DIM(X)` expande `X(d)` para cada dimensão.
+ * HHO e RVNS instanciam a iteração com `dim` constante para cada uma delas e
+ * escolhem a instância na criação; as demais dimensões usam o kernel genérico.
+ */
+#define HSCOPT_FOR_EACH_FIXED_DIM(X) X(16) X(32) X(64) X(128)
+
 /**
  * @brief Constante pi em double
  */
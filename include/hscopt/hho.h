@@ -3,9 +3,13 @@
 
 #include <stddef.h>
 
+#include "hscopt/affinity.h"
 #include "hscopt/alloc.h"
+#include "hscopt/async.h"
+#include "hscopt/board.h"
 #include "hscopt/decoder.h"
 #include "hscopt/rng.h"
+#include "hscopt/surrogate.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +50,11 @@ typedef struct hscopt_hho_ctx hscopt_hho_ctx;
  * @param rng Gerador de números aleatórios (obrigatório).
  *
  * @return Ponteiro para o contexto HHO em caso de sucesso, ou NULL em erro.
+ *
+ * @note @p rng é usado apenas para gerar a chave de um RNG por contador
+ * (::hscopt_ctr_rng) a cada reset; os sorteios da população inicial e das
+ * iterações são indexados por (iteração, agente), então o resultado não
+ * depende do número de threads.
  */
 hscopt_hho_ctx *hscopt_hho_create(size_t dim, size_t n_agents,
                                   unsigned max_iters, unsigned max_threads,
@@ -65,6 +74,33 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
     hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx, hscopt_rng *rng,
     const hscopt_allocator *alloc);
 
+/**
+ * @brief Cria o HHO com alocador customizado e política de afinidade.
+ *
+ * Os agentes são divididos em blocos contíguos fixos por thread. Cada thread
+ * inicializa (first-touch) e avalia sempre o mesmo bloco de linhas da
+ * população, de modo que, em máquinas NUMA, as páginas ficam no nó da thread
+ * que as usa. Com @p affinity != ::HSCOPT_AFFINITY_NONE, as threads de
+ * avaliação (inclusive a chamadora, como thread 0) são fixadas nas CPUs
+ * dadas por hscopt_affinity_plan().
+ *
+ * A fixação vale só dentro das regiões paralelas do contexto: ao fim de cada
+ * uma, as threads voltam à máscara que tinham. Contextos que rodam ao mesmo
+ * tempo (ex.: portfólio, híbrido) com a mesma política fixam as suas threads
+ * nas mesmas CPUs; use afinidade em um só deles.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @param affinity Política de afinidade.
+ * @return Ponteiro para o contexto em caso de sucesso, ou NULL em erro.
+ *
+ * @note A afinidade só tem efeito com OpenMP; em plataformas sem suporte o
+ * contexto é criado sem afinidade.
+ */
+hscopt_hho_ctx *hscopt_hho_create_with_affinity(
+    size_t dim, size_t n_agents, unsigned max_iters, unsigned max_threads,
+    hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx, hscopt_rng *rng,
+    const hscopt_allocator *alloc, hscopt_affinity affinity);
+
 /**
  * @brief Libera todos os recursos associados ao contexto HHO.
  *
@@ -87,6 +123,34 @@ void hscopt_hho_destroy(hscopt_hho_ctx *ctx);
  */
 int hscopt_hho_reset(hscopt_hho_ctx *ctx);
 
+/**
+ * @brief Reaproveita o contexto para outro problema.
+ *
+ * Troca dimensão, número de agentes, limite de iterações e decoder e
+ * reinicializa a população no lugar (como hscopt_hho_reset()). Os buffers só
+ * são realocados se @p dim ou @p n_agents passarem da maior configuração já
+ * usada pelo contexto; threads, afinidade, alocador, RNG, corte e avaliador
+ * assíncrono são mantidos. O modelo substituto é desligado se a sua
+ * dimensão não for @p dim.
+ *
+ * @param ctx Contexto HHO.
+ * @param dim Número de chaves.
+ * @param n_agents Número de hawks.
+ * @param max_iters Número máximo de iterações.
+ * @param decoder Decoder.
+ * @param dctx Contexto do decoder (pode ser NULL).
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória (o
+ * contexto fica como estava), 2 se a avaliação assíncrona da população
+ * falhar.
+ *
+ * @note hscopt_hho_reset() sorteia a nova população do mesmo RNG: a mesma
+ * sequência de jobs produz os mesmos resultados que contextos novos
+ * criados com o RNG no mesmo estado.
+ */
+int hscopt_hho_reconfigure(hscopt_hho_ctx *ctx, size_t dim, size_t n_agents,
+                           unsigned max_iters, hscopt_decoder_fn decoder,
+                           hscopt_decode_ctx *dctx);
+
 /**
  * @brief Executa um número de iterações do HHO.
  *
@@ -102,7 +166,8 @@ int hscopt_hho_reset(hscopt_hho_ctx *ctx);
  * @param ctx Contexto HHO.
  * @param iters Número de iterações a executar (>= 1).
  *
- * @return 0 em sucesso, valor diferente de 0 em erro.
+ * @return 0 em sucesso, valor diferente de 0 em erro (3 = falha do
+ * avaliador assíncrono).
  */
 int hscopt_hho_iterate(hscopt_hho_ctx *ctx, unsigned iters);
 
@@ -166,6 +231,145 @@ size_t hscopt_hho_n_keys(const hscopt_hho_ctx *ctx);
  */
 unsigned hscopt_hho_max_threads(const hscopt_hho_ctx *ctx);
 
+/**
+ * @brief Retorna a diversidade da população.
+ *
+ * Raiz da distância quadrática média dos hawks ao centróide,
+ * sqrt((1/N) * sum_i ||x_i - c||^2). Calculada em O(dim) a partir das somas
+ * por dimensão mantidas incrementalmente (sem passar pela população), serve
+ * como sinal barato de convergência: tende a 0 quando os hawks colapsam.
+ *
+ * @param ctx Contexto HHO.
+ * @return Diversidade (0 se @p ctx for NULL).
+ */
+double hscopt_hho_diversity(const hscopt_hho_ctx *ctx);
+
+/**
+ * @brief Passa a avaliar a população via um decoder assíncrono.
+ *
+ * Em cada iteração, o HHO atualiza todos os hawks e envia em um único lote
+ * as avaliações das novas posições e os primeiros candidatos dos mergulhos
+ * (cerco com voo de Lévy); os segundos candidatos vão em um segundo lote,
+ * só para os mergulhos que falharam. O fitness atual de cada hawk é
+ * reaproveitado em vez de reavaliado. Uma única thread mantém até
+ * `max_in_flight` avaliações em andamento, e os resultados são aceitos em
+ * qualquer ordem.
+ *
+ * Os mergulhos são aplicados no fim da fase de atualização, então um hawk
+ * pode sortear como referência a posição anterior de um hawk em mergulho: a
+ * trajetória difere da do modo síncrono, mas continua determinística.
+ * hscopt_hho_reset() também avalia a população pelo avaliador.
+ *
+ * @param ctx Contexto HHO.
+ * @param ad Avaliador (copiado), ou NULL para voltar ao decoder síncrono.
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória.
+ *
+ * @note hscopt_hho_try_update_rabbit() continua usando o decoder síncrono
+ * (veja hscopt_async_decode()).
+ */
+int hscopt_hho_set_async(hscopt_hho_ctx *ctx, const hscopt_async_decoder *ad);
+
+/**
+ * @brief Liga a triagem dos mergulhos por um modelo substituto.
+ *
+ * Nos mergulhos (cerco com voo de Lévy), cada candidato só vai ao decoder se
+ * o modelo estimar um objetivo menor que o atual do hawk; os descartados
+ * contam como rejeitados. A população avaliada a cada iteração e os
+ * candidatos avaliados alimentam o arquivo do modelo. Vale para os modos
+ * síncrono e assíncrono.
+ *
+ * @param ctx Contexto HHO.
+ * @param s Modelo (emprestado; deve viver até ser desligado ou até o
+ * destroy), ou NULL para desligar.
+ * @return 0 em sucesso, 1 se a dimensão do modelo não for a do contexto ou
+ * em falta de memória.
+ *
+ * @note Com triagem, a trajetória depende do modelo e do seu arquivo.
+ */
+int hscopt_hho_set_surrogate(hscopt_hho_ctx *ctx, hscopt_surrogate *s);
+
+/**
+ * @brief Liga a avaliação limitada (corte) dos candidatos dos mergulhos.
+ *
+ * Um candidato de mergulho só é aceito se o seu objetivo for menor que o do
+ * hawk. Com o corte ligado, o decoder recebe `bounded = 1` e
+ * `cutoff` = objetivo do hawk em uma cópia do dctx, e pode parar cedo
+ * retornando qualquer valor >= cutoff (ver hscopt_decode_cutoff()). O mesmo
+ * vale para hscopt_hho_try_update_rabbit(), com o objetivo do rabbit. A
+ * população continua avaliada sem corte, e valores limitados nunca vão para
+ * `fitness`, para o rabbit ou para o arquivo do modelo substituto.
+ *
+ * @param ctx Contexto HHO.
+ * @param enable 1 para ligar, 0 para desligar (default).
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ *
+ * @note O corte vale para o decoder síncrono; o contrato assíncrono não o
+ * transporta. A trajetória é a mesma com ou sem corte.
+ */
+int hscopt_hho_set_cutoff(hscopt_hho_ctx *ctx, int enable);
+
+/**
+ * @brief Liga o modo por blocos, para dimensões muito altas.
+ *
+ * Sem blocos, cada movimento reescreve as dim chaves do agente. Com
+ * @p block > 0, cada agente, a cada iteração, sorteia um dos
+ * ceil(dim / block) blocos alinhados de chaves contíguas e aplica a regra
+ * do HHO só a ele; as demais chaves não mudam. A atualização custa
+ * O(block) por agente, e não O(dim):
+ *
+ * - a média da população sai das somas correntes, sem o snapshot em O(dim)
+ *   por iteração, e o recálculo periódico das somas fica dim / block vezes
+ *   mais raro;
+ * - o candidato do mergulho é escrito na própria linha do agente, que volta
+ *   ao bloco anterior se ele não melhorar.
+ *
+ * A cada avaliação depois de um movimento, o decoder recebe em
+ * `ctx->delta` (::hscopt_keys_delta) o trecho alterado, os valores
+ * anteriores e o objetivo das chaves de antes, e pode avaliar só o trecho.
+ * `delta` é NULL nas demais avaliações.
+ *
+ * @param ctx Contexto HHO.
+ * @param block Chaves por bloco (0 = movimentos completos, o default;
+ * valores >= dim equivalem a um bloco só, sem o snapshot da média).
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória.
+ *
+ * @note O modo por blocos vale para o decoder síncrono; com avaliador
+ * assíncrono (hscopt_hho_set_async()), os movimentos seguem completos. A
+ * trajetória continua independente do número de threads, mas difere da
+ * trajetória sem blocos.
+ */
+int hscopt_hho_set_block(hscopt_hho_ctx *ctx, size_t block);
+
+/**
+ * @brief Retorna o tamanho do bloco (0 = movimentos completos).
+ *
+ * @param ctx Contexto HHO.
+ * @return Chaves por bloco.
+ */
+size_t hscopt_hho_block(const hscopt_hho_ctx *ctx);
+
+/**
+ * @brief Liga o contexto a um quadro da melhor solução (board.h).
+ *
+ * Ao fim de cada iteração, na thread que chamou iterate, o rabbit é
+ * oferecido ao quadro se melhorou desde a última oferta, e a solução do
+ * quadro, se melhor que o rabbit, é reavaliada e adotada como rabbit
+ * (hscopt_hho_try_update_rabbit()). A busca nunca espera pelo quadro:
+ * uma oferta que encontra outra em andamento fica para a próxima iteração.
+ * Outras threads leem e injetam soluções pelo quadro, sem tocar no
+ * contexto. hscopt_hho_reconfigure() desliga o quadro se a dimensão mudar.
+ *
+ * @param ctx Contexto HHO.
+ * @param b Quadro (emprestado; deve viver até ser desligado ou até o
+ * destroy), ou NULL para desligar.
+ * @return 0 em sucesso, 1 se a dimensão do quadro não for a do contexto ou
+ * em falta de memória.
+ *
+ * @note Com o quadro, a trajetória depende do que as outras threads
+ * publicam e de quando: o resultado não é reprodutível.
+ */
+int hscopt_hho_set_board(hscopt_hho_ctx *ctx, hscopt_board *b);
+
 /**
  * @brief Avalia uma solução candidata e atualiza o rabbit se houver melhoria.
  *
@@ -0,0 +1,855 @@
+#ifndef HSCOPT_HHO_IMPL_H
+#define HSCOPT_HHO_IMPL_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hscopt/affinity.h"
+#include "hscopt/alloc.h"
+#include "hscopt/async.h"
+#include "hscopt/board.h"
+#include "hscopt/decoder.h"
+#include "hscopt/defs.h"
+#include "hscopt/hho.h"
+#include "hscopt/rng.h"
+#include "hscopt/surrogate.h"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file hho_impl.h
+ * @brief Núcleo do HHO em header, para instanciar com um decoder fixo.
+ *
+ * Em hscopt_hho_iterate() cada avaliação passa pelo ponteiro
+ * `hscopt_decoder_fn`, o que impede o compilador de fazer inline do decoder
+ * nos laços de atualização e avaliação. HSCOPT_DEFINE_HHO() gera, na unidade
+ * de tradução do usuário, uma iteração especializada para um decoder
+ * conhecido em tempo de compilação:
+ *
+ * @code
+ * static double tsp(const double *keys, size_t n, hscopt_decode_ctx *c);
+ * HSCOPT_DEFINE_HHO(tsp_hho, tsp)
+ *
+ * hscopt_hho_ctx *h = tsp_hho_create(dim, 30, 1000, 1, &dctx, &rng);
+ * tsp_hho_iterate(h, 1000);
+ * double f = hscopt_hho_best_fitness(h);  // demais funções: hscopt_hho_*
+ * hscopt_hho_destroy(h);
+ * @endcode
+ *
+ * O contexto é o mesmo ::hscopt_hho_ctx da biblioteca, e a sequência de
+ * sorteios também: com as mesmas flags de ponto flutuante da biblioteca
+ * (ex.: contração em FMA), o resultado é idêntico ao de hscopt_hho_iterate().
+ * Para avaliar em paralelo, a unidade do usuário deve ser compilada com
+ * OpenMP.
+ *
+ * @note As funções `hscopt_hho_impl_*` e o layout de `struct hscopt_hho_ctx`
+ * não fazem parte da API estável; use apenas a macro.
+ */
+
+/** Chaves do agente @p agent. */
+#define HSCOPT_HHO_HAWK_PTR(ctx, agent) (&(ctx)->X[(agent) * (ctx)->dim])
+/** Energia base E1 na iteração t de T. */
+#define HSCOPT_HHO_E1(t, T) (2.0 * (1.0 - ((double)(t) / (double)(T))))
+/** Energia inicial E0 a partir de um u01. */
+#define HSCOPT_HHO_E0(u01) (2.0 * (u01)-1.0)
+/** Iterações entre recálculos das somas da população. */
+#define HSCOPT_HHO_RESYNC_PERIOD 64u
+
+/** Estados de `row_state`: fitness do agente válido e já no arquivo. */
+#define HSCOPT_HHO_ROW_CLEAN 0u
+/** Linha de X mudou e ainda não foi avaliada. */
+#define HSCOPT_HHO_ROW_DIRTY 1u
+/** Avaliada nesta iteração, ainda fora do arquivo do modelo substituto. */
+#define HSCOPT_HHO_ROW_FRESH 2u
+
+/** Iteração especializada guardada no contexto. */
+typedef void (*hscopt_hho_kernel_fn)(hscopt_hho_ctx *ctx, unsigned iters);
+
+/**
+ * Avalia as linhas sujas entre os agentes [lo, hi). Cada instância do núcleo
+ * tem a sua, com o decoder constante, chamada uma vez por thread pela região
+ * paralela de hscopt_hho_impl_eval_all().
+ */
+typedef void (*hscopt_hho_rows_fn)(hscopt_hho_ctx *ctx, size_t lo,
+                                   size_t hi);
+
+struct hscopt_hho_ctx {
+  size_t dim;
+  size_t n_agents;
+  size_t cap_dim;     // capacidade dos buffers por linha (>= dim)
+  size_t cap_agents;  // capacidade dos buffers por agente (>= n_agents)
+
+  unsigned iter;
+  unsigned max_iters;
+  unsigned max_threads;
+  unsigned eff_threads;
+  int *cpus;  // CPU de cada thread [eff_threads] (NULL = sem afinidade)
+
+  hscopt_decoder_fn decoder;
+  hscopt_decode_ctx *dctx;
+  hscopt_rng *rng;
+  hscopt_hho_kernel_fn kernel;  // iteração especializada para dim
+  hscopt_ctr_rng ctr;
+
+  double *X;
+  double *fitness;
+  unsigned char *row_state;  // HSCOPT_HHO_ROW_* por agente [n_agents]
+
+  double rabbit_fitness;
+  double *rabbit_keys;
+
+  double *mean_pos;
+  double *sum;    // soma por dimensão das linhas de X
+  double *sumsq;  // soma dos quadrados por dimensão
+  double *tmp1;
+  double *tmp2;
+  double *levy;
+
+  double levy_sigma;
+
+  hscopt_async_decoder async;  // avaliador assíncrono (submit NULL = não)
+  double *async_y;             // Y1 e Y2 dos mergulhos [2 * n_agents * dim]
+  const double **async_rows;   // linhas do lote [n_agents]
+  size_t *async_idx;           // agente de cada linha do lote [n_agents]
+  double *async_fit;           // objetivos do lote [n_agents]
+
+  hscopt_surrogate *surrogate;  // triagem dos mergulhos (NULL = não)
+  unsigned char *surr_v;        // decisão da triagem por agente (async)
+
+  int cutoff;                   // avaliação limitada nos mergulhos
+  hscopt_decode_ctx dctx_cut;   // cópia do dctx com o corte
+
+  size_t block;                 // chaves por bloco (0 = movimentos completos)
+  double *blk_old;              // valores anteriores do bloco [n_agents*block]
+  hscopt_decode_ctx *blk_dctx;  // dctx com a diferença, por agente
+  hscopt_keys_delta *blk_delta; // diferença do último movimento, por agente
+
+  hscopt_board *board;          // quadro compartilhado (NULL = não)
+  double *board_keys;           // cópia lida do quadro [dim]
+  double board_pub;             // último rabbit oferecido ao quadro
+  uint64_t board_seen;          // última versão lida do quadro
+
+  hscopt_allocator alloc;
+};
+
+// Sorteios de um agente em uma iteração: fluxo por contador (iter, agente) e
+// a segunda normal de Box-Muller guardada para o próximo sorteio.
+typedef struct hscopt_hho_impl_draws {
+  hscopt_ctr_stream st;
+  int has_spare;
+  double spare;
+} hscopt_hho_impl_draws;
+
+HSCOPT_INLINE void hscopt_hho_impl_draws_init(hscopt_hho_impl_draws *d,
+                                              const hscopt_hho_ctx *ctx,
+                                              size_t agent) {
+  hscopt_ctr_stream_init(&d->st, &ctx->ctr, ctx->iter, (uint32_t)agent);
+  d->has_spare = 0;
+  d->spare = 0.0;
+}
+
+HSCOPT_INLINE double hscopt_hho_impl_u01(hscopt_hho_impl_draws *d) {
+  return hscopt_ctr_stream_next_u01(&d->st);
+}
+
+HSCOPT_INLINE double hscopt_hho_impl_randn(hscopt_hho_impl_draws *d) {
+  if (d->has_spare) {
+    d->has_spare = 0;
+    return d->spare;
+  }
+
+  double u1 = hscopt_hho_impl_u01(d);
+  if (u1 <= 0.0) {
+    u1 = 1e-12;
+  }
+
+  const double u2 = hscopt_hho_impl_u01(d);
+  const double r = sqrt(-2.0 * log(u1));
+  const double theta = 2.0 * HSCOPT_PI * u2;
+
+  d->spare = r * sin(theta);
+  d->has_spare = 1;
+  return r * cos(theta);
+}
+
+HSCOPT_INLINE void hscopt_hho_impl_levy(hscopt_hho_ctx *ctx,
+                                        hscopt_hho_impl_draws *d,
+                                        const size_t dim) {
+  const double inv_beta = 1.0 / 1.5;
+  for (size_t j = 0; j < dim; ++j) {
+    const double u = 0.01 * hscopt_hho_impl_randn(d) * ctx->levy_sigma;
+    double v = hscopt_hho_impl_randn(d);
+    const double av = fabs(v);
+    if (av < 1e-12) {
+      v = (v < 0.0 ? -1e-12 : 1e-12);
+    }
+    ctx->levy[j] = u / pow(fabs(v), inv_beta);
+  }
+}
+
+// Faixa fixa de agentes da thread atual: blocos contíguos, iguais em todas
+// as regiões paralelas, para que cada linha de X (e de fitness) seja sempre
+// tocada pela thread que a inicializou (first-touch).
+HSCOPT_INLINE void hscopt_hho_impl_agent_range(const hscopt_hho_ctx *ctx,
+                                               size_t *lo, size_t *hi) {
+#ifdef _OPENMP
+  const size_t t = (size_t)omp_get_thread_num();
+  const size_t nt = (size_t)omp_get_num_threads();
+#else
+  const size_t t = 0, nt = 1;
+#endif
+  const size_t q = ctx->n_agents / nt;
+  const size_t r = ctx->n_agents % nt;
+  *lo = t * q + (t < r ? t : r);
+  *hi = *lo + q + (t < r ? 1u : 0u);
+}
+
+// Fixa a thread na sua CPU, uma vez por região paralela; a região termina
+// com hscopt_hho_impl_unpin().
+HSCOPT_INLINE void hscopt_hho_impl_pin(const hscopt_hho_ctx *ctx) {
+#ifdef _OPENMP
+  if (ctx->cpus) {
+    hscopt_affinity_pin_current(ctx->cpus[omp_get_thread_num()]);
+  }
+#else
+  (void)ctx;
+#endif
+}
+
+HSCOPT_INLINE void hscopt_hho_impl_unpin(const hscopt_hho_ctx *ctx) {
+  if (ctx->cpus) {
+    hscopt_affinity_unpin_current();
+  }
+}
+
+// Avalia a linha suja i. No modo por blocos, se o movimento deixou a
+// diferença para a linha de base, o decoder a recebe em `delta` (só nesta
+// avaliação).
+HSCOPT_INLINE void hscopt_hho_impl_eval_row(hscopt_hho_ctx *ctx, size_t i,
+                                            const size_t dim,
+                                            hscopt_decoder_fn decode) {
+  hscopt_decode_ctx *dc = ctx->dctx;
+  if (ctx->blk_dctx && ctx->blk_dctx[i].delta) {
+    dc = &ctx->blk_dctx[i];
+  }
+  ctx->fitness[i] = decode(HSCOPT_HHO_HAWK_PTR(ctx, i), dim, dc);
+  ctx->row_state[i] = HSCOPT_HHO_ROW_FRESH;
+  if (dc != ctx->dctx) {
+    dc->delta = NULL;
+  }
+}
+
+// Corpo de um ::hscopt_hho_rows_fn.
+HSCOPT_INLINE void hscopt_hho_impl_rows_run(hscopt_hho_ctx *ctx, size_t lo,
+                                            size_t hi, const size_t dim,
+                                            hscopt_decoder_fn decode) {
+  for (size_t i = lo; i < hi; ++i) {
+    if (ctx->row_state[i] == HSCOPT_HHO_ROW_DIRTY) {
+      hscopt_hho_impl_eval_row(ctx, i, dim, decode);
+    }
+  }
+}
+
+// A região paralela só fixa a thread, chama @p rows com os seus agentes e
+// desfaz a fixação; o laço, com o decoder, fica em @p rows.
+HSCOPT_INLINE void hscopt_hho_impl_eval_all(hscopt_hho_ctx *ctx,
+                                            hscopt_hho_rows_fn rows) {
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(ctx->eff_threads)
+#endif
+  {
+    hscopt_hho_impl_pin(ctx);
+    size_t lo, hi;
+    hscopt_hho_impl_agent_range(ctx, &lo, &hi);
+    rows(ctx, lo, hi);
+    hscopt_hho_impl_unpin(ctx);
+  }
+}
+
+// Rabbit = argmin do fitness (primeiro índice em caso de empate); copia as
+// chaves uma única vez.
+HSCOPT_INLINE void hscopt_hho_impl_update_rabbit(hscopt_hho_ctx *ctx,
+                                                 const size_t dim) {
+  size_t best = ctx->n_agents;
+  double fbest = ctx->rabbit_fitness;
+  for (size_t i = 0; i < ctx->n_agents; ++i) {
+    if (ctx->fitness[i] < fbest) {
+      fbest = ctx->fitness[i];
+      best = i;
+    }
+  }
+  if (best < ctx->n_agents) {
+    ctx->rabbit_fitness = fbest;
+    memcpy(ctx->rabbit_keys, HSCOPT_HHO_HAWK_PTR(ctx, best),
+           dim * sizeof(double));
+  }
+}
+
+// Recalcula sum/sumsq a partir de X (elimina o erro acumulado pelos deltas).
+HSCOPT_INLINE void hscopt_hho_impl_stats_resync(hscopt_hho_ctx *ctx,
+                                                const size_t dim) {
+  memset(ctx->sum, 0, dim * sizeof(double));
+  memset(ctx->sumsq, 0, dim * sizeof(double));
+
+  for (size_t i = 0; i < ctx->n_agents; ++i) {
+    const double *const x = HSCOPT_HHO_HAWK_PTR(ctx, i);
+    for (size_t j = 0; j < dim; ++j) {
+      ctx->sum[j] += x[j];
+      ctx->sumsq[j] += x[j] * x[j];
+    }
+  }
+}
+
+// Snapshot da média da população a partir das somas, em O(dim).
+HSCOPT_INLINE void hscopt_hho_impl_mean_pos(hscopt_hho_ctx *ctx,
+                                            const size_t dim) {
+  const double inv = 1.0 / (double)ctx->n_agents;
+  for (size_t j = 0; j < dim; ++j) {
+    ctx->mean_pos[j] = ctx->sum[j] * inv;
+  }
+}
+
+// Escreve Xi[j] = clamp(val) e atualiza as somas com o delta.
+HSCOPT_INLINE void hscopt_hho_impl_put(hscopt_hho_ctx *ctx, double *Xi,
+                                       size_t j, double val) {
+  const double nv = HSCOPT_CLAMP_KEY(val);
+  const double ov = Xi[j];
+  ctx->sum[j] += nv - ov;
+  ctx->sumsq[j] += nv * nv - ov * ov;
+  Xi[j] = nv;
+}
+
+// Copia uma linha já clampada para Xi, atualizando as somas.
+HSCOPT_INLINE void hscopt_hho_impl_put_row(hscopt_hho_ctx *ctx, double *Xi,
+                                           const double *src,
+                                           const size_t dim) {
+  for (size_t j = 0; j < dim; ++j) {
+    const double ov = Xi[j];
+    ctx->sum[j] += src[j] - ov;
+    ctx->sumsq[j] += src[j] * src[j] - ov * ov;
+    Xi[j] = src[j];
+  }
+}
+
+// Segundo candidato do mergulho: y2 = y1 + voo de Lévy.
+HSCOPT_INLINE void hscopt_hho_impl_levy_jump(hscopt_hho_ctx *ctx,
+                                             hscopt_hho_impl_draws *d,
+                                             const double *y1, double *y2,
+                                             const size_t dim) {
+  hscopt_hho_impl_levy(ctx, d, dim);
+  for (size_t j = 0; j < dim; ++j) {
+    y2[j] = y1[j] + hscopt_hho_impl_randn(d) * ctx->levy[j];
+  }
+  HSCOPT_CLAMP_KEY_VEC(y2, dim);
+}
+
+// Acrescenta ao arquivo do modelo substituto os agentes avaliados desde a
+// última chamada; os demais já estão lá.
+HSCOPT_INLINE void hscopt_hho_impl_feed(hscopt_hho_ctx *ctx) {
+  for (size_t i = 0; i < ctx->n_agents; ++i) {
+    if (ctx->row_state[i] == HSCOPT_HHO_ROW_FRESH) {
+      hscopt_surrogate_add(ctx->surrogate, HSCOPT_HHO_HAWK_PTR(ctx, i),
+                           ctx->fitness[i]);
+      ctx->row_state[i] = HSCOPT_HHO_ROW_CLEAN;
+    }
+  }
+}
+
+// Copia o dctx do usuário (que pode mudar entre chamadas) para dctx_cut.
+HSCOPT_INLINE void hscopt_hho_impl_cut_sync(hscopt_hho_ctx *ctx) {
+  if (ctx->dctx) {
+    ctx->dctx_cut = *ctx->dctx;
+  } else {
+    memset(&ctx->dctx_cut, 0, sizeof(ctx->dctx_cut));
+  }
+  ctx->dctx_cut.bounded = 1;
+}
+
+// Contexto dos candidatos de um mergulho: com corte, só interessa saber se
+// o objetivo fica abaixo de fcur.
+HSCOPT_INLINE hscopt_decode_ctx *hscopt_hho_impl_bound(hscopt_hho_ctx *ctx,
+                                                       double fcur) {
+  if (!ctx->cutoff) {
+    return ctx->dctx;
+  }
+  ctx->dctx_cut.cutoff = fcur;
+  return &ctx->dctx_cut;
+}
+
+// Objetivo de um candidato do mergulho; com modelo substituto, INFINITY se
+// a triagem o descartar. Resultados limitados pelo corte não vão ao arquivo.
+HSCOPT_INLINE double hscopt_hho_impl_try(hscopt_hho_ctx *ctx, const double *y,
+                                         double fcur, const size_t dim,
+                                         hscopt_decoder_fn decode,
+                                         hscopt_decode_ctx *dc) {
+  hscopt_surrogate *const s = ctx->surrogate;
+  if (!s) {
+    return decode(y, dim, dc);
+  }
+  const hscopt_surrogate_verdict v = hscopt_surrogate_screen(s, y, fcur);
+  if (v == HSCOPT_SURROGATE_SKIP) {
+    return INFINITY;
+  }
+  const double f = decode(y, dim, dc);
+  const int exact = !ctx->cutoff || f < fcur;
+  hscopt_surrogate_record(s, exact ? y : NULL, f, fcur, v);
+  return f;
+}
+
+// Aceita o candidato @p y do mergulho do agente i, já avaliado em @p f. Um
+// valor abaixo do corte é exato, e a triagem já o registrou no arquivo.
+HSCOPT_INLINE void hscopt_hho_impl_accept(hscopt_hho_ctx *ctx, size_t i,
+                                          double *Xi, const double *y,
+                                          double f, const size_t dim) {
+  hscopt_hho_impl_put_row(ctx, Xi, y, dim);
+  ctx->fitness[i] = f;
+  ctx->row_state[i] =
+      (ctx->surrogate ? HSCOPT_HHO_ROW_CLEAN : HSCOPT_HHO_ROW_FRESH);
+}
+
+// Mergulho com voo de Lévy: tenta y1 e, se não melhorar Xi, y1 + Lévy. O
+// objetivo de Xi é o da iteração anterior; o decoder só o recalcula se a
+// linha não foi avaliada (ex.: falha do avaliador assíncrono).
+HSCOPT_INLINE void hscopt_hho_impl_dive(hscopt_hho_ctx *ctx, size_t i,
+                                        double *Xi, hscopt_hho_impl_draws *d,
+                                        const double *y1, double *y2,
+                                        const size_t dim,
+                                        hscopt_decoder_fn decode) {
+  if (ctx->row_state[i] == HSCOPT_HHO_ROW_DIRTY) {
+    ctx->fitness[i] = decode(Xi, dim, ctx->dctx);
+    ctx->row_state[i] = HSCOPT_HHO_ROW_FRESH;
+  }
+  const double fcur = ctx->fitness[i];
+  hscopt_decode_ctx *const dc = hscopt_hho_impl_bound(ctx, fcur);
+  const double f1 = hscopt_hho_impl_try(ctx, y1, fcur, dim, decode, dc);
+
+  if (f1 < fcur) {
+    hscopt_hho_impl_accept(ctx, i, Xi, y1, f1, dim);
+    return;
+  }
+
+  hscopt_hho_impl_levy_jump(ctx, d, y1, y2, dim);
+  const double f2 = hscopt_hho_impl_try(ctx, y2, fcur, dim, decode, dc);
+  if (f2 < fcur) {
+    hscopt_hho_impl_accept(ctx, i, Xi, y2, f2, dim);
+  }
+}
+
+// Atualiza o agente i (exploração ou cerco). As linhas de X são escritas via
+// put/put_row, então a soma da população já fica pronta para a média da
+// próxima iteração; uma linha movida fica marcada como suja. Nos mergulhos,
+// y1/y2 recebem os candidatos; com @p decode NULL, o mergulho não é
+// avaliado: y1 e y2 ficam prontos e a função retorna 1 (Xi inalterado).
+HSCOPT_INLINE int hscopt_hho_impl_update_agent(hscopt_hho_ctx *ctx, size_t i,
+                                               double e1, double *y1,
+                                               double *y2, const size_t dim,
+                                               hscopt_decoder_fn decode) {
+  double *const Xi = HSCOPT_HHO_HAWK_PTR(ctx, i);
+  hscopt_hho_impl_draws d;
+  hscopt_hho_impl_draws_init(&d, ctx, i);
+  const double e0 = HSCOPT_HHO_E0(hscopt_hho_impl_u01(&d));
+  const double e = e1 * e0;
+  const double abs_e = fabs(e);
+
+  if (abs_e >= 1.0) {
+    const double q = hscopt_hho_impl_u01(&d);
+    const size_t r_idx = hscopt_ctr_stream_random_index(&d.st, ctx->n_agents);
+    const double *const Xrand = HSCOPT_HHO_HAWK_PTR(ctx, r_idx);
+
+    if (q >= 0.5) {
+      const double r1 = hscopt_hho_impl_u01(&d);
+      const double r2 = hscopt_hho_impl_u01(&d);
+      for (size_t j = 0; j < dim; ++j) {
+        const double val = Xrand[j] - r1 * fabs(Xrand[j] - 2.0 * r2 * Xi[j]);
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    } else {
+      const double s1 = hscopt_hho_impl_u01(&d);
+      const double s = s1 * hscopt_hho_impl_u01(&d);
+      for (size_t j = 0; j < dim; ++j) {
+        const double val = (ctx->rabbit_keys[j] - ctx->mean_pos[j]) - s;
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    }
+    ctx->row_state[i] = HSCOPT_HHO_ROW_DIRTY;
+    return 0;
+  }
+
+  const double r = hscopt_hho_impl_u01(&d);
+
+  if (r >= 0.5 && abs_e >= 0.5) {
+    const double jump_strength = 2.0 * (1.0 - hscopt_hho_impl_u01(&d));
+    for (size_t j = 0; j < dim; ++j) {
+      const double val =
+          (ctx->rabbit_keys[j] - Xi[j]) -
+          e * fabs(jump_strength * ctx->rabbit_keys[j] - Xi[j]);
+      hscopt_hho_impl_put(ctx, Xi, j, val);
+    }
+    ctx->row_state[i] = HSCOPT_HHO_ROW_DIRTY;
+    return 0;
+  }
+
+  if (r >= 0.5 && abs_e < 0.5) {
+    for (size_t j = 0; j < dim; ++j) {
+      const double val =
+          ctx->rabbit_keys[j] - e * fabs(ctx->rabbit_keys[j] - Xi[j]);
+      hscopt_hho_impl_put(ctx, Xi, j, val);
+    }
+    ctx->row_state[i] = HSCOPT_HHO_ROW_DIRTY;
+    return 0;
+  }
+
+  const double jump_strength = 2.0 * (1.0 - hscopt_hho_impl_u01(&d));
+  if (abs_e >= 0.5) {
+    for (size_t j = 0; j < dim; ++j) {
+      y1[j] = ctx->rabbit_keys[j] -
+              e * fabs(jump_strength * ctx->rabbit_keys[j] - Xi[j]);
+    }
+  } else {
+    for (size_t j = 0; j < dim; ++j) {
+      y1[j] = ctx->rabbit_keys[j] -
+              e * fabs(jump_strength * ctx->rabbit_keys[j] - ctx->mean_pos[j]);
+    }
+  }
+  HSCOPT_CLAMP_KEY_VEC(y1, dim);
+
+  if (!decode) {
+    // Os sorteios de Lévy vêm depois de todos os outros do agente: gerar y2
+    // antes de saber f1 não muda a sequência.
+    hscopt_hho_impl_levy_jump(ctx, &d, y1, y2, dim);
+    return 1;
+  }
+  hscopt_hho_impl_dive(ctx, i, Xi, &d, y1, y2, dim, decode);
+  return 0;
+}
+
+// Contexto da avaliação da linha i depois de um movimento no bloco
+// [lo, hi): cópia do dctx do usuário com a diferença para a linha de base,
+// cujo objetivo exato é fitness[i] e cujo bloco está em blk_old.
+HSCOPT_INLINE hscopt_decode_ctx *hscopt_hho_impl_block_ctx(hscopt_hho_ctx *ctx,
+                                                           size_t i, size_t lo,
+                                                           size_t hi) {
+  hscopt_keys_delta *const dl = &ctx->blk_delta[i];
+  dl->lo = lo;
+  dl->hi = hi;
+  dl->old = &ctx->blk_old[i * ctx->block];
+  dl->base_fitness = ctx->fitness[i];
+
+  hscopt_decode_ctx *const dc = &ctx->blk_dctx[i];
+  if (ctx->dctx) {
+    *dc = *ctx->dctx;
+  } else {
+    memset(dc, 0, sizeof(*dc));
+  }
+  dc->delta = dl;
+  return dc;
+}
+
+// Aceita o candidato do mergulho, já escrito em Xi[lo, hi): atualiza as
+// somas com a diferença para o bloco anterior @p old.
+HSCOPT_INLINE void hscopt_hho_impl_block_accept(hscopt_hho_ctx *ctx, size_t i,
+                                                const double *Xi,
+                                                const double *old, size_t lo,
+                                                size_t hi, double f) {
+  for (size_t j = lo; j < hi; ++j) {
+    const double nv = Xi[j];
+    const double ov = old[j - lo];
+    ctx->sum[j] += nv - ov;
+    ctx->sumsq[j] += nv * nv - ov * ov;
+  }
+  ctx->fitness[i] = f;
+  ctx->row_state[i] =
+      (ctx->surrogate ? HSCOPT_HHO_ROW_CLEAN : HSCOPT_HHO_ROW_FRESH);
+}
+
+// Atualização do agente i no modo por blocos (hscopt_hho_set_block()): as
+// regras de hscopt_hho_impl_update_agent(), só nas chaves de um dos
+// ceil(dim / block) blocos alinhados, sorteado do fluxo do agente. A média
+// da população sai das somas correntes, sem o snapshot em O(dim). O bloco
+// anterior fica em blk_old, e a próxima avaliação da linha recebe a
+// diferença; os mergulhos escrevem o candidato na própria linha e a
+// restauram se ele não melhorar. Custo O(block), fora o decoder.
+HSCOPT_INLINE void hscopt_hho_impl_update_block(hscopt_hho_ctx *ctx, size_t i,
+                                                double e1, const size_t dim,
+                                                hscopt_decoder_fn decode) {
+  double *const Xi = HSCOPT_HHO_HAWK_PTR(ctx, i);
+  const double *const rk = ctx->rabbit_keys;
+  const double inv = 1.0 / (double)ctx->n_agents;
+  hscopt_hho_impl_draws d;
+  hscopt_hho_impl_draws_init(&d, ctx, i);
+
+  const size_t bs = (ctx->block < dim ? ctx->block : dim);
+  const size_t lo =
+      hscopt_ctr_stream_random_index(&d.st, (dim + bs - 1u) / bs) * bs;
+  const size_t hi = (dim - lo > bs ? lo + bs : dim);
+  double *const old = &ctx->blk_old[i * ctx->block];
+  memcpy(old, Xi + lo, (hi - lo) * sizeof(double));
+  // A diferença só serve ao decoder se a linha de base tiver objetivo.
+  const int has_base = (ctx->row_state[i] != HSCOPT_HHO_ROW_DIRTY);
+
+  const double e0 = HSCOPT_HHO_E0(hscopt_hho_impl_u01(&d));
+  const double e = e1 * e0;
+  const double abs_e = fabs(e);
+
+  if (abs_e >= 1.0) {
+    const double q = hscopt_hho_impl_u01(&d);
+    const size_t r_idx = hscopt_ctr_stream_random_index(&d.st, ctx->n_agents);
+    const double *const Xrand = HSCOPT_HHO_HAWK_PTR(ctx, r_idx);
+
+    if (q >= 0.5) {
+      const double r1 = hscopt_hho_impl_u01(&d);
+      const double r2 = hscopt_hho_impl_u01(&d);
+      for (size_t j = lo; j < hi; ++j) {
+        const double val = Xrand[j] - r1 * fabs(Xrand[j] - 2.0 * r2 * Xi[j]);
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    } else {
+      const double s1 = hscopt_hho_impl_u01(&d);
+      const double s = s1 * hscopt_hho_impl_u01(&d);
+      for (size_t j = lo; j < hi; ++j) {
+        const double val = (rk[j] - ctx->sum[j] * inv) - s;
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    }
+  } else {
+    const double r = hscopt_hho_impl_u01(&d);
+
+    if (r < 0.5) {
+      // Mergulho: y1 e depois y1 + Lévy, escritos em Xi[lo, hi).
+      const double jump_strength = 2.0 * (1.0 - hscopt_hho_impl_u01(&d));
+      if (!has_base) {
+        ctx->fitness[i] = decode(Xi, dim, ctx->dctx);
+        ctx->row_state[i] = HSCOPT_HHO_ROW_FRESH;
+      }
+      const double fcur = ctx->fitness[i];
+      for (size_t j = lo; j < hi; ++j) {
+        const double ref = (abs_e >= 0.5 ? old[j - lo] : ctx->sum[j] * inv);
+        const double val = rk[j] - e * fabs(jump_strength * rk[j] - ref);
+        Xi[j] = HSCOPT_CLAMP_KEY(val);
+      }
+
+      hscopt_decode_ctx *const dc = hscopt_hho_impl_block_ctx(ctx, i, lo, hi);
+      if (ctx->cutoff) {
+        dc->bounded = 1;
+        dc->cutoff = fcur;
+      }
+      const double f1 = hscopt_hho_impl_try(ctx, Xi, fcur, dim, decode, dc);
+      if (f1 < fcur) {
+        hscopt_hho_impl_block_accept(ctx, i, Xi, old, lo, hi, f1);
+      } else {
+        hscopt_hho_impl_levy(ctx, &d, hi - lo);
+        for (size_t j = lo; j < hi; ++j) {
+          const double val =
+              Xi[j] + hscopt_hho_impl_randn(&d) * ctx->levy[j - lo];
+          Xi[j] = HSCOPT_CLAMP_KEY(val);
+        }
+        const double f2 = hscopt_hho_impl_try(ctx, Xi, fcur, dim, decode, dc);
+        if (f2 < fcur) {
+          hscopt_hho_impl_block_accept(ctx, i, Xi, old, lo, hi, f2);
+        } else {
+          memcpy(Xi + lo, old, (hi - lo) * sizeof(double));
+        }
+      }
+      dc->delta = NULL;
+      return;
+    }
+
+    if (abs_e >= 0.5) {
+      const double jump_strength = 2.0 * (1.0 - hscopt_hho_impl_u01(&d));
+      for (size_t j = lo; j < hi; ++j) {
+        const double val =
+            (rk[j] - Xi[j]) - e * fabs(jump_strength * rk[j] - Xi[j]);
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    } else {
+      for (size_t j = lo; j < hi; ++j) {
+        const double val = rk[j] - e * fabs(rk[j] - Xi[j]);
+        hscopt_hho_impl_put(ctx, Xi, j, val);
+      }
+    }
+  }
+
+  if (has_base) {
+    hscopt_hho_impl_block_ctx(ctx, i, lo, hi);
+  }
+  ctx->row_state[i] = HSCOPT_HHO_ROW_DIRTY;
+}
+
+// Troca com o quadro, no fim da iteração: oferece o rabbit se ele melhorou
+// desde a última oferta e adota o do quadro se for melhor. Uma oferta que
+// encontrou outra em andamento é refeita na próxima iteração.
+HSCOPT_INLINE void hscopt_hho_impl_board_sync(hscopt_hho_ctx *ctx) {
+  hscopt_board *const b = ctx->board;
+  if (ctx->rabbit_fitness < ctx->board_pub &&
+      hscopt_board_offer(b, ctx->rabbit_keys, ctx->rabbit_fitness) >= 0) {
+    ctx->board_pub = ctx->rabbit_fitness;
+  }
+  if (hscopt_board_version(b) != ctx->board_seen &&
+      hscopt_board_fitness(b) < ctx->rabbit_fitness) {
+    hscopt_board_read(b, ctx->board_keys, NULL, &ctx->board_seen);
+    if (hscopt_hho_try_update_rabbit(ctx, ctx->board_keys) == 1) {
+      ctx->board_pub = ctx->rabbit_fitness;  // já está no quadro
+    }
+  }
+}
+
+/**
+ * @brief Valida uma chamada de iterate.
+ *
+ * @return 0 se pode iterar, 1 em argumentos inválidos, 2 se ultrapassar
+ * max_iters (mesmos códigos de hscopt_hho_iterate()).
+ */
+HSCOPT_INLINE int hscopt_hho_impl_begin(const hscopt_hho_ctx *ctx,
+                                        unsigned iters) {
+  if (!ctx || iters == 0) {
+    return 1;
+  }
+  if (ctx->iter >= ctx->max_iters || ctx->iter + iters > ctx->max_iters) {
+    return 2;
+  }
+  return 0;
+}
+
+// Corpo de uma chamada de iterate. Com @p dim e @p decode constantes, o
+// compilador desenrola e vetoriza os laços internos, troca os memcpy por
+// cópias fixas e faz inline do decoder. Com várias threads, a avaliação vai
+// para @p rows, que deve ser instanciada com o mesmo @p decode.
+HSCOPT_INLINE void hscopt_hho_impl_iterate(hscopt_hho_ctx *ctx,
+                                           unsigned iters, const size_t dim,
+                                           hscopt_decoder_fn decode,
+                                           hscopt_hho_rows_fn rows) {
+  // Com uma thread, cada agente é avaliado logo após a atualização, com a
+  // linha ainda no cache; com várias, as avaliações vão para a região
+  // paralela no fim da iteração. Só vão ao decoder as linhas sujas: hawks
+  // cujo mergulho falhou não mudaram, e os aceitos já têm o objetivo.
+  const int inline_eval = (ctx->eff_threads == 1u);
+  if (ctx->cutoff) {
+    hscopt_hho_impl_cut_sync(ctx);
+  }
+  // No modo por blocos cada linha muda só em um bloco por iteração: o
+  // recálculo das somas, em O(n_agents * dim), fica mais raro na mesma
+  // proporção.
+  unsigned resync = HSCOPT_HHO_RESYNC_PERIOD;
+  if (ctx->block && ctx->block < dim) {
+    const size_t nb = dim / ctx->block;
+    resync = (nb > UINT32_MAX / resync ? UINT32_MAX : resync * (unsigned)nb);
+  }
+
+  for (unsigned it = 0; it < iters; ++it) {
+#ifdef HSCOPT_HHO_DEBUG_PASSES
+    // Passadas completas redundantes, só para depuração.
+    for (size_t i = 0; i < ctx->n_agents; ++i) {
+      HSCOPT_CLAMP_KEY_VEC(HSCOPT_HHO_HAWK_PTR(ctx, i), dim);
+    }
+    hscopt_hho_impl_stats_resync(ctx, dim);
+#else
+    if (ctx->iter % resync == 0) {
+      hscopt_hho_impl_stats_resync(ctx, dim);
+    }
+#endif
+
+    const double e1 = HSCOPT_HHO_E1(ctx->iter, ctx->max_iters);
+    if (!ctx->block) {
+      hscopt_hho_impl_mean_pos(ctx, dim);
+    }
+
+    for (size_t i = 0; i < ctx->n_agents; ++i) {
+      if (ctx->block) {
+        hscopt_hho_impl_update_block(ctx, i, e1, dim, decode);
+      } else {
+        hscopt_hho_impl_update_agent(ctx, i, e1, ctx->tmp1, ctx->tmp2, dim,
+                                     decode);
+      }
+      if (inline_eval && ctx->row_state[i] == HSCOPT_HHO_ROW_DIRTY) {
+        hscopt_hho_impl_eval_row(ctx, i, dim, decode);
+      }
+    }
+
+    if (!inline_eval) {
+      hscopt_hho_impl_eval_all(ctx, rows);
+    }
+    if (ctx->surrogate) {
+      hscopt_hho_impl_feed(ctx);
+    }
+    hscopt_hho_impl_update_rabbit(ctx, dim);
+    if (ctx->board) {
+      hscopt_hho_impl_board_sync(ctx);
+    }
+    ++ctx->iter;
+  }
+}
+
+// Caso do switch de HSCOPT_DEFINE_HHO: usa ctx, iters, decode e rows do
+// escopo.
+#define HSCOPT_HHO_IMPL_DIM_CASE(D)                                  \
+  case D:                                                            \
+    hscopt_hho_impl_iterate(ctx, iters, (size_t)(D), decode, rows); \
+    break;
+
+/**
+ * @brief Gera um HHO especializado para o decoder @p fn.
+ *
+ * Define, com ligação `static`:
+ * - `prefix_create(dim, n_agents, max_iters, max_threads, dctx, rng)`;
+ * - `prefix_create_with_allocator(..., rng, alloc)`;
+ * - `prefix_iterate(ctx, iters)`, com os mesmos códigos de retorno de
+ *   hscopt_hho_iterate() e 1 se @p ctx foi criado com outro decoder.
+ *
+ * As demais operações (reset, destroy, best, ...) são as `hscopt_hho_*`. Para
+ * as dimensões de ::HSCOPT_FOR_EACH_FIXED_DIM, dim também vira constante. A
+ * avaliação paralela também é gerada aqui (`prefix_rows`, chamada de dentro
+ * da região paralela), com o decoder expandido inline.
+ * Com um avaliador assíncrono configurado, `prefix_iterate` delega a
+ * hscopt_hho_iterate().
+ *
+ * @param prefix Prefixo dos nomes gerados.
+ * @param fn Decoder (`hscopt_decoder_fn`), visível nesta unidade.
+ */
+#define HSCOPT_DEFINE_HHO(prefix, fn)                                        \
+  HSCOPT_UNUSED static hscopt_hho_ctx *prefix##_create_with_allocator(       \
+      size_t dim, size_t n_agents, unsigned max_iters, unsigned max_threads, \
+      hscopt_decode_ctx *dctx, hscopt_rng *rng,                              \
+      const hscopt_allocator *alloc) {                                       \
+    return hscopt_hho_create_with_allocator(dim, n_agents, max_iters,        \
+                                            max_threads, (fn), dctx, rng,    \
+                                            alloc);                          \
+  }                                                                          \
+  HSCOPT_UNUSED static hscopt_hho_ctx *prefix##_create(                      \
+      size_t dim, size_t n_agents, unsigned max_iters, unsigned max_threads, \
+      hscopt_decode_ctx *dctx, hscopt_rng *rng) {                            \
+    return prefix##_create_with_allocator(dim, n_agents, max_iters,          \
+                                          max_threads, dctx, rng, NULL);     \
+  }                                                                          \
+  static void prefix##_rows(hscopt_hho_ctx *ctx, size_t lo, size_t hi) {     \
+    hscopt_hho_impl_rows_run(ctx, lo, hi, ctx->dim, (fn));                   \
+  }                                                                          \
+  HSCOPT_UNUSED static int prefix##_iterate(hscopt_hho_ctx *ctx,             \
+                                            unsigned iters) {                \
+    const hscopt_decoder_fn decode = (fn);                                   \
+    const hscopt_hho_rows_fn rows = prefix##_rows;                           \
+    const int rc = hscopt_hho_impl_begin(ctx, iters);                        \
+    if (rc != 0) return rc;                                                  \
+    if (ctx->decoder != decode) return 1;                                    \
+    if (ctx->async.submit) return hscopt_hho_iterate(ctx, iters);            \
+    switch (ctx->dim) {                                                      \
+      HSCOPT_FOR_EACH_FIXED_DIM(HSCOPT_HHO_IMPL_DIM_CASE)                    \
+      default:                                                               \
+        hscopt_hho_impl_iterate(ctx, iters, ctx->dim, decode, rows);         \
+        break;                                                               \
+    }                                                                        \
+    return 0;                                                                \
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_HHO_IMPL_H */
@@ -11,12 +11,26 @@ extern "C" {
  * Autor: Heric da Silva Cruz
  */
 
+#include "affinity.h"
 #include "alloc.h"
+#include "async.h"
+#include "batch.h"
+#include "board.h"
 #include "decoder.h"
 #include "defs.h"
 #include "hho.h"
+#include "hybrid.h"
+#include "instance.h"
+#include "keys.h"
+#include "mmap_alloc.h"
+#include "pool.h"
+#include "portfolio.h"
+#include "proc_pool.h"
 #include "rng.h"
 #include "rvns.h"
+#include "rvns_chains.h"
+#include "solver.h"
+#include "surrogate.h"
 
 #define HSCOPT_VERSION_MAJOR 0
 #define HSCOPT_VERSION_MINOR 1
@@ -0,0 +1,167 @@
+#ifndef HSCOPT_HYBRID_H
+#define HSCOPT_HYBRID_H
+
+#include <stddef.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/decoder.h"
+#include "hscopt/hho.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file hybrid.h
+ * @brief Híbrido memético HHO + RVNS com busca local concorrente.
+ *
+ * O HHO itera normalmente enquanto um RVNS roda em uma thread dedicada,
+ * intensificando em torno do rabbit atual. Soluções melhores encontradas pelo
+ * RVNS voltam ao HHO via hscopt_hho_try_update_rabbit() e, sempre que o rabbit
+ * muda, o RVNS é reiniciado a partir dele via hscopt_rvns_reset().
+ */
+
+/**
+ * @brief Contexto opaco do híbrido HHO + RVNS.
+ */
+typedef struct hscopt_hybrid_ctx hscopt_hybrid_ctx;
+
+/**
+ * @struct hscopt_hybrid_stats
+ * @brief Contadores de interação entre HHO e RVNS.
+ */
+typedef struct hscopt_hybrid_stats {
+  unsigned long long rvns_iters;  // iterações de RVNS executadas
+  unsigned reseeds;               // reinícios do RVNS a partir do rabbit
+  unsigned injections;            // soluções do RVNS aceitas pelo HHO
+} hscopt_hybrid_stats;
+
+/**
+ * @brief Cria e inicializa o híbrido.
+ *
+ * O orçamento de threads é compartilhado: com @p max_threads >= 2, o HHO usa
+ * `max_threads - 1` threads e o RVNS uma thread dedicada. Com
+ * @p max_threads == 1 (ou sem suporte a threads), o RVNS é intercalado com o
+ * HHO, uma iteração de cada por vez.
+ *
+ * @param dim Número de chaves (dimensão do problema).
+ * @param n_agents Número de agentes (hawks).
+ * @param max_iters Número máximo de iterações do HHO.
+ * @param k_max Maior vizinhança do RVNS (>= 1).
+ * @param rvns_iters Iterações do RVNS por reinício (orçamento de cada
+ * intensificação).
+ * @param max_threads Orçamento total de threads.
+ * @param decoder Função decoder (deve ser thread-safe se max_threads >= 2).
+ * @param dctx Contexto do decoder (pode ser NULL).
+ * @param rng Gerador de números aleatórios (obrigatório).
+ *
+ * @return Ponteiro para o contexto em caso de sucesso, ou NULL em erro.
+ */
+hscopt_hybrid_ctx *hscopt_hybrid_create(size_t dim, size_t n_agents,
+                                        unsigned max_iters, size_t k_max,
+                                        unsigned rvns_iters,
+                                        unsigned max_threads,
+                                        hscopt_decoder_fn decoder,
+                                        hscopt_decode_ctx *dctx,
+                                        hscopt_rng *rng);
+
+/**
+ * @brief Cria o híbrido com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Ponteiro para o contexto em caso de sucesso, ou NULL em erro.
+ */
+hscopt_hybrid_ctx *hscopt_hybrid_create_with_allocator(
+    size_t dim, size_t n_agents, unsigned max_iters, size_t k_max,
+    unsigned rvns_iters, unsigned max_threads, hscopt_decoder_fn decoder,
+    hscopt_decode_ctx *dctx, hscopt_rng *rng, const hscopt_allocator *alloc);
+
+/**
+ * @brief Libera todos os recursos do híbrido (inclusive HHO e RVNS).
+ *
+ * @param ctx Contexto do híbrido.
+ */
+void hscopt_hybrid_destroy(hscopt_hybrid_ctx *ctx);
+
+/**
+ * @brief Reinicializa HHO e RVNS e zera os contadores.
+ *
+ * @param ctx Contexto do híbrido.
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_hybrid_reset(hscopt_hybrid_ctx *ctx);
+
+/**
+ * @brief Executa @p iters iterações do HHO com o RVNS em paralelo.
+ *
+ * A thread do RVNS é criada na primeira chamada e vive até
+ * hscopt_hybrid_destroy(). Entre as chamadas ela fica parada (o decoder só
+ * é chamado dentro de iterate), e o RVNS continua de onde estava: ele só é
+ * reiniciado quando o rabbit melhora. Chamar iterate com poucas iterações
+ * por vez não descarta o progresso do RVNS. Uma solução do RVNS ainda
+ * pendente ao final é oferecida ao HHO antes do retorno.
+ *
+ * @param ctx Contexto do híbrido.
+ * @param iters Número de iterações do HHO (>= 1).
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se exceder max_iters,
+ * 3 se a thread do RVNS não puder ser criada, ou o código de
+ * hscopt_hho_iterate() se ele falhar (ex.: avaliador assíncrono).
+ *
+ * @note Com thread dedicada, o resultado depende do escalonamento e não é
+ * reprodutível bit a bit.
+ */
+int hscopt_hybrid_iterate(hscopt_hybrid_ctx *ctx, unsigned iters);
+
+/**
+ * @brief Retorna o melhor fitness (rabbit do HHO).
+ *
+ * @param ctx Contexto do híbrido.
+ * @return Melhor fitness encontrado até o momento.
+ */
+double hscopt_hybrid_best_fitness(const hscopt_hybrid_ctx *ctx);
+
+/**
+ * @brief Retorna as chaves da melhor solução (rabbit do HHO).
+ *
+ * @param ctx Contexto do híbrido.
+ * @return Ponteiro válido até a próxima chamada que altere o contexto.
+ */
+const double *hscopt_hybrid_best_keys(const hscopt_hybrid_ctx *ctx);
+
+/**
+ * @brief Retorna os contadores de interação.
+ *
+ * @param ctx Contexto do híbrido.
+ * @param out Saída.
+ */
+void hscopt_hybrid_get_stats(const hscopt_hybrid_ctx *ctx,
+                             hscopt_hybrid_stats *out);
+
+/**
+ * @brief Acesso ao contexto HHO interno (ex.: para consultas).
+ *
+ * @param ctx Contexto do híbrido.
+ * @return Contexto HHO (pertence ao híbrido; não destruir).
+ */
+hscopt_hho_ctx *hscopt_hybrid_hho(hscopt_hybrid_ctx *ctx);
+
+/**
+ * @brief Acesso ao contexto RVNS interno (ex.: para configurá-lo).
+ *
+ * @param ctx Contexto do híbrido.
+ * @return Contexto RVNS (pertence ao híbrido; não destruir).
+ *
+ * @note Não usar durante hscopt_hybrid_iterate(); entre as chamadas, a
+ * thread do RVNS está parada.
+ */
+hscopt_rvns_ctx *hscopt_hybrid_rvns(hscopt_hybrid_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_HYBRID_H */
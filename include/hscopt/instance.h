@@ -0,0 +1,216 @@
+#ifndef HSCOPT_INSTANCE_H
+#define HSCOPT_INSTANCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file instance.h
+ * @brief Contêiner binário versionado de instâncias, carregado via mmap.
+ *
+ * Um arquivo de instância guarda seções nomeadas e tipadas (vetores, matrizes
+ * densas e grafos CSR), cada uma alinhada a 64 bytes. O loader mapeia o
+ * arquivo somente leitura e expõe as seções sem cópia; vários processos
+ * compartilham a mesma cópia no page cache.
+ *
+ * O ::hscopt_instance retornado por hscopt_instance_open() pode ser usado
+ * diretamente em `hscopt_decode_ctx::inst`.
+ *
+ * Layout (versão 1, little-endian):
+ * - cabeçalho de 64 bytes (magic, versão, número de seções, offset da
+ *   tabela, tamanho do arquivo);
+ * - dados das seções, cada bloco alinhado a 64 bytes;
+ * - tabela de seções no fim do arquivo.
+ */
+
+/** Versão do formato gravada pelo writer. */
+#define HSCOPT_INSTANCE_VERSION 1u
+
+/** Tamanho máximo do nome de uma seção (incluindo o terminador). */
+#define HSCOPT_INSTANCE_NAME_MAX 48u
+
+/**
+ * @enum hscopt_section_kind
+ * @brief Tipo de seção.
+ */
+typedef enum hscopt_section_kind {
+  HSCOPT_SECTION_VECTOR = 1,  // n elementos
+  HSCOPT_SECTION_DENSE = 2,   // rows x cols, por linha
+  HSCOPT_SECTION_CSR = 3      // grafo/matriz esparsa em CSR
+} hscopt_section_kind;
+
+/**
+ * @enum hscopt_elem_type
+ * @brief Tipo dos elementos de uma seção.
+ */
+typedef enum hscopt_elem_type {
+  HSCOPT_ELEM_NONE = 0,  // sem valores (CSR só com estrutura)
+  HSCOPT_ELEM_F64 = 1,
+  HSCOPT_ELEM_F32 = 2,
+  HSCOPT_ELEM_I64 = 3,
+  HSCOPT_ELEM_I32 = 4,
+  HSCOPT_ELEM_U64 = 5,
+  HSCOPT_ELEM_U32 = 6,
+  HSCOPT_ELEM_U8 = 7
+} hscopt_elem_type;
+
+/**
+ * @struct hscopt_section
+ * @brief Visão (sem cópia) de uma seção do arquivo mapeado.
+ *
+ * Os ponteiros são válidos até hscopt_instance_close().
+ */
+typedef struct hscopt_section {
+  const char *name;
+  hscopt_section_kind kind;
+  hscopt_elem_type elem;
+  size_t rows;               // vetor: n; densa/CSR: linhas
+  size_t cols;               // vetor: 1; densa/CSR: colunas
+  size_t nnz;                // CSR: não zeros (0 nos demais)
+  const void *data;          // elementos (CSR: valores, ou NULL)
+  const uint64_t *row_ptr;   // CSR: [rows + 1] (NULL nos demais)
+  const uint32_t *col_idx;   // CSR: [nnz] (NULL nos demais)
+} hscopt_section;
+
+/**
+ * @brief Writer opaco de arquivos de instância.
+ */
+typedef struct hscopt_instance_writer hscopt_instance_writer;
+
+/**
+ * @brief Tamanho em bytes de um elemento.
+ *
+ * @param elem Tipo do elemento.
+ * @return Tamanho em bytes (0 para ::HSCOPT_ELEM_NONE ou tipo inválido).
+ */
+size_t hscopt_elem_size(hscopt_elem_type elem);
+
+/**
+ * @brief Cria (ou sobrescreve) um arquivo de instância.
+ *
+ * @param path Caminho do arquivo.
+ * @return Ponteiro para o writer, ou NULL em erro.
+ */
+hscopt_instance_writer *hscopt_instance_writer_open(const char *path);
+
+/**
+ * @brief Grava uma seção vetor.
+ *
+ * @param w Writer.
+ * @param name Nome único (< ::HSCOPT_INSTANCE_NAME_MAX caracteres).
+ * @param elem Tipo dos elementos (diferente de ::HSCOPT_ELEM_NONE).
+ * @param data Elementos.
+ * @param n Número de elementos.
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 em erro de E/S.
+ */
+int hscopt_instance_write_vector(hscopt_instance_writer *w, const char *name,
+                                 hscopt_elem_type elem, const void *data,
+                                 size_t n);
+
+/**
+ * @brief Grava uma matriz densa (por linha).
+ *
+ * @param w Writer.
+ * @param name Nome único.
+ * @param elem Tipo dos elementos (diferente de ::HSCOPT_ELEM_NONE).
+ * @param data Elementos [rows * cols].
+ * @param rows Linhas.
+ * @param cols Colunas.
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 em erro de E/S.
+ */
+int hscopt_instance_write_dense(hscopt_instance_writer *w, const char *name,
+                                hscopt_elem_type elem, const void *data,
+                                size_t rows, size_t cols);
+
+/**
+ * @brief Grava um grafo/matriz esparsa em CSR.
+ *
+ * @param w Writer.
+ * @param name Nome único.
+ * @param elem Tipo dos valores (::HSCOPT_ELEM_NONE = só estrutura).
+ * @param row_ptr Início de cada linha [rows + 1], com row_ptr[0] == 0 e
+ * não decrescente.
+ * @param col_idx Coluna de cada não zero [row_ptr[rows]], cada uma < cols.
+ * @param values Valores [row_ptr[rows]] (ignorado se elem == NONE).
+ * @param rows Linhas.
+ * @param cols Colunas.
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 em erro de E/S.
+ */
+int hscopt_instance_write_csr(hscopt_instance_writer *w, const char *name,
+                              hscopt_elem_type elem, const uint64_t *row_ptr,
+                              const uint32_t *col_idx, const void *values,
+                              size_t rows, size_t cols);
+
+/**
+ * @brief Grava a tabela de seções e o cabeçalho e fecha o arquivo.
+ *
+ * O writer é liberado mesmo em caso de erro.
+ *
+ * @param w Writer.
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_instance_writer_close(hscopt_instance_writer *w);
+
+/**
+ * @brief Mapeia um arquivo de instância somente leitura.
+ *
+ * Valida magic, versão, endianness e limites de todas as seções. Nas
+ * seções CSR, valida também a estrutura: row_ptr começa em 0, não decresce
+ * e termina em nnz, e toda coluna é < cols (uma leitura de row_ptr e
+ * col_idx inteiros na abertura).
+ *
+ * @param path Caminho do arquivo.
+ * @return Instância, ou NULL em erro.
+ */
+hscopt_instance *hscopt_instance_open(const char *path);
+
+/**
+ * @brief Desfaz o mapeamento e libera a instância.
+ *
+ * @param inst Instância.
+ */
+void hscopt_instance_close(hscopt_instance *inst);
+
+/**
+ * @brief Número de seções.
+ *
+ * @param inst Instância.
+ * @return Número de seções (0 se @p inst for NULL).
+ */
+size_t hscopt_instance_n_sections(const hscopt_instance *inst);
+
+/**
+ * @brief Obtém a i-ésima seção.
+ *
+ * @param inst Instância.
+ * @param i Índice (< hscopt_instance_n_sections()).
+ * @param out Saída.
+ * @return 0 em sucesso, 1 se o índice for inválido.
+ */
+int hscopt_instance_section(const hscopt_instance *inst, size_t i,
+                            hscopt_section *out);
+
+/**
+ * @brief Procura uma seção pelo nome.
+ *
+ * @param inst Instância.
+ * @param name Nome.
+ * @param out Saída.
+ * @return 0 em sucesso, 1 se não existir.
+ *
+ * @note Busca linear na tabela; resolva as seções uma vez fora do hot loop.
+ */
+int hscopt_instance_find(const hscopt_instance *inst, const char *name,
+                         hscopt_section *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_INSTANCE_H */
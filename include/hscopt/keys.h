@@ -0,0 +1,240 @@
+#ifndef HSCOPT_KEYS_H
+#define HSCOPT_KEYS_H
+
+#include <stddef.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file keys.h
+ * @brief Utilitários de decodificação de random keys.
+ *
+ * Funções para transformar um vetor de chaves em permutação (argsort),
+ * seleção parcial (top-k) e argsort por segmentos. Todas operam sobre um
+ * ::hscopt_workspace pré-alocado e não realizam alocações.
+ *
+ * A ordem produzida é sempre a ordem estável por (chave, índice): chaves
+ * iguais mantêm a ordem crescente de índice.
+ */
+
+/**
+ * @brief Cria um workspace para vetores de até @p capacity chaves.
+ *
+ * @param capacity Maior número de chaves a ser ordenado (>= 1).
+ * @return Ponteiro para o workspace em caso de sucesso, ou NULL em erro.
+ *
+ * @note Um workspace não deve ser usado por duas threads ao mesmo tempo.
+ * Em decoders chamados em paralelo, use um workspace por thread.
+ */
+hscopt_workspace *hscopt_workspace_create(size_t capacity);
+
+/**
+ * @brief Cria um workspace com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param capacity Maior número de chaves a ser ordenado (>= 1).
+ * @param alloc Alocador customizado (opcional).
+ * @return Ponteiro para o workspace em caso de sucesso, ou NULL em erro.
+ */
+hscopt_workspace *hscopt_workspace_create_with_allocator(
+    size_t capacity, const hscopt_allocator *alloc);
+
+/**
+ * @brief Libera o workspace.
+ *
+ * @param ws Workspace (pode ser NULL).
+ */
+void hscopt_workspace_destroy(hscopt_workspace *ws);
+
+/**
+ * @brief Retorna a capacidade (número máximo de chaves) do workspace.
+ *
+ * @param ws Workspace.
+ * @return Capacidade, ou 0 se @p ws for NULL.
+ */
+size_t hscopt_workspace_capacity(const hscopt_workspace *ws);
+
+/**
+ * @brief Calcula a permutação que ordena as chaves em ordem crescente.
+ *
+ * Usa radix sort LSD sobre o padrão de bits IEEE-754 das chaves (8 passadas
+ * de 8 bits, com histogramas calculados em uma única leitura e passadas
+ * triviais descartadas). Vetores pequenos usam ordenação por inserção.
+ *
+ * Ao final, @p perm[r] contém o índice da r-ésima menor chave.
+ *
+ * @param keys Vetor de chaves (tamanho @p n).
+ * @param n Número de chaves.
+ * @param perm Saída (tamanho @p n).
+ * @param ws Workspace com capacidade >= @p n.
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se a capacidade do
+ * workspace for insuficiente.
+ *
+ * @note Qualquer double finito é aceito; a ordem segue o valor numérico.
+ */
+int hscopt_keys_argsort(const double *keys, size_t n, size_t *perm,
+                        hscopt_workspace *ws);
+
+/**
+ * @brief Argsort parcial: os @p k índices das menores chaves, ordenados.
+ *
+ * Equivale às primeiras @p k posições de hscopt_keys_argsort(), mas custa
+ * O(n + k log k) em vez de ordenar o vetor inteiro.
+ *
+ * @param keys Vetor de chaves (tamanho @p n).
+ * @param n Número de chaves.
+ * @param k Número de posições desejadas (se k > n, usa n).
+ * @param perm Saída (tamanho >= min(k, n)).
+ * @param ws Workspace com capacidade >= @p n.
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se a capacidade do
+ * workspace for insuficiente.
+ */
+int hscopt_keys_partial_argsort(const double *keys, size_t n, size_t k,
+                                size_t *perm, hscopt_workspace *ws);
+
+/**
+ * @brief Seleção top-k: os índices das @p k menores chaves, sem ordenação.
+ *
+ * O conjunto retornado é o mesmo de hscopt_keys_partial_argsort(), mas os
+ * índices são escritos em ordem crescente de índice (não de chave). Custo
+ * esperado O(n).
+ *
+ * @param keys Vetor de chaves (tamanho @p n).
+ * @param n Número de chaves.
+ * @param k Número de índices desejados (se k > n, usa n).
+ * @param out Saída (tamanho >= min(k, n)).
+ * @param ws Workspace com capacidade >= @p n.
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se a capacidade do
+ * workspace for insuficiente.
+ */
+int hscopt_keys_select_topk(const double *keys, size_t n, size_t k,
+                            size_t *out, hscopt_workspace *ws);
+
+/**
+ * @brief Argsort independente por segmento (cromossomos multi-segmento).
+ *
+ * O segmento g ocupa as posições [offsets[g], offsets[g+1]) de @p keys e é
+ * ordenado isoladamente. Os índices escritos em @p perm são locais ao
+ * segmento (0 .. tamanho do segmento - 1), nas mesmas posições do segmento.
+ *
+ * @param keys Vetor de chaves (tamanho offsets[n_groups]).
+ * @param offsets Limites dos segmentos (tamanho @p n_groups + 1, crescente,
+ * com offsets[0] == 0).
+ * @param n_groups Número de segmentos.
+ * @param perm Saída (tamanho offsets[n_groups]).
+ * @param ws Workspace com capacidade >= maior segmento.
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se a capacidade do
+ * workspace for insuficiente.
+ */
+int hscopt_keys_argsort_grouped(const double *keys, const size_t *offsets,
+                                size_t n_groups, size_t *perm,
+                                hscopt_workspace *ws);
+
+/**
+ * @brief Cria uma permutação incremental para vetores de @p n chaves.
+ *
+ * A estrutura mantém a ordem estável por (chave, índice) em uma árvore de
+ * estatística de ordem (treap implícita sobre os índices), de forma que
+ * alterar uma chave custa O(log n) esperado em vez de reordenar o vetor.
+ *
+ * @param n Número de chaves (>= 1).
+ * @return Ponteiro para a permutação em caso de sucesso, ou NULL em erro.
+ */
+hscopt_keys_perm *hscopt_keys_perm_create(size_t n);
+
+/**
+ * @brief Cria uma permutação incremental com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param n Número de chaves (>= 1).
+ * @param alloc Alocador customizado (opcional).
+ * @return Ponteiro para a permutação em caso de sucesso, ou NULL em erro.
+ */
+hscopt_keys_perm *hscopt_keys_perm_create_with_allocator(
+    size_t n, const hscopt_allocator *alloc);
+
+/**
+ * @brief Libera a permutação incremental.
+ *
+ * @param p Permutação (pode ser NULL).
+ */
+void hscopt_keys_perm_destroy(hscopt_keys_perm *p);
+
+/**
+ * @brief Retorna o número de chaves da permutação.
+ *
+ * @param p Permutação.
+ * @return Número de chaves, ou 0 se @p p for NULL.
+ */
+size_t hscopt_keys_perm_size(const hscopt_keys_perm *p);
+
+/**
+ * @brief Reconstrói a permutação a partir de um vetor completo de chaves.
+ *
+ * Custo O(n): argsort radix seguido de construção linear da árvore.
+ *
+ * @param p Permutação.
+ * @param keys Vetor de chaves (tamanho hscopt_keys_perm_size(p)).
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_keys_perm_build(hscopt_keys_perm *p, const double *keys);
+
+/**
+ * @brief Atualiza a chave do índice @p j.
+ *
+ * @param p Permutação.
+ * @param j Índice alterado (< hscopt_keys_perm_size(p)).
+ * @param key Novo valor da chave.
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_keys_perm_update(hscopt_keys_perm *p, size_t j, double key);
+
+/**
+ * @brief Retorna o índice que ocupa a posição @p r na ordem.
+ *
+ * Equivale a perm[r] de hscopt_keys_argsort(). Custo O(log n) esperado.
+ *
+ * @param p Permutação.
+ * @param r Posição (< hscopt_keys_perm_size(p)).
+ * @return Índice na posição @p r, ou SIZE_MAX em erro.
+ */
+size_t hscopt_keys_perm_select(const hscopt_keys_perm *p, size_t r);
+
+/**
+ * @brief Retorna a posição do índice @p j na ordem.
+ *
+ * Inverso de hscopt_keys_perm_select(). Custo O(log n) esperado.
+ *
+ * @param p Permutação.
+ * @param j Índice (< hscopt_keys_perm_size(p)).
+ * @return Posição de @p j, ou SIZE_MAX em erro.
+ */
+size_t hscopt_keys_perm_rank(const hscopt_keys_perm *p, size_t j);
+
+/**
+ * @brief Materializa a permutação completa em @p perm.
+ *
+ * Custo O(n), sem ordenação.
+ *
+ * @param p Permutação.
+ * @param perm Saída (tamanho hscopt_keys_perm_size(p)).
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_keys_perm_to_array(const hscopt_keys_perm *p, size_t *perm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_KEYS_H */
@@ -0,0 +1,132 @@
+#ifndef HSCOPT_MMAP_ALLOC_H
+#define HSCOPT_MMAP_ALLOC_H
+
+#include <stddef.h>
+
+#include "hscopt/alloc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file mmap_alloc.h
+ * @brief Backend de alocador baseado em mmap, com huge pages e arquivos.
+ *
+ * Buffers grandes (ex.: a população `X` do HHO) são servidos por `mmap`
+ * próprio em vez de `malloc`, o que permite:
+ * - huge pages explícitas (`MAP_HUGETLB`) ou transparentes
+ *   (`madvise(MADV_HUGEPAGE)`), reduzindo a pressão no TLB;
+ * - mapeamentos de arquivo (`MAP_SHARED`), para que populações enormes fiquem
+ *   no page cache e sobrevivam ao reinício do processo.
+ *
+ * Cada falha cai para a opção seguinte: hugetlb → THP → páginas normais.
+ * Buffers menores que `min_size` continuam no heap.
+ *
+ * Uso:
+ * @code
+ * hscopt_mmap_opts o;
+ * hscopt_mmap_opts_default(&o);
+ * o.huge_pages = 1;
+ * hscopt_mmap_allocator *m = hscopt_mmap_allocator_create(&o);
+ * hscopt_allocator a;
+ * hscopt_mmap_allocator_get(m, &a);
+ * hscopt_hho_ctx *h = hscopt_hho_create_with_allocator(..., &a);
+ * ...
+ * hscopt_hho_destroy(h);
+ * hscopt_mmap_allocator_destroy(m);  // depois de liberar todos os buffers
+ * @endcode
+ */
+
+/**
+ * @brief Estado opaco do backend (opções e contadores).
+ */
+typedef struct hscopt_mmap_allocator hscopt_mmap_allocator;
+
+/**
+ * @struct hscopt_mmap_opts
+ * @brief Opções do backend mmap.
+ */
+typedef struct hscopt_mmap_opts {
+  size_t min_size;          // menor buffer servido por mmap (bytes)
+  int huge_pages;           // tenta MAP_HUGETLB e depois MADV_HUGEPAGE
+  const char *file_prefix;  // NULL = anônimo; senão "<prefix>.<n>"
+  int keep_files;           // mantém (e reaproveita) os arquivos no free
+} hscopt_mmap_opts;
+
+/**
+ * @struct hscopt_mmap_stats
+ * @brief Bytes atualmente mapeados por tipo de página.
+ */
+typedef struct hscopt_mmap_stats {
+  size_t hugetlb;  // huge pages explícitas
+  size_t thp;      // páginas normais com MADV_HUGEPAGE
+  size_t pages;    // páginas normais
+  size_t file;     // mapeamentos de arquivo
+  size_t heap;     // buffers pequenos (malloc)
+} hscopt_mmap_stats;
+
+/**
+ * @brief Preenche as opções default.
+ *
+ * Default: `min_size` = 2 MiB, sem huge pages, anônimo.
+ *
+ * @param out Saída.
+ */
+void hscopt_mmap_opts_default(hscopt_mmap_opts *out);
+
+/**
+ * @brief Cria o backend.
+ *
+ * No modo arquivo, a n-ésima alocação grande usa o arquivo
+ * `<file_prefix>.<n>`. Sem `keep_files`, o arquivo é sempre criado: um
+ * `<file_prefix>.<n>` que já existe é pulado (a alocação usa o próximo n).
+ * Com `keep_files`, um arquivo existente com o tamanho certo é
+ * reaproveitado: um processo que repete a mesma sequência de alocações
+ * encontra o conteúdo anterior (exceto nos buffers zerados via `calloc`).
+ *
+ * Um prefixo pertence a um único backend por vez. Com `keep_files`, dois
+ * backends vivos com o mesmo prefixo (no mesmo processo ou não) mapeiam os
+ * mesmos arquivos e os buffers de um sobrescrevem os do outro.
+ *
+ * @param opts Opções (NULL = default).
+ * @return Ponteiro para o backend, ou NULL em erro.
+ */
+hscopt_mmap_allocator *hscopt_mmap_allocator_create(
+    const hscopt_mmap_opts *opts);
+
+/**
+ * @brief Libera o backend.
+ *
+ * @param m Backend.
+ *
+ * @note Todos os buffers devem ter sido liberados antes.
+ */
+void hscopt_mmap_allocator_destroy(hscopt_mmap_allocator *m);
+
+/**
+ * @brief Preenche um ::hscopt_allocator que usa o backend.
+ *
+ * O alocador resultante é thread-safe e pode ser passado às funções
+ * `*_with_allocator` ou a hscopt_set_allocator().
+ *
+ * @param m Backend.
+ * @param out Saída.
+ */
+void hscopt_mmap_allocator_get(hscopt_mmap_allocator *m,
+                               hscopt_allocator *out);
+
+/**
+ * @brief Retorna os bytes mapeados por tipo de página.
+ *
+ * @param m Backend.
+ * @param out Saída.
+ */
+void hscopt_mmap_allocator_stats(const hscopt_mmap_allocator *m,
+                                 hscopt_mmap_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_MMAP_ALLOC_H */
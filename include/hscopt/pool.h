@@ -0,0 +1,136 @@
+#ifndef HSCOPT_POOL_H
+#define HSCOPT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/solver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file pool.h
+ * @brief Pool de solvers para servir muitos jobs pequenos em sequência.
+ *
+ * Criar e destruir um contexto por job realoca todos os buffers a cada vez.
+ * O pool guarda os solvers devolvidos e os entrega de novo, reconfigurados
+ * para o próximo job via `reconfigure` da vtable (hscopt_hho_reconfigure(),
+ * hscopt_rvns_reconfigure()): os buffers só crescem quando o job é maior que
+ * os anteriores. Os solvers ociosos ficam em pilha, e o último devolvido é o
+ * primeiro entregue (o mais provável de ainda estar no cache).
+ *
+ * @code
+ * hscopt_solver_pool *pool = hscopt_solver_pool_create(&hscopt_hho_solver, 8);
+ *
+ * // em cada thread trabalhadora, por job:
+ * void *s = hscopt_solver_pool_acquire(pool, &job_cfg);
+ * hscopt_hho_solver.iterate(s, job_cfg.max_iters);
+ * ... hscopt_hho_solver.best_fitness(s) ...
+ * hscopt_solver_pool_release(pool, s);
+ *
+ * hscopt_solver_pool_destroy(pool);
+ * @endcode
+ *
+ * acquire() e release() são thread-safe. Cada job precisa do seu próprio
+ * `cfg.rng`, e todos devem usar o mesmo `cfg.max_threads`.
+ */
+
+/**
+ * @brief Pool opaco de solvers.
+ */
+typedef struct hscopt_solver_pool hscopt_solver_pool;
+
+/**
+ * @struct hscopt_solver_pool_stats
+ * @brief Contadores do pool desde a criação.
+ */
+typedef struct hscopt_solver_pool_stats {
+  uint64_t acquires;  // chamadas bem-sucedidas de acquire
+  uint64_t reuses;    // solvers ociosos reconfigurados
+  uint64_t creates;   // solvers criados (pool vazio ou reconfigure falhou)
+  uint64_t drops;     // solvers destruídos por falta de espaço ou por erro
+} hscopt_solver_pool_stats;
+
+/**
+ * @brief Cria um pool.
+ *
+ * @param vt Vtable dos solvers; precisa de `reconfigure`.
+ * @param capacity Máximo de solvers ociosos guardados (>= 1).
+ * @return Pool, ou NULL em erro.
+ */
+hscopt_solver_pool *hscopt_solver_pool_create(const hscopt_solver_vtable *vt,
+                                              size_t capacity);
+
+/**
+ * @brief Cria um pool com alocador customizado (só para o pool; os solvers
+ * usam `cfg.alloc`).
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Pool, ou NULL em erro.
+ */
+hscopt_solver_pool *hscopt_solver_pool_create_with_allocator(
+    const hscopt_solver_vtable *vt, size_t capacity,
+    const hscopt_allocator *alloc);
+
+/**
+ * @brief Destrói os solvers ociosos e libera o pool.
+ *
+ * Solvers ainda emprestados devem ser destruídos pelo usuário
+ * (`vt->destroy`).
+ *
+ * @param pool Pool.
+ */
+void hscopt_solver_pool_destroy(hscopt_solver_pool *pool);
+
+/**
+ * @brief Entrega um solver configurado para @p cfg.
+ *
+ * Reconfigura um solver ocioso ou, se não houver (ou se a reconfiguração
+ * falhar), cria um novo com `vt->create`. O estado é o de um solver recém
+ * criado com @p cfg.
+ *
+ * @param pool Pool.
+ * @param cfg Configuração do job.
+ * @return Solver, ou NULL em erro.
+ */
+void *hscopt_solver_pool_acquire(hscopt_solver_pool *pool,
+                                 const hscopt_solver_config *cfg);
+
+/**
+ * @brief Devolve um solver ao pool.
+ *
+ * Se o pool já tiver `capacity` solvers ociosos, o solver é destruído.
+ *
+ * @param pool Pool.
+ * @param solver Solver obtido de hscopt_solver_pool_acquire() (NULL é
+ * ignorado).
+ */
+void hscopt_solver_pool_release(hscopt_solver_pool *pool, void *solver);
+
+/**
+ * @brief Número de solvers ociosos.
+ *
+ * @param pool Pool.
+ * @return Solvers ociosos.
+ */
+size_t hscopt_solver_pool_idle(hscopt_solver_pool *pool);
+
+/**
+ * @brief Copia os contadores do pool.
+ *
+ * @param pool Pool.
+ * @param out Saída.
+ */
+void hscopt_solver_pool_get_stats(hscopt_solver_pool *pool,
+                                  hscopt_solver_pool_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_POOL_H */
@@ -0,0 +1,98 @@
+#ifndef HSCOPT_PORTFOLIO_H
+#define HSCOPT_PORTFOLIO_H
+
+#include <stddef.h>
+
+#include "hscopt/solver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file portfolio.h
+ * @brief Portfólio paralelo de solvers com corrida e eliminação antecipada.
+ *
+ * Várias configurações (algoritmo + parâmetros) rodam ao mesmo tempo, cada
+ * uma com uma fração do orçamento de threads. A execução é dividida em
+ * rodadas no estilo *successive halving*: ao final de cada rodada as
+ * configurações dominadas (pelo seu próprio melhor fitness) são encerradas,
+ * o melhor global é compartilhado com as sobreviventes e elas recebem
+ * rodadas mais longas.
+ *
+ * Nunca rodam mais que `max_threads` threads: com mais configurações que
+ * threads, cada uma usa uma thread e a rodada anda em ondas de
+ * `max_threads` configurações.
+ */
+
+/**
+ * @struct hscopt_portfolio_entry
+ * @brief Uma configuração do portfólio.
+ *
+ * `cfg.max_threads` é ignorado: o runner define a fatia de cada entrada.
+ * Cada entrada precisa do seu próprio `cfg.rng`.
+ */
+typedef struct hscopt_portfolio_entry {
+  const hscopt_solver_vtable *vt;
+  hscopt_solver_config cfg;
+} hscopt_portfolio_entry;
+
+/**
+ * @struct hscopt_portfolio_opts
+ * @brief Opções do portfólio.
+ */
+typedef struct hscopt_portfolio_opts {
+  unsigned max_threads;  // orçamento total de threads
+  unsigned round_iters;  // iterações da primeira rodada (>= 1)
+  double keep_fraction;  // fração mantida por rodada, em (0, 1]
+  int share_incumbent;   // injeta o melhor global nos sobreviventes
+} hscopt_portfolio_opts;
+
+/**
+ * @struct hscopt_portfolio_result
+ * @brief Resultado do portfólio.
+ */
+typedef struct hscopt_portfolio_result {
+  double best_fitness;  // melhor fitness global
+  size_t winner;        // entrada que encontrou o melhor
+  unsigned rounds;      // rodadas executadas
+} hscopt_portfolio_result;
+
+/**
+ * @brief Preenche as opções default.
+ *
+ * Default: 1 thread, 10 iterações na primeira rodada, mantém metade das
+ * configurações por rodada e compartilha o incumbente.
+ *
+ * @param out Saída.
+ */
+void hscopt_portfolio_opts_default(hscopt_portfolio_opts *out);
+
+/**
+ * @brief Executa o portfólio até esgotar as iterações das sobreviventes.
+ *
+ * @param entries Configurações (todas com a mesma dimensão).
+ * @param n Número de configurações (>= 1).
+ * @param opts Opções (NULL = default).
+ * @param best_keys Saída com as chaves do melhor global (tamanho dim).
+ * @param out Resultado (pode ser NULL).
+ *
+ * Um solver cujo `iterate` retorna erro é encerrado ao fim da rodada; o seu
+ * melhor fitness até ali ainda conta para o melhor global.
+ *
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se algum solver não
+ * puder ser criado, 3 se uma thread não puder ser criada, 4 se o `iterate`
+ * de todos os solvers ainda ativos falhar (@p best_keys e @p out trazem o
+ * melhor encontrado até ali).
+ *
+ * @note O decoder de cada entrada é chamado concorrentemente com os demais.
+ */
+int hscopt_portfolio_run(const hscopt_portfolio_entry *entries, size_t n,
+                         const hscopt_portfolio_opts *opts, double *best_keys,
+                         hscopt_portfolio_result *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_PORTFOLIO_H */
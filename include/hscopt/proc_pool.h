@@ -0,0 +1,104 @@
+#ifndef HSCOPT_PROC_POOL_H
+#define HSCOPT_PROC_POOL_H
+
+#include <stddef.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/async.h"
+#include "hscopt/decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file proc_pool.h
+ * @brief Pool de processos para decoders que não são thread-safe.
+ *
+ * O caminho paralelo por threads exige decoders thread-safe (ver decoder.h).
+ * O pool cria N processos via `fork`, que herdam a instância e o contexto do
+ * decoder, e troca chaves e objetivos por memória compartilhada:
+ * - um slot por avaliação pendente, com as chaves e o objetivo;
+ * - um anel de pedidos e um anel de respostas (filas lock-free limitadas);
+ * - campainhas por futex: quem espera dorme no futex, e quem publica só faz
+ *   a syscall de wake quando há alguém esperando.
+ *
+ * Cada processo roda o decoder em uma única thread. O pool implementa o
+ * contrato de async.h, então entra no lugar do caminho paralelo via
+ * hscopt_hho_set_async() e hscopt_rvns_set_async():
+ *
+ * @code
+ * hscopt_proc_pool *pool = hscopt_proc_pool_create(dim, 8, 0, dec, &dctx);
+ * hscopt_async_decoder ad;
+ * hscopt_proc_pool_get(pool, &ad);
+ * hscopt_hho_ctx *h = hscopt_hho_create(dim, 64, 500, 1, dec, &dctx, &rng);
+ * hscopt_hho_set_async(h, &ad);
+ * hscopt_hho_reset(h);
+ * hscopt_hho_iterate(h, 500);
+ * hscopt_hho_destroy(h);
+ * hscopt_proc_pool_destroy(pool);
+ * @endcode
+ *
+ * Disponível apenas no Linux; nas demais plataformas
+ * hscopt_proc_pool_create() retorna NULL.
+ */
+
+/**
+ * @brief Pool opaco de processos avaliadores.
+ */
+typedef struct hscopt_proc_pool hscopt_proc_pool;
+
+/**
+ * @brief Cria o pool e os processos.
+ *
+ * @param n_keys Número de chaves de cada avaliação.
+ * @param n_procs Número de processos (0 = 1).
+ * @param capacity Avaliações pendentes (0 = 64 por processo); arredondado
+ * para potência de 2.
+ * @param decoder Decoder executado nos processos.
+ * @param dctx Contexto do decoder (herdado pelo fork).
+ * @return Pool, ou NULL em erro ou plataforma sem suporte.
+ *
+ * @note Crie o pool antes de iniciar regiões paralelas: o filho herda apenas
+ * a thread que chamou `fork`.
+ */
+hscopt_proc_pool *hscopt_proc_pool_create(size_t n_keys, unsigned n_procs,
+                                          size_t capacity,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx);
+
+/**
+ * @brief Cria o pool com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global. O alocador serve a estrutura
+ * do pool no processo que o cria; a região compartilhada com os processos
+ * continua vindo de `mmap`.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Pool, ou NULL em erro ou plataforma sem suporte.
+ */
+hscopt_proc_pool *hscopt_proc_pool_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t capacity,
+    hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+    const hscopt_allocator *alloc);
+
+/**
+ * @brief Encerra os processos e libera o pool.
+ *
+ * @param pool Pool.
+ */
+void hscopt_proc_pool_destroy(hscopt_proc_pool *pool);
+
+/**
+ * @brief Preenche um ::hscopt_async_decoder que usa o pool.
+ *
+ * @param pool Pool.
+ * @param out Saída.
+ */
+void hscopt_proc_pool_get(hscopt_proc_pool *pool, hscopt_async_decoder *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_PROC_POOL_H */
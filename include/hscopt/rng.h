@@ -111,6 +111,179 @@ HSCOPT_INLINE size_t hscopt_rng_random_index(hscopt_rng *rng, size_t n) {
   return (size_t)(m >> 64);
 }
 
+/**
+ * @struct hscopt_ctr_rng
+ * @brief Gerador baseado em contador (Philox4x32-10).
+ *
+ * Diferente do xoshiro, não há estado sequencial: cada número é uma função
+ * pura de (chave, contador). O contador é formado por (iteração, agente,
+ * índice do sorteio), de forma que o valor sorteado por um agente em uma
+ * iteração não depende da ordem de execução nem do número de threads.
+ */
+typedef struct hscopt_ctr_rng {
+  uint32_t key[2];
+} hscopt_ctr_rng;
+
+/**
+ * @struct hscopt_ctr_stream
+ * @brief Sequência de sorteios de um par (iteração, agente).
+ *
+ * Conveniência para consumir os sorteios 0, 1, 2, ... de um mesmo par
+ * (iteração, agente) sem recalcular metade de cada bloco Philox.
+ */
+typedef struct hscopt_ctr_stream {
+  uint32_t key[2];
+  uint32_t ctr[4];  // [bloco, agente, iteração (lo), iteração (hi)]
+  uint64_t spare;   // segunda metade do último bloco
+  int has_spare;
+} hscopt_ctr_stream;
+
+/**
+ * @brief Inicializa a chave do gerador a partir de uma semente.
+ *
+ * @param g Gerador.
+ * @param seed Valor da semente.
+ */
+void hscopt_ctr_rng_seed(hscopt_ctr_rng *g, uint64_t seed);
+
+/**
+ * @brief Uma aplicação de Philox4x32-10 (10 rodadas) sobre @p ctr.
+ *
+ * @param ctr Contador de 128 bits (entrada) e resultado (saída).
+ * @param key Chave de 64 bits.
+ */
+HSCOPT_INLINE void hscopt_philox4x32_10(uint32_t ctr[4],
+                                        const uint32_t key[2]) {
+  uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  uint32_t k0 = key[0], k1 = key[1];
+
+  for (int r = 0; r < 10; ++r) {
+    const uint64_t p0 = (uint64_t)UINT32_C(0xD2511F53) * c0;
+    const uint64_t p1 = (uint64_t)UINT32_C(0xCD9E8D57) * c2;
+    const uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    const uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c1 = (uint32_t)p1;
+    c3 = (uint32_t)p0;
+    c0 = n0;
+    c2 = n2;
+    k0 += UINT32_C(0x9E3779B9);
+    k1 += UINT32_C(0xBB67AE85);
+  }
+
+  ctr[0] = c0;
+  ctr[1] = c1;
+  ctr[2] = c2;
+  ctr[3] = c3;
+}
+
+/**
+ * @brief Sorteio de 64 bits com acesso aleatório por (iteração, agente,
+ * sorteio).
+ *
+ * @param g Gerador.
+ * @param iter Iteração (ou qualquer identificador de 64 bits).
+ * @param agent Agente/candidato.
+ * @param draw Índice do sorteio dentro de (iter, agent), < 2^33.
+ * @return Valor pseudoaleatório no intervalo [0, 2^64 − 1].
+ */
+HSCOPT_INLINE uint64_t hscopt_ctr_rng_u64(const hscopt_ctr_rng *g,
+                                          uint64_t iter, uint32_t agent,
+                                          uint64_t draw) {
+  uint32_t c[4] = {(uint32_t)(draw >> 1), agent, (uint32_t)iter,
+                   (uint32_t)(iter >> 32)};
+  hscopt_philox4x32_10(c, g->key);
+  return (draw & 1u) ? ((uint64_t)c[3] << 32 | c[2])
+                     : ((uint64_t)c[1] << 32 | c[0]);
+}
+
+/**
+ * @brief Sorteio uniforme em [0,1) com acesso aleatório.
+ *
+ * @see hscopt_ctr_rng_u64
+ */
+HSCOPT_INLINE double hscopt_ctr_rng_u01(const hscopt_ctr_rng *g,
+                                        uint64_t iter, uint32_t agent,
+                                        uint64_t draw) {
+  return (hscopt_ctr_rng_u64(g, iter, agent, draw) >> 11) *
+         (1.0 / 9007199254740992.0); /* 2^53 */
+}
+
+/**
+ * @brief Preenche @p out com os sorteios [draw0, draw0 + n) de (iter, agent)
+ * em [0,1).
+ *
+ * Os blocos Philox são independentes entre si, então o laço é vetorizável.
+ *
+ * @param g Gerador.
+ * @param iter Iteração.
+ * @param agent Agente/candidato.
+ * @param draw0 Primeiro sorteio (par).
+ * @param out Saída (tamanho @p n).
+ * @param n Número de valores.
+ */
+void hscopt_ctr_rng_fill_u01(const hscopt_ctr_rng *g, uint64_t iter,
+                             uint32_t agent, uint64_t draw0, double *out,
+                             size_t n);
+
+/**
+ * @brief Inicia a sequência de sorteios de (iter, agent) a partir do sorteio 0.
+ *
+ * @param s Sequência.
+ * @param g Gerador.
+ * @param iter Iteração.
+ * @param agent Agente/candidato.
+ */
+HSCOPT_INLINE void hscopt_ctr_stream_init(hscopt_ctr_stream *s,
+                                          const hscopt_ctr_rng *g,
+                                          uint64_t iter, uint32_t agent) {
+  s->key[0] = g->key[0];
+  s->key[1] = g->key[1];
+  s->ctr[0] = 0;
+  s->ctr[1] = agent;
+  s->ctr[2] = (uint32_t)iter;
+  s->ctr[3] = (uint32_t)(iter >> 32);
+  s->spare = 0;
+  s->has_spare = 0;
+}
+
+/**
+ * @brief Próximo sorteio de 64 bits da sequência.
+ *
+ * Produz os mesmos valores de hscopt_ctr_rng_u64() para draw = 0, 1, 2, ...
+ */
+HSCOPT_INLINE uint64_t hscopt_ctr_stream_next_u64(hscopt_ctr_stream *s) {
+  if (s->has_spare) {
+    s->has_spare = 0;
+    return s->spare;
+  }
+  uint32_t c[4] = {s->ctr[0]++, s->ctr[1], s->ctr[2], s->ctr[3]};
+  hscopt_philox4x32_10(c, s->key);
+  s->spare = (uint64_t)c[3] << 32 | c[2];
+  s->has_spare = 1;
+  return (uint64_t)c[1] << 32 | c[0];
+}
+
+/**
+ * @brief Próximo sorteio da sequência em [0,1).
+ */
+HSCOPT_INLINE double hscopt_ctr_stream_next_u01(hscopt_ctr_stream *s) {
+  return (hscopt_ctr_stream_next_u64(s) >> 11) *
+         (1.0 / 9007199254740992.0); /* 2^53 */
+}
+
+/**
+ * @brief Próximo índice da sequência em [0, n).
+ *
+ * Usa multiplicação em 128 bits sem rejeição (viés de no máximo n / 2^64),
+ * para que cada índice consuma exatamente um sorteio.
+ */
+HSCOPT_INLINE size_t hscopt_ctr_stream_random_index(hscopt_ctr_stream *s,
+                                                    size_t n) {
+  const __uint128_t m =
+      (__uint128_t)hscopt_ctr_stream_next_u64(s) * (__uint128_t)n;
+  return (size_t)(m >> 64);
+}
+
 #ifdef __cplusplus
 }
 #endif
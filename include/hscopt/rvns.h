@@ -2,10 +2,15 @@
 #define HSCOPT_RVNS_H
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include "hscopt/affinity.h"
 #include "hscopt/alloc.h"
+#include "hscopt/async.h"
+#include "hscopt/board.h"
 #include "hscopt/decoder.h"
 #include "hscopt/rng.h"
+#include "hscopt/surrogate.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +35,24 @@ extern "C" {
  */
 typedef struct hscopt_rvns_ctx hscopt_rvns_ctx;
 
+/**
+ * @brief Regra de escolha da vizinhança (hscopt_rvns_set_policy()).
+ */
+typedef enum hscopt_rvns_policy {
+  HSCOPT_RVNS_LADDER = 0,  // k = 1, 2, ..., k_max; volta a 1 ao melhorar
+  HSCOPT_RVNS_UCB = 1,     // bandit UCB1-Tuned sobre a taxa de melhoria
+} hscopt_rvns_policy;
+
+/**
+ * @struct hscopt_rvns_nbhd_stats
+ * @brief Contadores de uma vizinhança desde o último reset.
+ */
+typedef struct hscopt_rvns_nbhd_stats {
+  uint64_t steps;         // vezes em que a vizinhança foi explorada
+  uint64_t evals;         // candidatos avaliados (sem os da triagem)
+  uint64_t improvements;  // passos que melhoraram a incumbente
+} hscopt_rvns_nbhd_stats;
+
 /**
  * @brief Cria e inicializa um contexto do RVNS.
  *
@@ -45,12 +68,16 @@ typedef struct hscopt_rvns_ctx hscopt_rvns_ctx;
  * @param k_max Maior vizinhança a ser reconhecida (>= 1).
  * @param max_iters Número máximo de iterações configurado para o contexto.
  * @param max_threads Número máximo de threads para avaliação (se OpenMP estiver
- * ativo).
+ * ativo). Também define o número default de candidatos por vizinhança.
  * @param decoder Função decoder responsável por avaliar uma solução.
  * @param dctx Contexto do decoder (pode ser NULL).
  * @param rng Gerador de números aleatórios (obrigatório).
  *
  * @return Ponteiro para o contexto RVNS em caso de sucesso, ou NULL em erro.
+ *
+ * @note O *shaking* usa um RNG por contador (::hscopt_ctr_rng) indexado por
+ * (avaliação de vizinhança, candidato). Com o mesmo @p rng e o mesmo número de
+ * candidatos, o resultado é idêntico para qualquer número de threads.
  */
 hscopt_rvns_ctx *hscopt_rvns_create(const double *x0, size_t dim, size_t k_max,
                                     unsigned max_iters, unsigned max_threads,
@@ -70,6 +97,33 @@ hscopt_rvns_ctx *hscopt_rvns_create_with_allocator(
     unsigned max_threads, hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
     hscopt_rng *rng, const hscopt_allocator *alloc);
 
+/**
+ * @brief Cria o RVNS com alocador customizado e política de afinidade.
+ *
+ * Os candidatos são distribuídos em blocos fixos por thread; cada thread
+ * inicializa (first-touch) os buffers dos seus candidatos e a sua
+ * permutação (hscopt_rvns_set_track_perm()). Com
+ * @p affinity != ::HSCOPT_AFFINITY_NONE, as threads de avaliação (inclusive
+ * a chamadora, como thread 0) são fixadas nas CPUs dadas por
+ * hscopt_affinity_plan().
+ *
+ * A fixação vale só dentro das regiões paralelas do contexto: ao fim de cada
+ * uma, as threads voltam à máscara que tinham. Contextos que rodam ao mesmo
+ * tempo (ex.: portfólio, híbrido) com a mesma política fixam as suas threads
+ * nas mesmas CPUs; use afinidade em um só deles.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @param affinity Política de afinidade.
+ * @return Ponteiro para o contexto RVNS em caso de sucesso, ou NULL em erro.
+ *
+ * @note A afinidade só tem efeito com OpenMP; em plataformas sem suporte o
+ * contexto é criado sem afinidade.
+ */
+hscopt_rvns_ctx *hscopt_rvns_create_with_affinity(
+    const double *x0, size_t dim, size_t k_max, unsigned max_iters,
+    unsigned max_threads, hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+    hscopt_rng *rng, const hscopt_allocator *alloc, hscopt_affinity affinity);
+
 /**
  * @brief Libera todos os recursos associados ao contexto RVNS.
  *
@@ -95,6 +149,31 @@ void hscopt_rvns_destroy(hscopt_rvns_ctx *ctx);
  */
 int hscopt_rvns_reset(hscopt_rvns_ctx *ctx, const double *x0);
 
+/**
+ * @brief Reaproveita o contexto para outro problema.
+ *
+ * Troca dimensão, k_max, limite de iterações e decoder e reinicializa a
+ * incumbente no lugar (como hscopt_rvns_reset()). Os buffers só são
+ * realocados se @p dim ou @p k_max passarem da maior configuração já usada
+ * pelo contexto; threads, afinidade, alocador, RNG, número de candidatos,
+ * corte, rastreamento da permutação e avaliador assíncrono são mantidos. O
+ * modelo substituto é desligado se a sua dimensão não for @p dim.
+ *
+ * @param ctx Contexto RVNS.
+ * @param x0 Solução inicial (vetor de tamanho @p dim) ou NULL.
+ * @param dim Número de chaves.
+ * @param k_max Maior vizinhança (>= 1).
+ * @param max_iters Número máximo de iterações.
+ * @param decoder Decoder.
+ * @param dctx Contexto do decoder (pode ser NULL).
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória (o
+ * contexto fica como estava), 2 se a avaliação assíncrona de x0 falhar.
+ */
+int hscopt_rvns_reconfigure(hscopt_rvns_ctx *ctx, const double *x0,
+                            size_t dim, size_t k_max, unsigned max_iters,
+                            hscopt_decoder_fn decoder,
+                            hscopt_decode_ctx *dctx);
+
 /**
  * @brief Executa um número de iterações do RVNS.
  *
@@ -106,10 +185,14 @@ int hscopt_rvns_reset(hscopt_rvns_ctx *ctx, const double *x0);
  *   - se melhora, aceita e reinicia k,
  *   - senão incrementa k (até k_max).
  *
+ * Com ::HSCOPT_RVNS_UCB (hscopt_rvns_set_policy()), cada iteração explora
+ * k_max vizinhanças escolhidas pelo bandit.
+ *
  * @param ctx Contexto RVNS.
  * @param iters Número de iterações a executar (>= 1).
  *
- * @return 0 em sucesso, valor diferente de 0 em erro.
+ * @return 0 em sucesso, valor diferente de 0 em erro (3 = falha do
+ * avaliador assíncrono).
  */
 int hscopt_rvns_iterate(hscopt_rvns_ctx *ctx, unsigned iters);
 
@@ -165,6 +248,222 @@ size_t hscopt_rvns_k_max(const hscopt_rvns_ctx *ctx);
  */
 unsigned hscopt_rvns_max_threads(const hscopt_rvns_ctx *ctx);
 
+/**
+ * @brief Avalia uma solução externa e a adota se melhorar a incumbente.
+ *
+ * Se o fitness de @p keys for melhor (menor) que o da solução incumbente,
+ * ela passa a ser a incumbente (e o melhor global, se for o caso). O contador
+ * de iterações não é alterado.
+ *
+ * @param ctx Contexto RVNS.
+ * @param keys Vetor de chaves candidato (tamanho = hscopt_rvns_dim(ctx)).
+ *
+ * @return
+ * - 1 se a incumbente foi atualizada,
+ * - 0 se a solução não melhorou,
+ * - valor negativo em caso de erro.
+ *
+ * @note
+ * - @p keys deve estar no intervalo [0,1).
+ * - Esta função não é thread-safe se chamada concorrentemente.
+ */
+int hscopt_rvns_try_update_best(hscopt_rvns_ctx *ctx, const double *keys);
+
+/**
+ * @brief Liga/desliga a manutenção incremental da permutação das chaves.
+ *
+ * Quando ligada, cada thread mantém a ordem das chaves da solução incumbente
+ * em um ::hscopt_keys_perm. Para cada candidato, as k posições alteradas pelo
+ * *shaking* são aplicadas em O(k log dim), o decoder recebe a permutação do
+ * candidato em `ctx->perm` e a alteração é desfeita após a avaliação.
+ *
+ * Assim, decoders baseados em permutação não precisam reordenar as @p dim
+ * chaves a cada candidato.
+ *
+ * @param ctx Contexto RVNS.
+ * @param enable 1 para ligar, 0 para desligar.
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ *
+ * @note
+ * - O decoder recebe uma cópia de @p dctx (por thread) com o campo `perm`
+ *   preenchido; os demais campos são copiados a cada hscopt_rvns_iterate().
+ * - A permutação recebida é somente leitura e válida apenas durante a chamada.
+ */
+int hscopt_rvns_set_track_perm(hscopt_rvns_ctx *ctx, int enable);
+
+/**
+ * @brief Indica se a permutação incremental está ligada.
+ *
+ * @param ctx Contexto RVNS.
+ * @return 1 se ligada, 0 caso contrário.
+ */
+int hscopt_rvns_track_perm(const hscopt_rvns_ctx *ctx);
+
+/**
+ * @brief Define o número de candidatos gerados por vizinhança.
+ *
+ * Os candidatos de cada vizinhança são avaliados em paralelo e o melhor (menor
+ * índice em caso de empate) é comparado com a incumbente. O default é
+ * `max_threads`; fixar este valor torna a trajetória independente do número
+ * de threads.
+ *
+ * @param ctx Contexto RVNS.
+ * @param n_cand Número de candidatos (>= 1).
+ * @return 0 em sucesso, valor diferente de 0 em erro.
+ */
+int hscopt_rvns_set_candidates(hscopt_rvns_ctx *ctx, size_t n_cand);
+
+/**
+ * @brief Retorna o número de candidatos por vizinhança.
+ *
+ * @param ctx Contexto RVNS.
+ * @return Número de candidatos.
+ */
+size_t hscopt_rvns_candidates(const hscopt_rvns_ctx *ctx);
+
+/**
+ * @brief Passa a avaliar os candidatos via um decoder assíncrono.
+ *
+ * Os `hscopt_rvns_candidates()` candidatos de cada vizinhança são gerados e
+ * enviados em um único lote, com os resultados aceitos em qualquer ordem;
+ * com hscopt_rvns_set_candidates() na casa das centenas, uma única thread
+ * mantém centenas de avaliações em andamento. A trajetória é a mesma do
+ * modo síncrono com o mesmo número de candidatos. hscopt_rvns_reset()
+ * também avalia a solução inicial pelo avaliador.
+ *
+ * @param ctx Contexto RVNS.
+ * @param ad Avaliador (copiado), ou NULL para voltar ao decoder síncrono.
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória.
+ *
+ * @note O avaliador não recebe `hscopt_decode_ctx::perm`;
+ * hscopt_rvns_try_update_best() continua usando o decoder síncrono.
+ */
+int hscopt_rvns_set_async(hscopt_rvns_ctx *ctx,
+                          const hscopt_async_decoder *ad);
+
+/**
+ * @brief Liga a triagem dos candidatos por um modelo substituto.
+ *
+ * A cada vizinhança, os candidatos são gerados, triados pelo modelo contra o
+ * objetivo da incumbente e só os promissores vão ao decoder (ou ao avaliador
+ * assíncrono); os descartados contam como rejeitados. A solução inicial e os
+ * candidatos avaliados alimentam o arquivo do modelo.
+ *
+ * @param ctx Contexto RVNS.
+ * @param s Modelo (emprestado; deve viver até ser desligado ou até o
+ * destroy), ou NULL para desligar.
+ * @return 0 em sucesso, 1 se a dimensão do modelo não for a do contexto ou
+ * em falta de memória.
+ *
+ * @note Com triagem, a trajetória depende do modelo e do seu arquivo.
+ */
+int hscopt_rvns_set_surrogate(hscopt_rvns_ctx *ctx, hscopt_surrogate *s);
+
+/**
+ * @brief Liga a avaliação limitada (corte) dos candidatos.
+ *
+ * Um candidato só substitui a incumbente se o seu objetivo for menor que
+ * `fx`. Com o corte ligado, o decoder recebe `bounded = 1` e `cutoff` = fx
+ * (em cópias do dctx) e pode parar cedo retornando qualquer valor >= cutoff
+ * (ver hscopt_decode_cutoff()). O mesmo vale para
+ * hscopt_rvns_try_update_best(). Valores limitados nunca viram `fx`, o melhor
+ * global ou pontos do arquivo do modelo substituto.
+ *
+ * @param ctx Contexto RVNS.
+ * @param enable 1 para ligar, 0 para desligar (default).
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ *
+ * @note O corte vale para o decoder síncrono; o contrato assíncrono não o
+ * transporta. A trajetória é a mesma com ou sem corte.
+ */
+int hscopt_rvns_set_cutoff(hscopt_rvns_ctx *ctx, int enable);
+
+/**
+ * @brief Liga o contexto a um quadro da melhor solução (board.h).
+ *
+ * Ao fim de cada iteração, na thread que chamou iterate, o melhor global é
+ * oferecido ao quadro se melhorou desde a última oferta, e a solução do
+ * quadro, se melhor que o melhor global, é reavaliada e adotada como
+ * incumbente (hscopt_rvns_try_update_best()). A busca nunca espera pelo
+ * quadro: uma oferta que encontra outra em andamento fica para a próxima
+ * iteração. hscopt_rvns_reconfigure() desliga o quadro se a dimensão mudar.
+ *
+ * @param ctx Contexto RVNS.
+ * @param b Quadro (emprestado; deve viver até ser desligado ou até o
+ * destroy), ou NULL para desligar.
+ * @return 0 em sucesso, 1 se a dimensão do quadro não for a do contexto ou
+ * em falta de memória.
+ *
+ * @note Com o quadro, a trajetória depende do que as outras threads
+ * publicam e de quando: o resultado não é reprodutível.
+ */
+int hscopt_rvns_set_board(hscopt_rvns_ctx *ctx, hscopt_board *b);
+
+/**
+ * @brief Avalia vários níveis da escada no mesmo lote (especulação).
+ *
+ * Sem especulação, cada nível k é um lote de hscopt_rvns_candidates()
+ * candidatos, com uma região paralela (ou um lote assíncrono) por nível. Com
+ * @p levels > 1, os níveis k, ..., k + levels - 1 são gerados e avaliados
+ * juntos, e o resultado segue a regra sequencial: vence o menor nível que
+ * melhora, e os níveis acima dele são descartados. A trajetória é idêntica à
+ * da escada sem especulação, com até @p levels vezes menos sincronizações.
+ * O custo são as avaliações descartadas: até `levels - 1` níveis por
+ * melhoria.
+ *
+ * Só vale para ::HSCOPT_RVNS_LADDER e sem triagem por modelo substituto
+ * (hscopt_rvns_set_surrogate()); nos demais casos os níveis seguem um a um.
+ *
+ * @param ctx Contexto RVNS.
+ * @param levels Níveis por lote (>= 1; 1 = sem especulação, o default).
+ * @return 0 em sucesso, 1 em argumentos inválidos ou falta de memória.
+ */
+int hscopt_rvns_set_speculation(hscopt_rvns_ctx *ctx, size_t levels);
+
+/**
+ * @brief Retorna o número de níveis avaliados por lote.
+ *
+ * @param ctx Contexto RVNS.
+ * @return Níveis por lote.
+ */
+size_t hscopt_rvns_speculation(const hscopt_rvns_ctx *ctx);
+
+/**
+ * @brief Define a regra de escolha da vizinhança.
+ *
+ * - ::HSCOPT_RVNS_LADDER (default): a escada clássica. Cada iteração sobe
+ *   k = 1, ..., k_max e volta a 1 a cada melhoria.
+ * - ::HSCOPT_RVNS_UCB: cada iteração explora k_max vizinhanças, cada uma
+ *   escolhida por UCB1-Tuned. A recompensa de k é a taxa de melhoria por
+ *   avaliação (hscopt_rvns_get_nbhd_stats()), normalizada pelo custo de um
+ *   passo completo (hscopt_rvns_candidates() avaliações). Vizinhanças nunca
+ *   exploradas vêm primeiro, em ordem crescente; os empates ficam com o
+ *   menor k. Em instâncias em que as vizinhanças pequenas raramente
+ *   melhoram, as avaliações migram para as que melhoram.
+ *
+ * A regra vale a partir da próxima iteração e é mantida por
+ * hscopt_rvns_reset() e hscopt_rvns_reconfigure(). As duas regras são
+ * determinísticas: o resultado continua independente do número de threads.
+ *
+ * @param ctx Contexto RVNS.
+ * @param policy Regra.
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ */
+int hscopt_rvns_set_policy(hscopt_rvns_ctx *ctx, hscopt_rvns_policy policy);
+
+/**
+ * @brief Copia os contadores da vizinhança @p k.
+ *
+ * São mantidos com qualquer regra e zerados por hscopt_rvns_reset().
+ *
+ * @param ctx Contexto RVNS.
+ * @param k Vizinhança (1..k_max).
+ * @param out Saída.
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ */
+int hscopt_rvns_get_nbhd_stats(const hscopt_rvns_ctx *ctx, size_t k,
+                               hscopt_rvns_nbhd_stats *out);
+
 #ifdef __cplusplus
 }
 #endif
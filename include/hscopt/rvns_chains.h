@@ -0,0 +1,103 @@
+#ifndef HSCOPT_RVNS_CHAINS_H
+#define HSCOPT_RVNS_CHAINS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/decoder.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file rvns_chains.h
+ * @brief RVNS com várias trajetórias paralelas e incumbente compartilhado.
+ *
+ * O RVNS de um contexto paraleliza só a avaliação dos candidatos de cada
+ * vizinhança, com uma barreira por nível. Aqui cada thread roda a sua própria
+ * trajetória (um ::hscopt_rvns_ctx com uma thread, o seu `x`/`fx` e o seu
+ * fluxo de RNG), sem barreiras entre as cadeias:
+ *
+ * - cada melhoria de uma cadeia é publicada em um incumbente global sem
+ *   lock (um ::hscopt_board); se outra cadeia estiver publicando, a
+ *   publicação fica para a próxima iteração, sem esperar;
+ * - uma cadeia que passa `stall_iters` iterações sem melhorar lê o
+ *   incumbente global e recomeça dele, se for melhor que o seu.
+ *
+ * @code
+ * hscopt_rvns_chains_opts o;
+ * hscopt_rvns_chains_opts_default(&o);
+ * o.n_chains = 8;
+ * o.k_max = 10;
+ * hscopt_rvns_chains_run(dim, 1000, decoder, &dctx, &rng, &o, best, &res);
+ * @endcode
+ */
+
+/**
+ * @struct hscopt_rvns_chains_opts
+ * @brief Opções das cadeias.
+ */
+typedef struct hscopt_rvns_chains_opts {
+  unsigned n_chains;          // cadeias, uma por thread (a chamadora é uma)
+  size_t k_max;               // maior vizinhança de cada cadeia
+  unsigned stall_iters;       // iterações sem melhora até recomeçar (0 = não)
+  hscopt_rvns_policy policy;  // regra de vizinhança de cada cadeia
+} hscopt_rvns_chains_opts;
+
+/**
+ * @struct hscopt_rvns_chains_result
+ * @brief Resultado das cadeias.
+ */
+typedef struct hscopt_rvns_chains_result {
+  double best_fitness;  // melhor fitness global
+  unsigned chain;       // cadeia que terminou com o melhor
+  uint64_t publishes;   // melhorias publicadas no incumbente global
+  uint64_t restarts;    // recomeços a partir do incumbente global
+} hscopt_rvns_chains_result;
+
+/**
+ * @brief Preenche as opções default.
+ *
+ * Default: 1 cadeia, k_max 5, recomeço após 50 iterações sem melhora, regra
+ * ::HSCOPT_RVNS_LADDER.
+ *
+ * @param out Saída.
+ */
+void hscopt_rvns_chains_opts_default(hscopt_rvns_chains_opts *out);
+
+/**
+ * @brief Roda as cadeias até cada uma completar @p max_iters iterações.
+ *
+ * A cadeia i usa uma cópia de @p rng avançada por i hscopt_rng_jump(): os
+ * fluxos não se sobrepõem. Cada cadeia parte de uma solução aleatória.
+ *
+ * @param dim Número de chaves.
+ * @param max_iters Iterações de cada cadeia.
+ * @param decoder Decoder.
+ * @param dctx Contexto do decoder (pode ser NULL).
+ * @param rng RNG base (não é alterado).
+ * @param opts Opções (NULL = default).
+ * @param best_keys Saída com as chaves do melhor global (tamanho dim).
+ * @param out Resultado (pode ser NULL).
+ * @return 0 em sucesso, 1 em argumentos inválidos, 2 se alguma cadeia não
+ * puder ser criada ou falhar, 3 se uma thread não puder ser criada (a
+ * cadeia dela roda na chamadora, depois das demais).
+ *
+ * @note O decoder é chamado por várias threads ao mesmo tempo, com o mesmo
+ * @p dctx. Como as cadeias trocam soluções conforme o tempo de cada uma, o
+ * resultado com mais de uma cadeia não é reprodutível.
+ */
+int hscopt_rvns_chains_run(size_t dim, unsigned max_iters,
+                           hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+                           const hscopt_rng *rng,
+                           const hscopt_rvns_chains_opts *opts,
+                           double *best_keys, hscopt_rvns_chains_result *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_RVNS_CHAINS_H */
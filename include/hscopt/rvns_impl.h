@@ -0,0 +1,617 @@
+#ifndef HSCOPT_RVNS_IMPL_H
+#define HSCOPT_RVNS_IMPL_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hscopt/affinity.h"
+#include "hscopt/alloc.h"
+#include "hscopt/async.h"
+#include "hscopt/board.h"
+#include "hscopt/decoder.h"
+#include "hscopt/defs.h"
+#include "hscopt/keys.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+#include "hscopt/surrogate.h"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file rvns_impl.h
+ * @brief Núcleo do RVNS em header, para instanciar com um decoder fixo.
+ *
+ * Equivalente de hho_impl.h para o RVNS: HSCOPT_DEFINE_RVNS() gera uma
+ * iteração em que o decoder é conhecido em tempo de compilação e pode ser
+ * expandido inline na avaliação dos candidatos.
+ *
+ * @code
+ * HSCOPT_DEFINE_RVNS(tsp_rvns, tsp)
+ *
+ * hscopt_rvns_ctx *v = tsp_rvns_create(NULL, dim, 5, 1000, 1, &dctx, &rng);
+ * tsp_rvns_iterate(v, 1000);
+ * hscopt_rvns_destroy(v);
+ * @endcode
+ *
+ * Com as mesmas flags de ponto flutuante da biblioteca, o resultado é
+ * idêntico ao de hscopt_rvns_iterate().
+ *
+ * @note As funções `hscopt_rvns_impl_*` e o layout de
+ * `struct hscopt_rvns_ctx` não fazem parte da API estável.
+ */
+
+/** Posições sorteadas do candidato @p c. */
+#define HSCOPT_RVNS_SHAKE_IDX(ctx, c) \
+  (&(ctx)->shake_idx[(size_t)(c) * (ctx)->k_max])
+
+/** Iteração especializada guardada no contexto. */
+typedef void (*hscopt_rvns_kernel_fn)(hscopt_rvns_ctx *ctx, unsigned iters);
+
+struct hscopt_rvns_ctx {
+  size_t dim;                 // tamanho do vetor de chaves aleatórias
+  size_t k_max;               // pertubação máxima
+  size_t cap_dim;             // capacidade dos buffers por linha (>= dim)
+  size_t cap_k;               // capacidade por candidato de shake_idx
+  unsigned iter;              // iteração atual
+  unsigned max_iters;         // número máximo de iterações
+  unsigned max_threads;       // número máximo de threads
+  unsigned eff_threads;       // número real de threads usadas
+  int *cpus;                  // CPU de cada thread [eff_threads] (ou NULL)
+  hscopt_decoder_fn decoder;  // decoder
+  hscopt_decode_ctx *dctx;    // contexto do decder
+  hscopt_rng rng;             // cópia do RNG do usuário (x inicial e chave)
+  hscopt_ctr_rng ctr;         // RNG por contador usado no shaking
+  uint64_t step;              // avaliações de vizinhança desde o reset
+  hscopt_rvns_policy policy;  // regra de escolha da vizinhança
+  hscopt_rvns_nbhd_stats *nbhd;  // contadores por vizinhança [cap_k]
+  size_t n_cand;              // candidatos por vizinhança
+  size_t n_spec;              // níveis da escada avaliados por lote (>= 1)
+  double *x;                  // melhor atual
+  double fx;                  // melhor função objetivo
+  double *best;               // melhor global
+  double fbest;               // função objetivo do melhor global
+  double *cand_keys;          // candidatos [n_spec * n_cand * dim]
+  double *cand_fit;           // candidatos [n_spec * n_cand]
+
+  hscopt_keys_perm **perm_tls;   // permutação de x por thread (ou NULL)
+  hscopt_decode_ctx *dctx_tls;   // cópias do dctx com perm [eff_threads]
+  size_t *shake_idx;             // posições sorteadas [n_spec*n_cand*cap_k]
+
+  hscopt_async_decoder async;    // avaliador assíncrono (submit NULL = não)
+  const double **async_rows;     // candidatos do lote [n_spec * n_cand]
+
+  hscopt_surrogate *surrogate;   // triagem dos candidatos (NULL = não)
+  unsigned char *surr_v;         // decisão da triagem [n_cand]
+  size_t *surr_idx;              // candidatos que passaram [n_cand]
+  double *surr_fit;              // objetivos do lote assíncrono [n_cand]
+
+  int cutoff;                    // avaliação limitada dos candidatos
+  hscopt_decode_ctx dctx_cut;    // cópia do dctx com o corte
+
+  hscopt_board *board;           // quadro compartilhado (NULL = não)
+  double *board_keys;            // cópia lida do quadro [dim]
+  double board_pub;              // último fbest oferecido ao quadro
+  uint64_t board_seen;           // última versão lida do quadro
+
+  hscopt_rvns_kernel_fn kernel;  // iteração especializada para dim
+  hscopt_allocator alloc;
+};
+
+HSCOPT_INLINE unsigned hscopt_rvns_impl_thread_id(void) {
+#ifdef _OPENMP
+  return (unsigned)omp_get_thread_num();
+#else
+  return 0u;
+#endif /* ifdef _OPENMP */
+}
+
+// Fixa a thread na sua CPU, uma vez por região paralela; a região termina
+// com hscopt_rvns_impl_unpin().
+HSCOPT_INLINE void hscopt_rvns_impl_pin(const hscopt_rvns_ctx *ctx) {
+  if (ctx->cpus) {
+    hscopt_affinity_pin_current(ctx->cpus[hscopt_rvns_impl_thread_id()]);
+  }
+}
+
+HSCOPT_INLINE void hscopt_rvns_impl_unpin(const hscopt_rvns_ctx *ctx) {
+  if (ctx->cpus) {
+    hscopt_affinity_unpin_current();
+  }
+}
+
+/** Lote de candidatos de um passo, dividido entre as threads. */
+typedef struct hscopt_rvns_impl_rows {
+  size_t k;               // nível da primeira vizinhança do lote
+  uint64_t step;          // fluxo do nível k
+  hscopt_decode_ctx *dc;  // contexto sem permutação (com corte, se houver)
+  int shake;              // 1 = gera as linhas; 0 = linhas são surr_idx
+  int eval;               // avalia com o decoder
+} hscopt_rvns_impl_rows;
+
+/**
+ * Processa as linhas [lo, hi) de um lote. Cada instância do núcleo tem a
+ * sua, com dim e decoder constantes, chamada uma vez por thread pela região
+ * paralela de hscopt_rvns_impl_run_rows().
+ */
+typedef void (*hscopt_rvns_rows_fn)(hscopt_rvns_ctx *ctx,
+                                    const hscopt_rvns_impl_rows *job,
+                                    size_t lo, size_t hi);
+
+// Atualiza as cópias por thread do dctx (o usuário pode alterá-lo entre
+// chamadas) apontando cada uma para a permutação da sua thread.
+HSCOPT_INLINE void hscopt_rvns_impl_perm_sync(hscopt_rvns_ctx *ctx) {
+  for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+    if (ctx->dctx) {
+      ctx->dctx_tls[t] = *ctx->dctx;
+    } else {
+      memset(&ctx->dctx_tls[t], 0, sizeof(ctx->dctx_tls[t]));
+    }
+    ctx->dctx_tls[t].perm = ctx->perm_tls[t];
+  }
+}
+
+// Shaking em N_k(x), primeiro copia x para y e pertuba k posições.
+// Se idx != NULL, registra as posições sorteadas (com repetições).
+HSCOPT_INLINE size_t hscopt_rvns_impl_shake(double *y, const double *x,
+                                            size_t dim, size_t k,
+                                            hscopt_ctr_stream *st,
+                                            size_t *idx) {
+  memcpy(y, x, dim * sizeof(double));
+  if (k > dim) k = dim;
+  for (size_t t = 0; t < k; ++t) {
+    const size_t j = hscopt_ctr_stream_random_index(st, dim);
+    y[j] = HSCOPT_CLAMP_KEY(hscopt_ctr_stream_next_u01(st));
+    if (idx) idx[t] = j;
+  }
+  return k;
+}
+
+// Atualiza a permutação p para as chaves de dst nas posições idx.
+HSCOPT_INLINE void hscopt_rvns_impl_perm_apply(hscopt_keys_perm *p,
+                                               const double *dst,
+                                               const size_t *idx, size_t n) {
+  for (size_t t = 0; t < n; ++t) {
+    hscopt_keys_perm_update(p, idx[t], dst[idx[t]]);
+  }
+}
+
+// Copia o dctx do usuário (que pode mudar entre chamadas) para dctx_cut.
+HSCOPT_INLINE void hscopt_rvns_impl_cut_sync(hscopt_rvns_ctx *ctx) {
+  if (ctx->dctx) {
+    ctx->dctx_cut = *ctx->dctx;
+  } else {
+    memset(&ctx->dctx_cut, 0, sizeof(ctx->dctx_cut));
+  }
+  ctx->dctx_cut.bounded = 1;
+}
+
+// Contexto dos candidatos de uma vizinhança: com corte, só interessa saber
+// se o objetivo fica abaixo de fx (também nas cópias por thread).
+HSCOPT_INLINE hscopt_decode_ctx *hscopt_rvns_impl_bound(hscopt_rvns_ctx *ctx) {
+  if (!ctx->cutoff) {
+    return ctx->dctx;
+  }
+  ctx->dctx_cut.cutoff = ctx->fx;
+  if (ctx->perm_tls) {
+    for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+      ctx->dctx_tls[t].bounded = 1;
+      ctx->dctx_tls[t].cutoff = ctx->fx;
+    }
+  }
+  return &ctx->dctx_cut;
+}
+
+/**
+ * @brief Valida uma chamada de iterate e sincroniza as cópias do dctx.
+ *
+ * @return 0 se pode iterar, 1 em argumentos inválidos, 2 se ultrapassar
+ * max_iters (mesmos códigos de hscopt_rvns_iterate()).
+ */
+HSCOPT_INLINE int hscopt_rvns_impl_begin(hscopt_rvns_ctx *ctx,
+                                         unsigned iters) {
+  if (!ctx || iters == 0) {
+    return 1;  // o núemro de itereações executadas não pode ser 0
+  }
+
+  if (ctx->iter >= ctx->max_iters) {
+    return 2;  // iter já ultrapassou o maximo de iterações
+  }
+  if (ctx->iter + iters > ctx->max_iters) {
+    return 2;  // passa o máximo ao executar as iterações solicitadas
+  }
+
+  if (ctx->perm_tls) hscopt_rvns_impl_perm_sync(ctx);
+  if (ctx->cutoff) hscopt_rvns_impl_cut_sync(ctx);
+  return 0;
+}
+
+// Corpo de um ::hscopt_rvns_rows_fn. Com @p shake, a linha r é o candidato
+// r % n_cand do nível k + r / n_cand, gerado pelo fluxo (step + nível, c),
+// qualquer que seja a thread que o execute: o resultado independe de
+// max_threads e de n_spec. Sem @p shake, a linha t é o candidato surr_idx[t]
+// do nível k, já gerado.
+HSCOPT_INLINE void hscopt_rvns_impl_rows_run(hscopt_rvns_ctx *ctx,
+                                             const hscopt_rvns_impl_rows *job,
+                                             size_t lo, size_t hi,
+                                             const size_t dim,
+                                             hscopt_decoder_fn decode) {
+  const int track = ctx->perm_tls != NULL;
+  const unsigned tid = hscopt_rvns_impl_thread_id();
+  const size_t n_cand = ctx->n_cand;
+  for (size_t t = lo; t < hi; ++t) {
+    size_t r = t, n;
+    if (job->shake) {
+      const size_t j = t / n_cand;
+      hscopt_ctr_stream st;
+      hscopt_ctr_stream_init(&st, &ctx->ctr, job->step + j,
+                             (uint32_t)(t % n_cand));
+      n = hscopt_rvns_impl_shake(&ctx->cand_keys[t * dim], ctx->x, dim,
+                                 job->k + j, &st,
+                                 track ? HSCOPT_RVNS_SHAKE_IDX(ctx, t) : NULL);
+    } else {
+      r = ctx->surr_idx[t];
+      n = (job->k < dim ? job->k : dim);
+    }
+    if (!job->eval) continue;
+
+    const double *const y = &ctx->cand_keys[r * dim];
+    if (track) {
+      // Aplica as k alterações, avalia e volta a permutação para x.
+      const size_t *idx = HSCOPT_RVNS_SHAKE_IDX(ctx, r);
+      hscopt_rvns_impl_perm_apply(ctx->perm_tls[tid], y, idx, n);
+      ctx->cand_fit[r] = decode(y, dim, &ctx->dctx_tls[tid]);
+      hscopt_rvns_impl_perm_apply(ctx->perm_tls[tid], ctx->x, idx, n);
+    } else {
+      ctx->cand_fit[r] = decode(y, dim, job->dc);
+    }
+  }
+}
+
+// Divide as linhas [0, n) do lote em blocos contíguos, um por thread. A
+// região paralela só fixa a thread, chama @p rows e desfaz a fixação; o
+// laço, com o decoder, fica em @p rows. Com uma thread, não abre região
+// paralela.
+HSCOPT_INLINE void hscopt_rvns_impl_run_rows(hscopt_rvns_ctx *ctx,
+                                             hscopt_rvns_rows_fn rows,
+                                             const hscopt_rvns_impl_rows *job,
+                                             size_t n) {
+#ifdef _OPENMP
+  if (ctx->eff_threads > 1u) {
+#pragma omp parallel num_threads(ctx->eff_threads)
+    {
+      hscopt_rvns_impl_pin(ctx);
+      const size_t t = (size_t)omp_get_thread_num();
+      const size_t nt = (size_t)omp_get_num_threads();
+      const size_t q = n / nt, rem = n % nt;
+      const size_t lo = t * q + (t < rem ? t : rem);
+      rows(ctx, job, lo, lo + q + (t < rem ? 1u : 0u));
+      hscopt_rvns_impl_unpin(ctx);
+    }
+    return;
+  }
+#endif /* ifdef _OPENMP */
+  hscopt_rvns_impl_pin(ctx);
+  rows(ctx, job, 0, n);
+  hscopt_rvns_impl_unpin(ctx);
+}
+
+// Avalia os @p n primeiros candidatos pelo avaliador assíncrono, em um
+// único lote.
+HSCOPT_INLINE int hscopt_rvns_impl_eval_async(hscopt_rvns_ctx *ctx,
+                                              const size_t dim, size_t n) {
+  for (size_t r = 0; r < n; ++r) {
+    ctx->async_rows[r] = &ctx->cand_keys[r * dim];
+  }
+  return hscopt_async_eval(&ctx->async, ctx->async_rows, dim, n,
+                           ctx->cand_fit);
+}
+
+// Avaliação com triagem: só os candidatos que o modelo substituto deixa
+// passar vão ao decoder (ou, com @p decode NULL, ao avaliador assíncrono);
+// os demais ficam com INFINITY. @p k é o nível do shaking; @p n_eval
+// recebe o número de candidatos avaliados.
+HSCOPT_INLINE int hscopt_rvns_impl_eval_screened(hscopt_rvns_ctx *ctx,
+                                                 const size_t dim, size_t k,
+                                                 hscopt_decoder_fn decode,
+                                                 hscopt_rvns_rows_fn rows,
+                                                 hscopt_decode_ctx *dc,
+                                                 size_t *n_eval) {
+  hscopt_surrogate *const s = ctx->surrogate;
+  size_t m = 0;
+  for (size_t c = 0; c < ctx->n_cand; ++c) {
+    const double *const y = &ctx->cand_keys[c * dim];
+    const hscopt_surrogate_verdict v = hscopt_surrogate_screen(s, y, ctx->fx);
+    ctx->surr_v[c] = (unsigned char)v;
+    ctx->cand_fit[c] = INFINITY;
+    if (v != HSCOPT_SURROGATE_SKIP) ctx->surr_idx[m++] = c;
+  }
+  *n_eval = m;
+
+  if (decode) {
+    const hscopt_rvns_impl_rows job = {k, 0u, dc, 0, 1};
+    hscopt_rvns_impl_run_rows(ctx, rows, &job, m);
+  } else if (m > 0) {
+    for (size_t t = 0; t < m; ++t) {
+      ctx->async_rows[t] = &ctx->cand_keys[ctx->surr_idx[t] * dim];
+    }
+    if (hscopt_async_eval(&ctx->async, ctx->async_rows, dim, m,
+                          ctx->surr_fit) != 0) {
+      return 1;
+    }
+    for (size_t t = 0; t < m; ++t) {
+      ctx->cand_fit[ctx->surr_idx[t]] = ctx->surr_fit[t];
+    }
+  }
+
+  // Resultados limitados pelo corte entram só nas estatísticas.
+  for (size_t t = 0; t < m; ++t) {
+    const size_t c = ctx->surr_idx[t];
+    const double f = ctx->cand_fit[c];
+    const int exact = !(ctx->cutoff && decode) || f < ctx->fx;
+    hscopt_surrogate_record(s, exact ? &ctx->cand_keys[c * dim] : NULL, f,
+                            ctx->fx, (hscopt_surrogate_verdict)ctx->surr_v[c]);
+  }
+  return 0;
+}
+
+// Escolhe a próxima vizinhança por UCB1-Tuned. A média de k é a taxa de
+// melhoria por avaliação vezes n_cand (limitada a 1), tratada como uma
+// Bernoulli por passo; as vizinhanças ainda não exploradas vêm primeiro.
+HSCOPT_INLINE size_t hscopt_rvns_impl_choose(const hscopt_rvns_ctx *ctx) {
+  uint64_t total = 0;
+  for (size_t k = 0; k < ctx->k_max; ++k) {
+    if (ctx->nbhd[k].steps == 0) return k + 1;
+    total += ctx->nbhd[k].steps;
+  }
+
+  const double ln_total = log((double)total);
+  size_t best_k = 1;
+  double best_score = -INFINITY;
+  for (size_t k = 0; k < ctx->k_max; ++k) {
+    const hscopt_rvns_nbhd_stats *const st = &ctx->nbhd[k];
+    const double n = (double)st->steps;
+    double mean = 0.0;
+    if (st->evals > 0) {
+      mean = (double)st->improvements * (double)ctx->n_cand /
+             (double)st->evals;
+      if (mean > 1.0) mean = 1.0;
+    }
+    double var = mean * (1.0 - mean) + sqrt(2.0 * ln_total / n);
+    if (var > 0.25) var = 0.25;
+    const double score = mean + sqrt(ln_total / n * var);
+    if (score > best_score) {
+      best_score = score;
+      best_k = k + 1;
+    }
+  }
+  return best_k;
+}
+
+// Explora as vizinhanças k, ..., k + n_lv - 1 em um único lote: gera e
+// avalia os n_cand candidatos de cada uma e aceita o melhor candidato da
+// menor vizinhança que melhora a incumbente, como a escada sequencial faria.
+// Os níveis acima dela são descartados. Retorna em @p used o número de níveis
+// consumidos e 1 se houve melhoria, 0 se não e -1 se o avaliador assíncrono
+// falhar.
+HSCOPT_INLINE int hscopt_rvns_impl_step(hscopt_rvns_ctx *ctx, size_t k,
+                                        size_t n_lv, const size_t dim,
+                                        hscopt_decoder_fn decode,
+                                        hscopt_rvns_rows_fn rows,
+                                        size_t *used) {
+  const int track = ctx->perm_tls != NULL;
+  const int screen = ctx->surrogate != NULL;
+  const size_t n_cand = ctx->n_cand;
+  const size_t n_rows = n_lv * n_cand;
+
+  hscopt_decode_ctx *const dc = hscopt_rvns_impl_bound(ctx);
+  const hscopt_rvns_impl_rows job = {k, ctx->step, dc, 1,
+                                     decode && !screen};
+  hscopt_rvns_impl_run_rows(ctx, rows, &job, n_rows);
+
+  // Com triagem, n_lv é 1.
+  size_t n_eval = n_cand;
+  if (screen) {
+    if (hscopt_rvns_impl_eval_screened(ctx, dim, k, decode, rows, dc,
+                                       &n_eval) != 0) {
+      return -1;
+    }
+  } else if (!decode && hscopt_rvns_impl_eval_async(ctx, dim, n_rows) != 0) {
+    return -1;
+  }
+
+  // Menor nível que melhora; no nível, vence o menor índice de candidato.
+  for (size_t j = 0; j < n_lv; ++j) {
+    const double *const fit = &ctx->cand_fit[j * n_cand];
+    size_t best_c = 0;
+    double fy_best = fit[0];
+    for (size_t c = 1; c < n_cand; ++c) {
+      if (fit[c] < fy_best) {
+        fy_best = fit[c];
+        best_c = c;
+      }
+    }
+
+    hscopt_rvns_nbhd_stats *const ns = &ctx->nbhd[k + j - 1];
+    ++ns->steps;
+    ns->evals += n_eval;
+    if (!(fy_best < ctx->fx)) {
+      continue;
+    }
+    ++ns->improvements;
+
+    const size_t r = j * n_cand + best_c;
+    memcpy(ctx->x, &ctx->cand_keys[r * dim], dim * sizeof(double));
+    ctx->fx = fy_best;
+
+    if (track) {
+      const size_t *idx = HSCOPT_RVNS_SHAKE_IDX(ctx, r);
+      const size_t n = (k + j < dim ? k + j : dim);
+      for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+        hscopt_rvns_impl_perm_apply(ctx->perm_tls[t], ctx->x, idx, n);
+      }
+    }
+
+    if (ctx->fx < ctx->fbest) {
+      ctx->fbest = ctx->fx;
+      memcpy(ctx->best, ctx->x, dim * sizeof(double));
+    }
+    ctx->step += j + 1;
+    *used = j + 1;
+    return 1;
+  }
+  ctx->step += n_lv;
+  *used = n_lv;
+  return 0;
+}
+
+// Troca com o quadro, no fim da iteração: oferece o melhor global se ele
+// melhorou desde a última oferta e adota o do quadro como incumbente se for
+// melhor. Uma oferta que encontrou outra em andamento é refeita na próxima
+// iteração.
+HSCOPT_INLINE void hscopt_rvns_impl_board_sync(hscopt_rvns_ctx *ctx) {
+  hscopt_board *const b = ctx->board;
+  if (ctx->fbest < ctx->board_pub &&
+      hscopt_board_offer(b, ctx->best, ctx->fbest) >= 0) {
+    ctx->board_pub = ctx->fbest;
+  }
+  if (hscopt_board_version(b) != ctx->board_seen &&
+      hscopt_board_fitness(b) < ctx->fbest) {
+    hscopt_board_read(b, ctx->board_keys, NULL, &ctx->board_seen);
+    if (hscopt_rvns_try_update_best(ctx, ctx->board_keys) == 1 &&
+        ctx->fbest < ctx->board_pub) {
+      ctx->board_pub = ctx->fbest;  // já está no quadro
+    }
+  }
+}
+
+// Corpo de uma chamada de iterate. @p rows gera e avalia os candidatos;
+// para que o shaking e o decoder vejam dim e decode constantes, ela deve
+// ser instanciada com os mesmos @p dim e @p decode. Com @p decode NULL, os
+// candidatos vão para o avaliador assíncrono (retorna 3 se ele falhar).
+// Com modelo substituto, os candidatos são gerados primeiro e avaliados
+// depois da triagem.
+HSCOPT_INLINE int hscopt_rvns_impl_iterate(hscopt_rvns_ctx *ctx,
+                                            unsigned iters, const size_t dim,
+                                            hscopt_decoder_fn decode,
+                                            hscopt_rvns_rows_fn rows) {
+  for (unsigned it = 0; it < iters; ++it) {
+    size_t used;
+    if (ctx->policy == HSCOPT_RVNS_UCB) {
+      for (size_t s = 0; s < ctx->k_max; ++s) {
+        const size_t k = hscopt_rvns_impl_choose(ctx);
+        if (hscopt_rvns_impl_step(ctx, k, 1, dim, decode, rows, &used) <
+            0) {
+          return 3;
+        }
+      }
+    } else {
+      size_t k = 1;  // nível da pertubação
+      while (k <= ctx->k_max) {
+        // Especulação: os próximos níveis no mesmo lote (sem triagem).
+        size_t n_lv = (ctx->surrogate ? 1u : ctx->n_spec);
+        if (n_lv > ctx->k_max - k + 1) n_lv = ctx->k_max - k + 1;
+        const int rc =
+            hscopt_rvns_impl_step(ctx, k, n_lv, dim, decode, rows, &used);
+        if (rc < 0) {
+          return 3;
+        }
+        k = (rc > 0 ? 1 : k + used); /* volta para N_1 ao melhorar */
+      }
+    }
+
+    if (ctx->board) {
+      hscopt_rvns_impl_board_sync(ctx);
+    }
+    ++ctx->iter;
+  }
+  return 0;
+}
+
+// Caso do switch de HSCOPT_DEFINE_RVNS: usa ctx, iters, decode e rows do
+// escopo.
+#define HSCOPT_RVNS_IMPL_DIM_CASE(D)                                  \
+  case D:                                                             \
+    hscopt_rvns_impl_iterate(ctx, iters, (size_t)(D), decode, rows); \
+    break;
+
+// Caso do switch das linhas de HSCOPT_DEFINE_RVNS: usa ctx, job, lo, hi e
+// decode do escopo.
+#define HSCOPT_RVNS_IMPL_ROWS_CASE(D)                                   \
+  case D:                                                               \
+    hscopt_rvns_impl_rows_run(ctx, job, lo, hi, (size_t)(D), decode); \
+    break;
+
+/**
+ * @brief Gera um RVNS especializado para o decoder @p fn.
+ *
+ * Define, com ligação `static`:
+ * - `prefix_create(x0, dim, k_max, max_iters, max_threads, dctx, rng)`;
+ * - `prefix_create_with_allocator(..., rng, alloc)`;
+ * - `prefix_iterate(ctx, iters)`, com os mesmos códigos de retorno de
+ *   hscopt_rvns_iterate() e 1 se @p ctx foi criado com outro decoder.
+ *
+ * As demais operações são as `hscopt_rvns_*`. O laço dos candidatos
+ * (shaking e decoder) é gerado aqui, dentro das linhas da região paralela,
+ * com dim constante nas dimensões de ::HSCOPT_FOR_EACH_FIXED_DIM. Com um
+ * avaliador assíncrono configurado, `prefix_iterate` delega a
+ * hscopt_rvns_iterate().
+ *
+ * @param prefix Prefixo dos nomes gerados.
+ * @param fn Decoder (`hscopt_decoder_fn`), visível nesta unidade.
+ */
+#define HSCOPT_DEFINE_RVNS(prefix, fn)                                        \
+  HSCOPT_UNUSED static hscopt_rvns_ctx *prefix##_create_with_allocator(       \
+      const double *x0, size_t dim, size_t k_max, unsigned max_iters,         \
+      unsigned max_threads, hscopt_decode_ctx *dctx, hscopt_rng *rng,         \
+      const hscopt_allocator *alloc) {                                        \
+    return hscopt_rvns_create_with_allocator(x0, dim, k_max, max_iters,       \
+                                             max_threads, (fn), dctx, rng,    \
+                                             alloc);                          \
+  }                                                                           \
+  HSCOPT_UNUSED static hscopt_rvns_ctx *prefix##_create(                      \
+      const double *x0, size_t dim, size_t k_max, unsigned max_iters,         \
+      unsigned max_threads, hscopt_decode_ctx *dctx, hscopt_rng *rng) {       \
+    return prefix##_create_with_allocator(x0, dim, k_max, max_iters,          \
+                                          max_threads, dctx, rng, NULL);      \
+  }                                                                           \
+  static void prefix##_rows(hscopt_rvns_ctx *ctx,                             \
+                            const hscopt_rvns_impl_rows *job, size_t lo,      \
+                            size_t hi) {                                      \
+    const hscopt_decoder_fn decode = (fn);                                    \
+    switch (ctx->dim) {                                                       \
+      HSCOPT_FOR_EACH_FIXED_DIM(HSCOPT_RVNS_IMPL_ROWS_CASE)                   \
+      default:                                                                \
+        hscopt_rvns_impl_rows_run(ctx, job, lo, hi, ctx->dim, decode);        \
+        break;                                                                \
+    }                                                                         \
+  }                                                                           \
+  HSCOPT_UNUSED static int prefix##_iterate(hscopt_rvns_ctx *ctx,             \
+                                            unsigned iters) {                 \
+    const hscopt_decoder_fn decode = (fn);                                    \
+    const hscopt_rvns_rows_fn rows = prefix##_rows;                           \
+    if (ctx && ctx->decoder != decode) return 1;                              \
+    if (ctx && ctx->async.submit) return hscopt_rvns_iterate(ctx, iters);     \
+    const int rc = hscopt_rvns_impl_begin(ctx, iters);                        \
+    if (rc != 0) return rc;                                                   \
+    switch (ctx->dim) {                                                       \
+      HSCOPT_FOR_EACH_FIXED_DIM(HSCOPT_RVNS_IMPL_DIM_CASE)                    \
+      default:                                                                \
+        hscopt_rvns_impl_iterate(ctx, iters, ctx->dim, decode, rows);         \
+        break;                                                                \
+    }                                                                         \
+    return 0;                                                                 \
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_RVNS_IMPL_H */
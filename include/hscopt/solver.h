@@ -0,0 +1,99 @@
+#ifndef HSCOPT_SOLVER_H
+#define HSCOPT_SOLVER_H
+
+#include <stddef.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/decoder.h"
+#include "hscopt/rng.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file solver.h
+ * @brief Interface comum (vtable) dos solvers da biblioteca.
+ *
+ * Permite tratar HHO, RVNS e solvers do usuário de forma uniforme, por
+ * exemplo no portfólio (portfolio.h).
+ */
+
+/**
+ * @struct hscopt_solver_config
+ * @brief Parâmetros comuns de criação de um solver.
+ */
+typedef struct hscopt_solver_config {
+  size_t dim;                     // número de chaves
+  unsigned max_iters;             // número máximo de iterações
+  unsigned max_threads;           // threads para avaliação
+  hscopt_decoder_fn decoder;      // decoder (obrigatório)
+  hscopt_decode_ctx *dctx;        // contexto do decoder (pode ser NULL)
+  hscopt_rng *rng;                // RNG (obrigatório, um por solver)
+  const hscopt_allocator *alloc;  // alocador (NULL = global)
+  const void *params;             // parâmetros específicos do algoritmo
+} hscopt_solver_config;
+
+/**
+ * @struct hscopt_hho_params
+ * @brief Parâmetros específicos do HHO (::hscopt_solver_config::params).
+ */
+typedef struct hscopt_hho_params {
+  size_t n_agents;  // número de hawks
+} hscopt_hho_params;
+
+/**
+ * @struct hscopt_rvns_params
+ * @brief Parâmetros específicos do RVNS (::hscopt_solver_config::params).
+ */
+typedef struct hscopt_rvns_params {
+  size_t k_max;      // maior vizinhança
+  const double *x0;  // solução inicial (pode ser NULL)
+} hscopt_rvns_params;
+
+/**
+ * @struct hscopt_solver_vtable
+ * @brief Tabela de operações de um solver.
+ *
+ * Todas as funções recebem o ponteiro retornado por `create`.
+ */
+typedef struct hscopt_solver_vtable {
+  const char *name;
+
+  /** Cria o solver; retorna NULL em erro. */
+  void *(*create)(const hscopt_solver_config *cfg);
+  /** Libera o solver. */
+  void (*destroy)(void *solver);
+  /** Executa iterações; 0 em sucesso (mesmos códigos do algoritmo). */
+  int (*iterate)(void *solver, unsigned iters);
+  /** Melhor fitness encontrado. */
+  double (*best_fitness)(const void *solver);
+  /** Chaves da melhor solução (válidas até a próxima chamada mutável). */
+  const double *(*best_keys)(const void *solver);
+  /** Iteração atual. */
+  unsigned (*iteration)(const void *solver);
+  /** Oferece uma solução externa: 1 se aceita, 0 se não, < 0 em erro. */
+  int (*inject)(void *solver, const double *keys);
+  /**
+   * Reaproveita o solver para @p cfg, sem realocar se couber (NULL = não
+   * suportado). 0 em sucesso; em erro o solver continua válido. Threads e
+   * alocador são os da criação: um @p cfg com outro `max_threads` falha.
+   */
+  int (*reconfigure)(void *solver, const hscopt_solver_config *cfg);
+} hscopt_solver_vtable;
+
+/**
+ * @brief Vtable do HHO (params: ::hscopt_hho_params).
+ */
+extern const hscopt_solver_vtable hscopt_hho_solver;
+
+/**
+ * @brief Vtable do RVNS (params: ::hscopt_rvns_params).
+ */
+extern const hscopt_solver_vtable hscopt_rvns_solver;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_SOLVER_H */
@@ -0,0 +1,228 @@
+#ifndef HSCOPT_SURROGATE_H
+#define HSCOPT_SURROGATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hscopt/alloc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file surrogate.h
+ * @brief Modelo substituto (k vizinhos mais próximos) para triagem de
+ * candidatos antes do decoder.
+ *
+ * Nos mergulhos do HHO e nas vizinhanças do RVNS, a maior parte dos
+ * candidatos avaliados é rejeitada. Com decoders caros, o modelo evita parte
+ * dessas avaliações: guarda os pares (chaves, objetivo) avaliados mais
+ * recentemente em um arquivo limitado (anel) e estima o objetivo de um
+ * candidato pela média dos k vizinhos mais próximos, ponderada pelo inverso
+ * da distância. Só vão ao decoder os candidatos cuja estimativa fica abaixo
+ * do limiar de aceitação.
+ *
+ * Para medir a qualidade da triagem, uma a cada `audit` rejeições é avaliada
+ * mesmo assim (auditoria); ::hscopt_surrogate_stats e
+ * hscopt_surrogate_accuracy() resumem os acertos.
+ *
+ * Uso com os solvers:
+ * @code
+ * hscopt_surrogate *s = hscopt_surrogate_create(dim, 512, 8);
+ * hscopt_hho_set_surrogate(hho, s);  // ou hscopt_rvns_set_surrogate()
+ * hscopt_hho_iterate(hho, 500);
+ * printf("acurácia: %.3f\n", hscopt_surrogate_accuracy(s));
+ * hscopt_hho_destroy(hho);
+ * hscopt_surrogate_destroy(s);
+ * @endcode
+ *
+ * @note O modelo não é thread-safe, exceto hscopt_surrogate_predict(). Um
+ * modelo deve ser usado por um solver de cada vez.
+ */
+
+/**
+ * @brief Modelo opaco (arquivo e estatísticas).
+ */
+typedef struct hscopt_surrogate hscopt_surrogate;
+
+/**
+ * @enum hscopt_surrogate_verdict
+ * @brief Decisão da triagem de um candidato.
+ */
+typedef enum hscopt_surrogate_verdict {
+  HSCOPT_SURROGATE_SKIP = 0,   // descartado sem avaliação
+  HSCOPT_SURROGATE_EVAL = 1,   // promissor: avaliar
+  HSCOPT_SURROGATE_AUDIT = 2,  // descartado, mas avaliado por amostragem
+} hscopt_surrogate_verdict;
+
+/**
+ * @struct hscopt_surrogate_stats
+ * @brief Contadores da triagem desde a criação ou o último reset.
+ */
+typedef struct hscopt_surrogate_stats {
+  uint64_t queries;       // candidatos triados
+  uint64_t passed;        // enviados ao decoder como promissores
+  uint64_t pass_hits;     // promissores que de fato ficaram abaixo do limiar
+  uint64_t rejected;      // descartados pelo modelo (inclui auditados)
+  uint64_t audits;        // descartados avaliados mesmo assim
+  uint64_t audit_misses;  // auditados que ficaram abaixo do limiar
+} hscopt_surrogate_stats;
+
+/**
+ * @brief Cria um modelo.
+ *
+ * @param dim Número de chaves.
+ * @param capacity Pontos no arquivo (0 = 256); os mais antigos são
+ * substituídos.
+ * @param k Vizinhos usados na estimativa (0 = 8; no máximo 64).
+ * @return Modelo, ou NULL em erro.
+ */
+hscopt_surrogate *hscopt_surrogate_create(size_t dim, size_t capacity,
+                                          size_t k);
+
+/**
+ * @brief Cria um modelo com alocador customizado.
+ *
+ * Se @p alloc for NULL, usa o alocador global.
+ *
+ * @param alloc Alocador customizado (opcional).
+ * @return Modelo, ou NULL em erro.
+ */
+hscopt_surrogate *hscopt_surrogate_create_with_allocator(
+    size_t dim, size_t capacity, size_t k, const hscopt_allocator *alloc);
+
+/**
+ * @brief Libera o modelo.
+ *
+ * @param s Modelo.
+ */
+void hscopt_surrogate_destroy(hscopt_surrogate *s);
+
+/**
+ * @brief Acrescenta um ponto avaliado ao arquivo.
+ *
+ * Objetivos não finitos e pontos já presentes no arquivo são ignorados.
+ *
+ * @param s Modelo.
+ * @param keys Chaves [dim].
+ * @param fitness Objetivo real.
+ */
+void hscopt_surrogate_add(hscopt_surrogate *s, const double *keys,
+                          double fitness);
+
+/**
+ * @brief Estima o objetivo de @p keys.
+ *
+ * @param s Modelo.
+ * @param keys Chaves [dim].
+ * @param spread Saída opcional: desvio padrão ponderado dos objetivos dos
+ * vizinhos em torno da estimativa (0 para um ponto do arquivo).
+ * @return Estimativa, ou NAN se o arquivo estiver vazio.
+ */
+double hscopt_surrogate_predict(const hscopt_surrogate *s, const double *keys,
+                                double *spread);
+
+/**
+ * @brief Decide se @p keys deve ir ao decoder.
+ *
+ * O candidato é promissor se o limite inferior `estimativa - kappa * spread`
+ * for menor que @p threshold, ou se o arquivo ainda tiver menos de k pontos.
+ *
+ * @param s Modelo.
+ * @param keys Chaves [dim].
+ * @param threshold Limiar de aceitação (ex.: objetivo atual).
+ * @return Decisão. Para ::HSCOPT_SURROGATE_EVAL e ::HSCOPT_SURROGATE_AUDIT,
+ * avalie e chame hscopt_surrogate_record().
+ */
+hscopt_surrogate_verdict hscopt_surrogate_screen(hscopt_surrogate *s,
+                                                 const double *keys,
+                                                 double threshold);
+
+/**
+ * @brief Registra a avaliação real de um candidato triado.
+ *
+ * Atualiza as estatísticas e acrescenta o ponto ao arquivo.
+ *
+ * @param s Modelo.
+ * @param keys Chaves [dim], ou NULL para só atualizar as estatísticas (ex.:
+ * objetivo limitado por corte, que não é exato).
+ * @param fitness Objetivo real.
+ * @param threshold Limiar usado em hscopt_surrogate_screen().
+ * @param v Decisão retornada por hscopt_surrogate_screen().
+ */
+void hscopt_surrogate_record(hscopt_surrogate *s, const double *keys,
+                             double fitness, double threshold,
+                             hscopt_surrogate_verdict v);
+
+/**
+ * @brief Define a amostragem de auditoria.
+ *
+ * @param s Modelo.
+ * @param period Avalia uma a cada @p period rejeições (0 = nunca; default
+ * 16).
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ */
+int hscopt_surrogate_set_audit(hscopt_surrogate *s, unsigned period);
+
+/**
+ * @brief Define o peso da dispersão no limite inferior da triagem.
+ *
+ * Valores maiores deixam passar mais candidatos incertos (menos descartes
+ * errados, mais avaliações); 0 usa só a estimativa.
+ *
+ * @param s Modelo.
+ * @param kappa Peso (>= 0; default 1).
+ * @return 0 em sucesso, 1 em argumentos inválidos.
+ */
+int hscopt_surrogate_set_kappa(hscopt_surrogate *s, double kappa);
+
+/**
+ * @brief Número de pontos no arquivo.
+ *
+ * @param s Modelo.
+ * @return Pontos no arquivo.
+ */
+size_t hscopt_surrogate_size(const hscopt_surrogate *s);
+
+/**
+ * @brief Número de chaves dos pontos do modelo.
+ *
+ * @param s Modelo.
+ * @return dim.
+ */
+size_t hscopt_surrogate_dim(const hscopt_surrogate *s);
+
+/**
+ * @brief Copia os contadores da triagem.
+ *
+ * @param s Modelo.
+ * @param out Saída.
+ */
+void hscopt_surrogate_get_stats(const hscopt_surrogate *s,
+                                hscopt_surrogate_stats *out);
+
+/**
+ * @brief Zera os contadores (o arquivo é mantido).
+ *
+ * @param s Modelo.
+ */
+void hscopt_surrogate_reset_stats(hscopt_surrogate *s);
+
+/**
+ * @brief Acurácia estimada da triagem.
+ *
+ * Acertos entre os promissores (`pass_hits`) mais os descartes corretos,
+ * estimados pela auditoria (`rejected * (1 - audit_misses / audits)`),
+ * divididos pelo total triado.
+ *
+ * @param s Modelo.
+ * @return Acurácia em [0,1], ou NAN sem triagens ou sem auditorias.
+ */
+double hscopt_surrogate_accuracy(const hscopt_surrogate *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HSCOPT_SURROGATE_H */
@@ -0,0 +1,186 @@
+#ifdef __linux__
+  #define _GNU_SOURCE
+#endif
+
+#include "hscopt/affinity.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hscopt/alloc.h"
+
+#ifdef __linux__
+  #include <sched.h>
+#endif
+
+// CPU da thread, se fixada por hscopt_affinity_pin_current (-1 = nenhuma).
+static _Thread_local int affinity_pinned = -1;
+
+#ifdef __linux__
+
+// Máscara da thread antes da primeira fixação (válida se affinity_pinned >= 0).
+static _Thread_local cpu_set_t affinity_saved;
+
+typedef struct affinity_cpu {
+  int cpu;
+  int package;
+  int core;
+  int smt;      // posição entre os irmãos SMT do mesmo núcleo
+  int key[3];   // chave de ordenação da política
+} affinity_cpu;
+
+static int affinity_read_topology(int cpu, const char *name) {
+  char path[128];
+  snprintf(path, sizeof(path),
+           "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+  FILE *f = fopen(path, "r");
+  if (!f) return 0;  // sem sysfs: trata como socket/núcleo únicos
+  int v = 0;
+  if (fscanf(f, "%d", &v) != 1) v = 0;
+  fclose(f);
+  return v;
+}
+
+static int affinity_cmp(const void *a, const void *b) {
+  const affinity_cpu *x = (const affinity_cpu *)a;
+  const affinity_cpu *y = (const affinity_cpu *)b;
+  for (int i = 0; i < 3; ++i) {
+    if (x->key[i] != y->key[i]) return x->key[i] < y->key[i] ? -1 : 1;
+  }
+  return (x->cpu > y->cpu) - (x->cpu < y->cpu);
+}
+
+static void affinity_set_keys(affinity_cpu *c, int k0, int k1, int k2) {
+  c->key[0] = k0;
+  c->key[1] = k1;
+  c->key[2] = k2;
+}
+
+int hscopt_affinity_plan(hscopt_affinity policy, unsigned n_threads,
+                         int *cpus) {
+  if (!cpus || n_threads == 0 || policy == HSCOPT_AFFINITY_NONE ||
+      policy > HSCOPT_AFFINITY_SMT_AWARE) {
+    return 1;
+  }
+
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return 2;
+  }
+  const int n_cpus = CPU_COUNT(&allowed);
+  if (n_cpus <= 0) {
+    return 2;
+  }
+
+  hscopt_allocator alloc;
+  hscopt_get_allocator(&alloc);
+  affinity_cpu *v = (affinity_cpu *)hscopt_calloc(&alloc, (size_t)n_cpus,
+                                                  sizeof(affinity_cpu));
+  if (!v) {
+    return 1;
+  }
+
+  int n = 0;
+  for (int cpu = 0; cpu < CPU_SETSIZE && n < n_cpus; ++cpu) {
+    if (!CPU_ISSET(cpu, &allowed)) continue;
+    v[n].cpu = cpu;
+    v[n].package = affinity_read_topology(cpu, "physical_package_id");
+    v[n].core = affinity_read_topology(cpu, "core_id");
+    ++n;
+  }
+
+  // Posição SMT: quantos irmãos do mesmo núcleo têm índice de CPU menor.
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < i; ++j) {
+      if (v[j].package == v[i].package && v[j].core == v[i].core) {
+        ++v[i].smt;
+      }
+    }
+  }
+
+  if (policy == HSCOPT_AFFINITY_SCATTER) {
+    // Posição dentro do socket (núcleos físicos antes dos irmãos SMT); as
+    // threads consecutivas alternam de socket.
+    for (int i = 0; i < n; ++i) {
+      affinity_set_keys(&v[i], v[i].package, v[i].smt, v[i].core);
+    }
+    qsort(v, (size_t)n, sizeof(*v), affinity_cmp);
+    int rank = 0;
+    for (int i = 0; i < n; ++i) {
+      rank = (i > 0 && v[i].package == v[i - 1].package ? rank + 1 : 0);
+      affinity_set_keys(&v[i], rank, v[i].package, 0);
+    }
+  } else if (policy == HSCOPT_AFFINITY_SMT_AWARE) {
+    for (int i = 0; i < n; ++i) {
+      affinity_set_keys(&v[i], v[i].smt, v[i].package, v[i].core);
+    }
+  } else {
+    for (int i = 0; i < n; ++i) {
+      affinity_set_keys(&v[i], v[i].package, v[i].core, v[i].smt);
+    }
+  }
+  qsort(v, (size_t)n, sizeof(*v), affinity_cmp);
+
+  for (unsigned t = 0; t < n_threads; ++t) {
+    cpus[t] = v[t % (unsigned)n].cpu;
+  }
+
+  hscopt_free(&alloc, v);
+  return 0;
+}
+
+int hscopt_affinity_pin_current(int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return 1;
+  }
+  if (affinity_pinned == cpu) {
+    return 0;
+  }
+  if (affinity_pinned < 0 &&
+      sched_getaffinity(0, sizeof(affinity_saved), &affinity_saved) != 0) {
+    return 1;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    return 1;
+  }
+  affinity_pinned = cpu;
+  return 0;
+}
+
+int hscopt_affinity_unpin_current(void) {
+  if (affinity_pinned < 0) {
+    return 0;
+  }
+  if (sched_setaffinity(0, sizeof(affinity_saved), &affinity_saved) != 0) {
+    return 1;
+  }
+  affinity_pinned = -1;
+  return 0;
+}
+
+#else /* !__linux__ */
+
+int hscopt_affinity_plan(hscopt_affinity policy, unsigned n_threads,
+                         int *cpus) {
+  if (!cpus || n_threads == 0 || policy == HSCOPT_AFFINITY_NONE ||
+      policy > HSCOPT_AFFINITY_SMT_AWARE) {
+    return 1;
+  }
+  return 2;
+}
+
+int hscopt_affinity_pin_current(int cpu) {
+  (void)cpu;
+  (void)affinity_pinned;
+  return 1;
+}
+
+int hscopt_affinity_unpin_current(void) { return 0; }
+
+#endif /* __linux__ */
@@ -0,0 +1,377 @@
+#include "hscopt/async.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define HSCOPT_ASYNC_POSIX 1
+  #include <poll.h>
+  #include <signal.h>
+  #include <sys/socket.h>
+  #include <sys/types.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+#define ASYNC_BATCH 64u         // resultados coletados por wait_any
+#define PIPE_DEFAULT_SLOTS 64u  // pendentes por processo
+
+#ifndef MSG_NOSIGNAL
+  #define MSG_NOSIGNAL 0
+#endif
+
+int hscopt_async_eval(const hscopt_async_decoder *ad,
+                      const double *const *rows, size_t n, size_t count,
+                      double *out) {
+  if (!ad || !ad->submit || !ad->wait_any || (!rows && count > 0) ||
+      (!out && count > 0)) {
+    return 1;
+  }
+
+  hscopt_async_result res[ASYNC_BATCH];
+  size_t next = 0, done = 0, pending = 0;
+
+  while (done < count) {
+    while (next < count &&
+           (ad->max_in_flight == 0 || pending < ad->max_in_flight)) {
+      const int rc = ad->submit(ad->self, rows[next], n, (uint64_t)next);
+      if (rc == 1) break;  // sem vaga: coleta antes de continuar
+      if (rc != 0) return 2;
+      ++next;
+      ++pending;
+    }
+    if (pending == 0) {
+      return 2;  // recusou tudo sem nada pendente
+    }
+
+    const int got = ad->wait_any(ad->self, res, ASYNC_BATCH);
+    if (got <= 0) {
+      return 2;
+    }
+    for (int r = 0; r < got; ++r) {
+      if (res[r].tag >= next) {
+        return 2;  // tag desconhecida
+      }
+      out[res[r].tag] = res[r].fitness;
+    }
+    pending -= (size_t)got;
+    done += (size_t)got;
+  }
+  return 0;
+}
+
+double hscopt_async_decode(const double *keys, size_t n,
+                           hscopt_decode_ctx *ctx) {
+  if (!ctx || !ctx->user) {
+    return INFINITY;
+  }
+  double f;
+  const double *rows[1] = {keys};
+  if (hscopt_async_eval((const hscopt_async_decoder *)ctx->user, rows, n, 1,
+                        &f) != 0) {
+    return INFINITY;
+  }
+  return f;
+}
+
+#ifdef HSCOPT_ASYNC_POSIX
+
+typedef struct pipe_worker {
+  pid_t pid;
+  int fd;            // socket (lado do pai)
+  size_t in_flight;  // pedidos sem resposta
+  unsigned char rx[sizeof(hscopt_async_result)];  // resposta parcial
+  size_t rx_len;
+} pipe_worker;
+
+struct hscopt_pipe_eval {
+  size_t n_keys;
+  size_t slots;
+  size_t req_bytes;  // tag + n_keys chaves
+  unsigned char *req;
+  unsigned n_procs;
+  pipe_worker *w;
+  struct pollfd *pfd;  // [n_procs], montado a cada poll
+  unsigned *map;       // pfd -> processo
+  hscopt_allocator alloc;
+};
+
+static int pipe_send_all(int fd, const void *buf, size_t len) {
+  const unsigned char *p = (const unsigned char *)buf;
+  while (len > 0) {
+    const ssize_t k = send(fd, p, len, MSG_NOSIGNAL);
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return 1;
+    }
+    p += k;
+    len -= (size_t)k;
+  }
+  return 0;
+}
+
+// Lê exatamente len bytes; 1 em EOF ou erro.
+static int pipe_recv_all(int fd, void *buf, size_t len) {
+  unsigned char *p = (unsigned char *)buf;
+  while (len > 0) {
+    const ssize_t k = recv(fd, p, len, 0);
+    if (k == 0) return 1;
+    if (k < 0) {
+      if (errno == EINTR) continue;
+      return 1;
+    }
+    p += k;
+    len -= (size_t)k;
+  }
+  return 0;
+}
+
+// Laço do processo filho: avalia até o pai fechar o socket.
+static void pipe_serve(int fd, size_t n_keys, size_t req_bytes,
+                       hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx) {
+  unsigned char *req = (unsigned char *)malloc(req_bytes);
+  double *keys = (double *)malloc(n_keys * sizeof(double));
+  if (!req || !keys) {
+    free(req);
+    free(keys);
+    return;
+  }
+
+  while (pipe_recv_all(fd, req, req_bytes) == 0) {
+    hscopt_async_result r;
+    memcpy(&r.tag, req, sizeof(r.tag));
+    memcpy(keys, req + sizeof(r.tag), n_keys * sizeof(double));
+    r.fitness = decoder(keys, n_keys, dctx);
+    if (pipe_send_all(fd, &r, sizeof(r)) != 0) break;
+  }
+  free(req);
+  free(keys);
+}
+
+static int pipe_submit(void *self, const double *keys, size_t n,
+                       uint64_t tag) {
+  hscopt_pipe_eval *const pe = (hscopt_pipe_eval *)self;
+  if (!keys || n != pe->n_keys) {
+    return 2;
+  }
+
+  pipe_worker *best = NULL;
+  for (unsigned k = 0; k < pe->n_procs; ++k) {
+    pipe_worker *const w = &pe->w[k];
+    if (w->in_flight < pe->slots &&
+        (!best || w->in_flight < best->in_flight)) {
+      best = w;
+    }
+  }
+  if (!best) {
+    return 1;
+  }
+
+  memcpy(pe->req, &tag, sizeof(tag));
+  memcpy(pe->req + sizeof(tag), keys, n * sizeof(double));
+  if (pipe_send_all(best->fd, pe->req, pe->req_bytes) != 0) {
+    return 2;
+  }
+  ++best->in_flight;
+  return 0;
+}
+
+// Coleta até max respostas; timeout em ms (-1 = bloqueia até a primeira).
+static int pipe_collect(hscopt_pipe_eval *pe, hscopt_async_result *out,
+                        size_t max, int timeout) {
+  struct pollfd *const pfd = pe->pfd;
+  unsigned *const map = pe->map;
+  size_t got = 0;
+
+  while (got < max) {
+    nfds_t nf = 0;
+    for (unsigned k = 0; k < pe->n_procs; ++k) {
+      if (pe->w[k].in_flight > 0) {
+        pfd[nf].fd = pe->w[k].fd;
+        pfd[nf].events = POLLIN;
+        pfd[nf].revents = 0;
+        map[nf++] = k;
+      }
+    }
+    if (nf == 0) break;
+
+    const int rc = poll(pfd, nf, got > 0 ? 0 : timeout);
+    if (rc < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (rc == 0) break;
+
+    for (nfds_t f = 0; f < nf && got < max; ++f) {
+      if (!(pfd[f].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      pipe_worker *const w = &pe->w[map[f]];
+      const ssize_t k = recv(w->fd, w->rx + w->rx_len,
+                             sizeof(w->rx) - w->rx_len, MSG_DONTWAIT);
+      if (k == 0) return -1;  // processo terminou com pedidos pendentes
+      if (k < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+          continue;
+        }
+        return -1;
+      }
+      w->rx_len += (size_t)k;
+      if (w->rx_len == sizeof(w->rx)) {
+        memcpy(&out[got++], w->rx, sizeof(w->rx));
+        w->rx_len = 0;
+        --w->in_flight;
+      }
+    }
+  }
+  return (int)got;
+}
+
+static int pipe_poll(void *self, hscopt_async_result *out, size_t max) {
+  return pipe_collect((hscopt_pipe_eval *)self, out, max, 0);
+}
+
+static int pipe_wait_any(void *self, hscopt_async_result *out, size_t max) {
+  return pipe_collect((hscopt_pipe_eval *)self, out, max, -1);
+}
+
+hscopt_pipe_eval *hscopt_pipe_eval_create(size_t n_keys, unsigned n_procs,
+                                          size_t slots,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx) {
+  return hscopt_pipe_eval_create_with_allocator(n_keys, n_procs, slots,
+                                                decoder, dctx, NULL);
+}
+
+hscopt_pipe_eval *hscopt_pipe_eval_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t slots, hscopt_decoder_fn decoder,
+    hscopt_decode_ctx *dctx, const hscopt_allocator *alloc) {
+  if (!decoder || n_keys == 0 || n_keys > (SIZE_MAX - 8u) / sizeof(double)) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_pipe_eval *pe =
+      (hscopt_pipe_eval *)hscopt_calloc(&resolved, 1, sizeof(*pe));
+  if (!pe) {
+    return NULL;
+  }
+  pe->alloc = resolved;
+  pe->n_keys = n_keys;
+  pe->slots = (slots == 0 ? PIPE_DEFAULT_SLOTS : slots);
+  pe->req_bytes = sizeof(uint64_t) + n_keys * sizeof(double);
+  pe->n_procs = 0;
+  pe->req = (unsigned char *)hscopt_alloc(&pe->alloc, pe->req_bytes);
+  const unsigned want = (n_procs == 0 ? 1u : n_procs);
+  pe->w = (pipe_worker *)hscopt_calloc(&pe->alloc, want, sizeof(pipe_worker));
+  pe->pfd = (struct pollfd *)hscopt_calloc(&pe->alloc, want,
+                                           sizeof(struct pollfd));
+  pe->map = (unsigned *)hscopt_calloc(&pe->alloc, want, sizeof(unsigned));
+  if (!pe->req || !pe->w || !pe->pfd || !pe->map) {
+    hscopt_pipe_eval_destroy(pe);
+    return NULL;
+  }
+
+  for (unsigned k = 0; k < want; ++k) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+      hscopt_pipe_eval_destroy(pe);
+      return NULL;
+    }
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+      close(sv[0]);
+      close(sv[1]);
+      hscopt_pipe_eval_destroy(pe);
+      return NULL;
+    }
+    if (pid == 0) {
+      // Filho: fecha os sockets dos demais processos e serve o seu.
+      for (unsigned j = 0; j < pe->n_procs; ++j) close(pe->w[j].fd);
+      close(sv[0]);
+      #ifdef SIGPIPE
+      signal(SIGPIPE, SIG_IGN);
+      #endif
+      pipe_serve(sv[1], n_keys, pe->req_bytes, decoder, dctx);
+      close(sv[1]);
+      _exit(0);
+    }
+
+    close(sv[1]);
+    pe->w[k].pid = pid;
+    pe->w[k].fd = sv[0];
+    pe->n_procs = k + 1u;
+  }
+  return pe;
+}
+
+void hscopt_pipe_eval_destroy(hscopt_pipe_eval *pe) {
+  if (!pe) return;
+  // Fechar o socket encerra o laço do filho (EOF).
+  for (unsigned k = 0; k < pe->n_procs; ++k) {
+    close(pe->w[k].fd);
+  }
+  for (unsigned k = 0; k < pe->n_procs; ++k) {
+    while (waitpid(pe->w[k].pid, NULL, 0) < 0 && errno == EINTR) {
+    }
+  }
+  hscopt_allocator alloc = pe->alloc;
+  hscopt_free(&alloc, pe->w);
+  hscopt_free(&alloc, pe->pfd);
+  hscopt_free(&alloc, pe->map);
+  hscopt_free(&alloc, pe->req);
+  hscopt_free(&alloc, pe);
+}
+
+void hscopt_pipe_eval_get(hscopt_pipe_eval *pe, hscopt_async_decoder *out) {
+  if (!pe || !out) return;
+  out->submit = pipe_submit;
+  out->poll = pipe_poll;
+  out->wait_any = pipe_wait_any;
+  out->max_in_flight = pe->slots * pe->n_procs;
+  out->self = pe;
+}
+
+#else /* !HSCOPT_ASYNC_POSIX */
+
+hscopt_pipe_eval *hscopt_pipe_eval_create(size_t n_keys, unsigned n_procs,
+                                          size_t slots,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx) {
+  (void)n_keys;
+  (void)n_procs;
+  (void)slots;
+  (void)decoder;
+  (void)dctx;
+  return NULL;
+}
+
+hscopt_pipe_eval *hscopt_pipe_eval_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t slots, hscopt_decoder_fn decoder,
+    hscopt_decode_ctx *dctx, const hscopt_allocator *alloc) {
+  (void)alloc;
+  return hscopt_pipe_eval_create(n_keys, n_procs, slots, decoder, dctx);
+}
+
+void hscopt_pipe_eval_destroy(hscopt_pipe_eval *pe) { (void)pe; }
+
+void hscopt_pipe_eval_get(hscopt_pipe_eval *pe, hscopt_async_decoder *out) {
+  (void)pe;
+  (void)out;
+}
+
+#endif /* HSCOPT_ASYNC_POSIX */
@@ -0,0 +1,272 @@
+#include "hscopt/batch.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/rng.h"
+#include "hscopt/solver.h"
+
+#define BATCH_CACHE 4u  // vtables distintas com solver guardado por thread
+#define BATCH_LINE 64u
+// Passo do seed entre jobs: cada job consome uma janela própria de quatro
+// saídas da sequência splitmix64 usada por hscopt_rng_seed().
+#define BATCH_SEED_STEP (UINT64_C(4) * UINT64_C(0x9E3779B97F4A7C15))
+
+// Faixa [lo, hi) de jobs em um inteiro de 64 bits.
+#define BATCH_PACK(lo, hi) (((uint64_t)(hi) << 32) | (uint64_t)(lo))
+#define BATCH_LO(r) ((uint32_t)(r))
+#define BATCH_HI(r) ((uint32_t)((r) >> 32))
+
+typedef struct batch_run batch_run;
+
+typedef struct batch_worker {
+  _Alignas(BATCH_LINE) _Atomic uint64_t range;  // jobs ainda da thread
+
+  batch_run *run;
+  unsigned id;
+  const hscopt_solver_vtable *vt[BATCH_CACHE];  // solvers guardados
+  void *solver[BATCH_CACHE];
+  unsigned evict;  // próximo slot a substituir com o cache cheio
+  hscopt_batch_stats stats;
+
+  thrd_t thread;
+  int joinable;
+} batch_worker;
+
+struct batch_run {
+  const hscopt_batch_job *jobs;
+  unsigned n_workers;
+  batch_worker *workers;
+  uint64_t seed;
+  hscopt_batch_done_fn on_done;
+  void *user;
+};
+
+void hscopt_batch_opts_default(hscopt_batch_opts *out) {
+  if (!out) return;
+  out->threads = 1u;
+  out->seed = 0u;
+  out->on_done = NULL;
+  out->user = NULL;
+}
+
+// Consome o primeiro job da própria faixa.
+static int batch_pop(batch_worker *w, size_t *job) {
+  uint64_t r = atomic_load_explicit(&w->range, memory_order_acquire);
+  for (;;) {
+    const uint32_t lo = BATCH_LO(r), hi = BATCH_HI(r);
+    if (lo >= hi) {
+      return 0;
+    }
+    if (atomic_compare_exchange_weak_explicit(
+            &w->range, &r, BATCH_PACK(lo + 1u, hi), memory_order_acq_rel,
+            memory_order_acquire)) {
+      *job = lo;
+      return 1;
+    }
+  }
+}
+
+// Rouba a metade final da faixa de outra thread e a adota como própria.
+// Retorna 0 se todas as faixas estiverem vazias.
+static int batch_steal(batch_worker *w) {
+  batch_run *const run = w->run;
+  for (unsigned d = 1; d < run->n_workers; ++d) {
+    batch_worker *const v = &run->workers[(w->id + d) % run->n_workers];
+    uint64_t r = atomic_load_explicit(&v->range, memory_order_acquire);
+    for (;;) {
+      const uint32_t lo = BATCH_LO(r), hi = BATCH_HI(r);
+      if (lo >= hi) {
+        break;
+      }
+      const uint32_t mid = lo + (hi - lo) / 2u;
+      if (atomic_compare_exchange_weak_explicit(
+              &v->range, &r, BATCH_PACK(lo, mid), memory_order_acq_rel,
+              memory_order_acquire)) {
+        // A própria faixa está vazia: ninguém mais a altera.
+        atomic_store_explicit(&w->range, BATCH_PACK(mid, hi),
+                              memory_order_release);
+        ++w->stats.steals;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// Slot do cache para vt: o já existente ou um livre (ou o próximo a
+// substituir, cujo solver é destruído).
+static size_t batch_slot(batch_worker *w, const hscopt_solver_vtable *vt) {
+  for (size_t k = 0; k < BATCH_CACHE; ++k) {
+    if (w->vt[k] == vt) return k;
+  }
+  for (size_t k = 0; k < BATCH_CACHE; ++k) {
+    if (!w->vt[k]) {
+      w->vt[k] = vt;
+      return k;
+    }
+  }
+  const size_t k = w->evict;
+  w->evict = (w->evict + 1u) % BATCH_CACHE;
+  w->vt[k]->destroy(w->solver[k]);
+  w->vt[k] = vt;
+  w->solver[k] = NULL;
+  return k;
+}
+
+static void batch_run_job(batch_worker *w, size_t i) {
+  batch_run *const run = w->run;
+  const hscopt_batch_job *const job = &run->jobs[i];
+
+  hscopt_rng rng;
+  hscopt_rng_seed(&rng, run->seed + (uint64_t)i * BATCH_SEED_STEP);
+  hscopt_solver_config cfg = job->cfg;
+  cfg.max_threads = 1u;
+  cfg.rng = &rng;
+
+  const size_t k = batch_slot(w, job->vt);
+  void *s = w->solver[k];
+  if (s) {
+    if (job->vt->reconfigure && job->vt->reconfigure(s, &cfg) == 0) {
+      ++w->stats.reuses;
+    } else {
+      job->vt->destroy(s);
+      s = NULL;
+    }
+  }
+  if (!s) {
+    s = job->vt->create(&cfg);
+    if (s) ++w->stats.creates;
+  }
+  w->solver[k] = s;
+
+  hscopt_batch_result res = {
+      .job = i,
+      .user = job->user,
+      .status = -1,
+      .best_fitness = INFINITY,
+      .best_keys = NULL,
+      .iterations = 0u,
+  };
+  if (s) {
+    res.status = job->vt->iterate(s, cfg.max_iters);
+    res.best_fitness = job->vt->best_fitness(s);
+    res.best_keys = job->vt->best_keys(s);
+    res.iterations = job->vt->iteration(s);
+  }
+  if (res.status != 0) {
+    ++w->stats.failed;
+  }
+  if (run->on_done) {
+    run->on_done(&res, run->user);
+  }
+}
+
+static int batch_worker_main(void *arg) {
+  batch_worker *const w = (batch_worker *)arg;
+  size_t i;
+  do {
+    while (batch_pop(w, &i)) {
+      batch_run_job(w, i);
+    }
+  } while (batch_steal(w));
+
+  for (size_t k = 0; k < BATCH_CACHE; ++k) {
+    if (w->vt[k] && w->solver[k]) w->vt[k]->destroy(w->solver[k]);
+  }
+  return 0;
+}
+
+int hscopt_batch_solve(const hscopt_batch_job *jobs, size_t n,
+                       const hscopt_batch_opts *opts,
+                       hscopt_batch_stats *stats) {
+  if (stats) {
+    memset(stats, 0, sizeof(*stats));
+  }
+  if (!jobs || n == 0 || n >= UINT32_MAX) {
+    return 1;
+  }
+  hscopt_batch_opts o;
+  hscopt_batch_opts_default(&o);
+  if (opts) {
+    o = *opts;
+  }
+  if (o.threads == 0) {
+    return 1;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    const hscopt_solver_vtable *const vt = jobs[i].vt;
+    if (!vt || !vt->create || !vt->destroy || !vt->iterate ||
+        !vt->best_fitness || !vt->best_keys || !vt->iteration) {
+      return 1;
+    }
+  }
+
+  const unsigned nw = (o.threads < n ? o.threads : (unsigned)n);
+  hscopt_allocator alloc;
+  hscopt_get_allocator(&alloc);
+  // Uma linha de cache por thread: o alocador não garante o alinhamento.
+  void *raw = hscopt_alloc(&alloc, nw * sizeof(batch_worker) + BATCH_LINE);
+  if (!raw) {
+    return 4;
+  }
+  batch_worker *const workers =
+      (batch_worker *)(((uintptr_t)raw + BATCH_LINE - 1u) &
+                       ~(uintptr_t)(BATCH_LINE - 1u));
+  memset(workers, 0, nw * sizeof(batch_worker));
+
+  batch_run run = {
+      .jobs = jobs,
+      .n_workers = nw,
+      .workers = workers,
+      .seed = o.seed,
+      .on_done = o.on_done,
+      .user = o.user,
+  };
+  const size_t q = n / nw, rem = n % nw;
+  size_t lo = 0;
+  for (unsigned t = 0; t < nw; ++t) {
+    const size_t hi = lo + q + (t < rem ? 1u : 0u);
+    workers[t].run = &run;
+    workers[t].id = t;
+    atomic_init(&workers[t].range, BATCH_PACK(lo, hi));
+    lo = hi;
+  }
+
+  // A chamadora é a thread 0.
+  int rc = 0;
+  for (unsigned t = 1; t < nw; ++t) {
+    if (thrd_create(&workers[t].thread, batch_worker_main, &workers[t]) ==
+        thrd_success) {
+      workers[t].joinable = 1;
+    } else {
+      rc = 3;
+    }
+  }
+  batch_worker_main(&workers[0]);
+
+  hscopt_batch_stats total = {0};
+  for (unsigned t = 0; t < nw; ++t) {
+    if (workers[t].joinable) {
+      thrd_join(workers[t].thread, NULL);
+    }
+    total.failed += workers[t].stats.failed;
+    total.steals += workers[t].stats.steals;
+    total.reuses += workers[t].stats.reuses;
+    total.creates += workers[t].stats.creates;
+  }
+  hscopt_free(&alloc, raw);
+
+  if (stats) {
+    *stats = total;
+  }
+  if (rc == 0 && total.failed > 0) {
+    rc = 2;
+  }
+  return rc;
+}
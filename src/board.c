@@ -0,0 +1,171 @@
+#include "hscopt/board.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+
+#define BOARD_LINE 64u
+
+// Buffer de chaves com seqlock: seq é ímpar durante a escrita.
+typedef struct board_slot {
+  _Alignas(BOARD_LINE) _Atomic uint64_t seq;
+  double fitness;
+  double *keys;  // [dim]
+} board_slot;
+
+struct hscopt_board {
+  _Alignas(BOARD_LINE) _Atomic uint64_t version;  // ativo = version & 1
+  _Atomic double fitness;                         // fitness publicado
+
+  _Alignas(BOARD_LINE) _Atomic uint32_t writer;  // 1 durante uma publicação
+  _Atomic double pending;  // fitness da publicação em andamento
+
+  board_slot slot[2];
+  size_t dim;
+  hscopt_allocator alloc;
+  void *raw;  // bloco alocado (a estrutura fica alinhada dentro dele)
+};
+
+hscopt_board *hscopt_board_create(size_t dim) {
+  return hscopt_board_create_with_allocator(dim, NULL);
+}
+
+hscopt_board *hscopt_board_create_with_allocator(
+    size_t dim, const hscopt_allocator *alloc) {
+  if (dim == 0 || dim > SIZE_MAX / sizeof(double)) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  // O alocador não garante o alinhamento de linha de cache da estrutura.
+  void *raw = hscopt_alloc(&resolved, sizeof(hscopt_board) + BOARD_LINE);
+  if (!raw) {
+    return NULL;
+  }
+  hscopt_board *b = (hscopt_board *)(((uintptr_t)raw + BOARD_LINE - 1u) &
+                                     ~(uintptr_t)(BOARD_LINE - 1u));
+  memset(b, 0, sizeof(*b));
+  b->raw = raw;
+  b->alloc = resolved;
+  b->dim = dim;
+  atomic_init(&b->version, 0u);
+  atomic_init(&b->fitness, INFINITY);
+  atomic_init(&b->writer, 0u);
+  atomic_init(&b->pending, INFINITY);
+  for (int s = 0; s < 2; ++s) {
+    atomic_init(&b->slot[s].seq, 0u);
+    b->slot[s].fitness = INFINITY;
+    b->slot[s].keys = (double *)hscopt_alloc(&b->alloc, dim * sizeof(double));
+    if (!b->slot[s].keys) {
+      hscopt_board_destroy(b);
+      return NULL;
+    }
+  }
+  return b;
+}
+
+void hscopt_board_destroy(hscopt_board *b) {
+  if (!b) return;
+  hscopt_allocator alloc = b->alloc;
+  hscopt_free(&alloc, b->slot[0].keys);
+  hscopt_free(&alloc, b->slot[1].keys);
+  hscopt_free(&alloc, b->raw);
+}
+
+size_t hscopt_board_dim(const hscopt_board *b) {
+  return b ? b->dim : 0u;
+}
+
+int hscopt_board_offer(hscopt_board *b, const double *keys, double fitness) {
+  if (!b || !keys || isnan(fitness)) {
+    return -1;
+  }
+  if (!(fitness < atomic_load_explicit(&b->fitness, memory_order_relaxed))) {
+    return 0;
+  }
+
+  uint32_t idle = 0u;
+  if (!atomic_compare_exchange_strong_explicit(&b->writer, &idle, 1u,
+                                               memory_order_acquire,
+                                               memory_order_relaxed)) {
+    // Os valores de pending só diminuem: um pending antigo nunca descarta
+    // uma oferta melhor.
+    const double p = atomic_load_explicit(&b->pending, memory_order_relaxed);
+    return fitness < p ? -2 : 0;
+  }
+  atomic_store_explicit(&b->pending, fitness, memory_order_relaxed);
+
+  int rc = 0;
+  if (fitness < atomic_load_explicit(&b->fitness, memory_order_relaxed)) {
+    // Escreve no buffer inativo; os leitores do ativo não são afetados.
+    const uint64_t v = atomic_load_explicit(&b->version, memory_order_relaxed);
+    board_slot *const s = &b->slot[(v + 1u) & 1u];
+    const uint64_t q = atomic_load_explicit(&s->seq, memory_order_relaxed);
+    atomic_store_explicit(&s->seq, q + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(s->keys, keys, b->dim * sizeof(double));
+    s->fitness = fitness;
+    atomic_store_explicit(&s->seq, q + 2u, memory_order_release);
+
+    atomic_store_explicit(&b->fitness, fitness, memory_order_relaxed);
+    atomic_store_explicit(&b->version, v + 1u, memory_order_release);
+    rc = 1;
+  }
+  atomic_store_explicit(&b->writer, 0u, memory_order_release);
+  return rc;
+}
+
+int hscopt_board_read(const hscopt_board *b, double *keys, double *fitness,
+                      uint64_t *version) {
+  if (!b || !keys) {
+    return 1;
+  }
+  hscopt_board *const w = (hscopt_board *)b;  // só leituras atômicas
+
+  for (;;) {
+    const uint64_t v = atomic_load_explicit(&w->version, memory_order_acquire);
+    if (v == 0u) {
+      if (fitness) *fitness = INFINITY;
+      if (version) *version = 0u;
+      return 0;
+    }
+    board_slot *const s = &w->slot[v & 1u];
+    const uint64_t q = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (q & 1u) {
+      continue;  // duas publicações depois de v: o buffer está sendo reescrito
+    }
+    memcpy(keys, s->keys, b->dim * sizeof(double));
+    const double f = s->fitness;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&s->seq, memory_order_relaxed) == q) {
+      if (fitness) *fitness = f;
+      if (version) *version = v;
+      return 0;
+    }
+  }
+}
+
+double hscopt_board_fitness(const hscopt_board *b) {
+  if (!b) return INFINITY;
+  return atomic_load_explicit(&((hscopt_board *)b)->fitness,
+                              memory_order_relaxed);
+}
+
+uint64_t hscopt_board_version(const hscopt_board *b) {
+  if (!b) return 0u;
+  return atomic_load_explicit(&((hscopt_board *)b)->version,
+                              memory_order_acquire);
+}
@@ -1,120 +1,246 @@
 #include "hscopt/hho.h"
+#include "hscopt/hho_impl.h"
 
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "hscopt/affinity.h"
 #include "hscopt/alloc.h"
 #include "hscopt/defs.h"
 #include "hscopt/rng.h"
+#include "hscopt/solver.h"
 
 #ifdef _OPENMP
   #include <omp.h>
 #endif
 
-#define HAWK_PTR(ctx, agent) (&(ctx)->X[(agent) * (ctx)->dim])
-#define HHO_E1(t, T) (2.0 * (1.0 - ((double)(t) / (double)(T))))
-#define HHO_E0(u01) (2.0 * (u01)-1.0)
+#define HHO_INIT_ITER UINT64_MAX  // "iteração" dos sorteios da população
+#define HHO_Y(ctx, i, w) (&(ctx)->async_y[(2u * (i) + (w)) * (ctx)->dim])
+#define HHO_Y1(ctx, i) HHO_Y(ctx, i, 0u)
+#define HHO_Y2(ctx, i) HHO_Y(ctx, i, 1u)
 
-struct hscopt_hho_ctx {
-  size_t dim;
-  size_t n_agents;
-
-  unsigned iter;
-  unsigned max_iters;
-  unsigned max_threads;
-  unsigned eff_threads;
-
-  hscopt_decoder_fn decoder;
-  hscopt_decode_ctx *dctx;
-  hscopt_rng *rng;
+static hscopt_hho_kernel_fn hho_select_kernel(size_t dim);
 
+// Buffers dimensionados pela capacidade (cap_dim, cap_agents) do contexto.
+typedef struct hho_buffers {
   double *X;
   double *fitness;
-
-  double rabbit_fitness;
+  unsigned char *row_state;
   double *rabbit_keys;
-
   double *mean_pos;
+  double *sum;
+  double *sumsq;
   double *tmp1;
   double *tmp2;
   double *levy;
+  unsigned char *surr_v;      // só com modelo substituto
+  double *blk_old;            // só no modo por blocos
+  hscopt_decode_ctx *blk_dctx;
+  hscopt_keys_delta *blk_delta;
+  double *async_y;            // só com avaliador assíncrono
+  const double **async_rows;
+  size_t *async_idx;
+  double *async_fit;
+} hho_buffers;
+
+static void hho_async_bufs_free(const hscopt_allocator *a, hho_buffers *b) {
+  hscopt_free(a, b->async_y);
+  hscopt_free(a, b->async_rows);
+  hscopt_free(a, b->async_idx);
+  hscopt_free(a, b->async_fit);
+  b->async_y = NULL;
+  b->async_rows = NULL;
+  b->async_idx = NULL;
+  b->async_fit = NULL;
+}
 
-  struct {
-    int has_spare;
-    double spare;
-  } gauss;
-
-  double levy_sigma;
+// Buffers do modo assíncrono para cd chaves e ca agentes; 1 em falta de
+// memória (nada fica alocado).
+static int hho_async_bufs_alloc(const hscopt_allocator *a, size_t cd,
+                                size_t ca, hho_buffers *b) {
+  b->async_y = (double *)hscopt_alloc(a, 2u * ca * cd * sizeof(double));
+  b->async_rows = (const double **)hscopt_alloc(a, ca * sizeof(double *));
+  b->async_idx = (size_t *)hscopt_alloc(a, ca * sizeof(size_t));
+  b->async_fit = (double *)hscopt_alloc(a, ca * sizeof(double));
+  if (!b->async_y || !b->async_rows || !b->async_idx || !b->async_fit) {
+    hho_async_bufs_free(a, b);
+    return 1;
+  }
+  return 0;
+}
 
-  hscopt_allocator alloc;
-};
+static void hho_block_bufs_free(const hscopt_allocator *a, hho_buffers *b) {
+  hscopt_free(a, b->blk_old);
+  hscopt_free(a, b->blk_dctx);
+  hscopt_free(a, b->blk_delta);
+  b->blk_old = NULL;
+  b->blk_dctx = NULL;
+  b->blk_delta = NULL;
+}
 
-HSCOPT_INLINE double hho_randn(hscopt_rng *rng, hscopt_hho_ctx *ctx) {
-  if (ctx->gauss.has_spare) {
-    ctx->gauss.has_spare = 0;
-    return ctx->gauss.spare;
+// Buffers do modo por blocos para ca agentes e blocos de bs chaves; 1 em
+// falta de memória (nada fica alocado). Os dctx começam sem diferença.
+static int hho_block_bufs_alloc(const hscopt_allocator *a, size_t ca,
+                                size_t bs, hho_buffers *b) {
+  if (bs > SIZE_MAX / sizeof(double) / ca) {
+    return 1;
   }
-
-  double u1 = hscopt_rng_next_u01(rng);
-  if (u1 <= 0.0) {
-    u1 = 1e-12;
+  b->blk_old = (double *)hscopt_alloc(a, ca * bs * sizeof(double));
+  b->blk_dctx =
+      (hscopt_decode_ctx *)hscopt_calloc(a, ca, sizeof(hscopt_decode_ctx));
+  b->blk_delta =
+      (hscopt_keys_delta *)hscopt_alloc(a, ca * sizeof(hscopt_keys_delta));
+  if (!b->blk_old || !b->blk_dctx || !b->blk_delta) {
+    hho_block_bufs_free(a, b);
+    return 1;
   }
+  return 0;
+}
 
-  const double u2 = hscopt_rng_next_u01(rng);
-  const double r = sqrt(-2.0 * log(u1));
-  const double theta = 2.0 * HSCOPT_PI * u2;
-
-  ctx->gauss.spare = r * sin(theta);
-  ctx->gauss.has_spare = 1;
-  return r * cos(theta);
+static void hho_buffers_free(const hscopt_allocator *a, hho_buffers *b) {
+  hscopt_free(a, b->X);
+  hscopt_free(a, b->fitness);
+  hscopt_free(a, b->row_state);
+  hscopt_free(a, b->rabbit_keys);
+  hscopt_free(a, b->mean_pos);
+  hscopt_free(a, b->sum);
+  hscopt_free(a, b->sumsq);
+  hscopt_free(a, b->tmp1);
+  hscopt_free(a, b->tmp2);
+  hscopt_free(a, b->levy);
+  hscopt_free(a, b->surr_v);
+  hho_block_bufs_free(a, b);
+  hho_async_bufs_free(a, b);
 }
 
-HSCOPT_INLINE void hho_levy(hscopt_hho_ctx *ctx) {
-  const double inv_beta = 1.0 / 1.5;
-  for (size_t j = 0; j < ctx->dim; ++j) {
-    const double u = 0.01 * hho_randn(ctx->rng, ctx) * ctx->levy_sigma;
-    double v = hho_randn(ctx->rng, ctx);
-    const double av = fabs(v);
-    if (av < 1e-12) {
-      v = (v < 0.0 ? -1e-12 : 1e-12);
-    }
-    ctx->levy[j] = u / pow(fabs(v), inv_beta);
-  }
+// Troca os buffers de ctx pelos de b (b fica com os anteriores).
+static void hho_buffers_swap(hscopt_hho_ctx *ctx, hho_buffers *b) {
+  const hho_buffers old = {
+      .X = ctx->X,
+      .fitness = ctx->fitness,
+      .row_state = ctx->row_state,
+      .rabbit_keys = ctx->rabbit_keys,
+      .mean_pos = ctx->mean_pos,
+      .sum = ctx->sum,
+      .sumsq = ctx->sumsq,
+      .tmp1 = ctx->tmp1,
+      .tmp2 = ctx->tmp2,
+      .levy = ctx->levy,
+      .surr_v = ctx->surr_v,
+      .blk_old = ctx->blk_old,
+      .blk_dctx = ctx->blk_dctx,
+      .blk_delta = ctx->blk_delta,
+      .async_y = ctx->async_y,
+      .async_rows = ctx->async_rows,
+      .async_idx = ctx->async_idx,
+      .async_fit = ctx->async_fit,
+  };
+  ctx->X = b->X;
+  ctx->fitness = b->fitness;
+  ctx->row_state = b->row_state;
+  ctx->rabbit_keys = b->rabbit_keys;
+  ctx->mean_pos = b->mean_pos;
+  ctx->sum = b->sum;
+  ctx->sumsq = b->sumsq;
+  ctx->tmp1 = b->tmp1;
+  ctx->tmp2 = b->tmp2;
+  ctx->levy = b->levy;
+  ctx->surr_v = b->surr_v;
+  ctx->blk_old = b->blk_old;
+  ctx->blk_dctx = b->blk_dctx;
+  ctx->blk_delta = b->blk_delta;
+  ctx->async_y = b->async_y;
+  ctx->async_rows = b->async_rows;
+  ctx->async_idx = b->async_idx;
+  ctx->async_fit = b->async_fit;
+  *b = old;
 }
 
-HSCOPT_INLINE void hho_eval_all_and_update_rabbit(hscopt_hho_ctx *ctx) {
-#ifdef _OPENMP
-  #pragma omp parallel for num_threads(ctx->eff_threads) schedule(static)
-#endif
-  for (ptrdiff_t i = 0; i < (ptrdiff_t)ctx->n_agents; ++i) {
-    double *const x = HAWK_PTR(ctx, (size_t)i);
-    ctx->fitness[(size_t)i] = ctx->decoder(x, ctx->dim, ctx->dctx);
+// Garante capacidade para dim chaves e n_agents agentes. Só realoca se
+// alguma das duas crescer; o conteúdo não é preservado (o chamador faz o
+// reset). Em falta de memória, mantém os buffers atuais e retorna 1.
+static int hho_reserve(hscopt_hho_ctx *ctx, size_t dim, size_t n_agents) {
+  if (dim <= ctx->cap_dim && n_agents <= ctx->cap_agents) {
+    return 0;
+  }
+  const size_t cd = (dim > ctx->cap_dim ? dim : ctx->cap_dim);
+  const size_t ca = (n_agents > ctx->cap_agents ? n_agents : ctx->cap_agents);
+  if (cd > SIZE_MAX / sizeof(double) / 2u / ca) {
+    return 1;
   }
 
-  for (size_t i = 0; i < ctx->n_agents; ++i) {
-    if (ctx->fitness[i] < ctx->rabbit_fitness) {
-      ctx->rabbit_fitness = ctx->fitness[i];
-      memcpy(ctx->rabbit_keys, HAWK_PTR(ctx, i), ctx->dim * sizeof(double));
-    }
+  const hscopt_allocator *const a = &ctx->alloc;
+  hho_buffers b = {0};
+  b.X = (double *)hscopt_alloc(a, sizeof(double) * (cd * ca));
+  b.fitness = (double *)hscopt_alloc(a, sizeof(double) * ca);
+  b.row_state = (unsigned char *)hscopt_alloc(a, ca);
+  b.rabbit_keys = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.mean_pos = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.sum = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.sumsq = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.tmp1 = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.tmp2 = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  b.levy = (double *)hscopt_alloc(a, sizeof(double) * cd);
+  if (ctx->surr_v) {
+    b.surr_v = (unsigned char *)hscopt_alloc(a, ca);
+  }
+  int rc = (!b.X || !b.fitness || !b.row_state || !b.rabbit_keys ||
+            !b.mean_pos || !b.sum || !b.sumsq || !b.tmp1 || !b.tmp2 ||
+            !b.levy || (ctx->surr_v && !b.surr_v));
+  if (!rc && ctx->block) {
+    rc = hho_block_bufs_alloc(a, ca, ctx->block, &b);
+  }
+  if (!rc && ctx->async.submit) {
+    rc = hho_async_bufs_alloc(a, cd, ca, &b);
+  }
+  if (rc) {
+    hho_buffers_free(a, &b);
+    return 1;
   }
+
+  hho_buffers_swap(ctx, &b);
+  hho_buffers_free(a, &b);
+  ctx->cap_dim = cd;
+  ctx->cap_agents = ca;
+  return 0;
 }
 
-HSCOPT_INLINE void hho_mean_pos(hscopt_hho_ctx *ctx) {
-  memset(ctx->mean_pos, 0, ctx->dim * sizeof(double));
+static void hho_async_release(hscopt_hho_ctx *ctx) {
+  hho_buffers b = {0};
+  b.async_y = ctx->async_y;
+  b.async_rows = ctx->async_rows;
+  b.async_idx = ctx->async_idx;
+  b.async_fit = ctx->async_fit;
+  hho_async_bufs_free(&ctx->alloc, &b);
+  ctx->async_y = NULL;
+  ctx->async_rows = NULL;
+  ctx->async_idx = NULL;
+  ctx->async_fit = NULL;
+  memset(&ctx->async, 0, sizeof(ctx->async));
+}
+
+// Linhas da avaliação paralela; o decoder é o do contexto. Clonada por nível
+// de ISA como os kernels: o corpo da região paralela, que o compilador
+// extrai sem os clones, só chama esta função.
+HSCOPT_TARGET_CLONES static void hho_rows(hscopt_hho_ctx *ctx, size_t lo,
+                                          size_t hi) {
+  hscopt_hho_impl_rows_run(ctx, lo, hi, ctx->dim, ctx->decoder);
+}
 
+// Avalia todas as linhas de X pelo avaliador assíncrono.
+static int hho_async_eval_all(hscopt_hho_ctx *ctx) {
   for (size_t i = 0; i < ctx->n_agents; ++i) {
-    const double *const x = HAWK_PTR(ctx, i);
-    for (size_t j = 0; j < ctx->dim; ++j) {
-      ctx->mean_pos[j] += x[j];
-    }
+    ctx->async_rows[i] = HSCOPT_HHO_HAWK_PTR(ctx, i);
   }
-
-  const double inv = 1.0 / (double)ctx->n_agents;
-  for (size_t j = 0; j < ctx->dim; ++j) {
-    ctx->mean_pos[j] *= inv;
+  if (hscopt_async_eval(&ctx->async, ctx->async_rows, ctx->dim,
+                        ctx->n_agents, ctx->fitness) != 0) {
+    return 1;
   }
+  memset(ctx->row_state, HSCOPT_HHO_ROW_FRESH, ctx->n_agents);
+  return 0;
 }
 
 hscopt_hho_ctx *hscopt_hho_create(size_t dim, size_t n_agents,
@@ -129,6 +255,15 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
     size_t dim, size_t n_agents, unsigned max_iters, unsigned max_threads,
     hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx, hscopt_rng *rng,
     const hscopt_allocator *alloc) {
+  return hscopt_hho_create_with_affinity(dim, n_agents, max_iters, max_threads,
+                                         decoder, dctx, rng, alloc,
+                                         HSCOPT_AFFINITY_NONE);
+}
+
+hscopt_hho_ctx *hscopt_hho_create_with_affinity(
+    size_t dim, size_t n_agents, unsigned max_iters, unsigned max_threads,
+    hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx, hscopt_rng *rng,
+    const hscopt_allocator *alloc, hscopt_affinity affinity) {
   if (!decoder || !rng || dim == 0 || n_agents == 0 || max_iters == 0) {
     return NULL;
   }
@@ -151,6 +286,7 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
   ctx->alloc = resolved;
 
   ctx->dim = dim;
+  ctx->kernel = hho_select_kernel(dim);
   ctx->n_agents = n_agents;
   ctx->iter = 0;
   ctx->max_iters = max_iters;
@@ -165,18 +301,7 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
   ctx->dctx = dctx;
   ctx->rng = rng;
 
-  ctx->X =
-      (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * (dim * n_agents));
-  ctx->fitness =
-      (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * n_agents);
-  ctx->rabbit_keys = (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * dim);
-  ctx->mean_pos = (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * dim);
-  ctx->tmp1 = (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * dim);
-  ctx->tmp2 = (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * dim);
-  ctx->levy = (double *)hscopt_alloc(&ctx->alloc, sizeof(double) * dim);
-
-  if (!ctx->X || !ctx->fitness || !ctx->rabbit_keys || !ctx->mean_pos ||
-      !ctx->tmp1 || !ctx->tmp2 || !ctx->levy) {
+  if (hho_reserve(ctx, dim, n_agents) != 0) {
     hscopt_hho_destroy(ctx);
     return NULL;
   }
@@ -187,8 +312,23 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
       tgamma((1.0 + beta) / 2.0) * beta * pow(2.0, (beta - 1.0) / 2.0);
   ctx->levy_sigma = pow(num / den, 1.0 / beta);
 
-  ctx->gauss.has_spare = 0;
-  ctx->gauss.spare = 0.0;
+#ifdef _OPENMP
+  if (affinity != HSCOPT_AFFINITY_NONE) {
+    ctx->cpus = (int *)hscopt_alloc(&ctx->alloc,
+                                    sizeof(int) * ctx->eff_threads);
+    if (!ctx->cpus) {
+      hscopt_hho_destroy(ctx);
+      return NULL;
+    }
+    // Plataforma sem suporte: segue sem afinidade.
+    if (hscopt_affinity_plan(affinity, ctx->eff_threads, ctx->cpus) != 0) {
+      hscopt_free(&ctx->alloc, ctx->cpus);
+      ctx->cpus = NULL;
+    }
+  }
+#else
+  (void)affinity;
+#endif
 
   if (hscopt_hho_reset(ctx) != 0) {
     hscopt_hho_destroy(ctx);
@@ -201,13 +341,11 @@ hscopt_hho_ctx *hscopt_hho_create_with_allocator(
 void hscopt_hho_destroy(hscopt_hho_ctx *ctx) {
   if (!ctx) return;
 
-  hscopt_free(&ctx->alloc, ctx->X);
-  hscopt_free(&ctx->alloc, ctx->fitness);
-  hscopt_free(&ctx->alloc, ctx->rabbit_keys);
-  hscopt_free(&ctx->alloc, ctx->mean_pos);
-  hscopt_free(&ctx->alloc, ctx->tmp1);
-  hscopt_free(&ctx->alloc, ctx->tmp2);
-  hscopt_free(&ctx->alloc, ctx->levy);
+  hho_buffers b = {0};
+  hho_buffers_swap(ctx, &b);
+  hho_buffers_free(&ctx->alloc, &b);
+  hscopt_free(&ctx->alloc, ctx->board_keys);
+  hscopt_free(&ctx->alloc, ctx->cpus);
   hscopt_free(&ctx->alloc, ctx);
 }
 
@@ -218,150 +356,340 @@ int hscopt_hho_reset(hscopt_hho_ctx *ctx) {
 
   ctx->iter = 0;
   ctx->rabbit_fitness = INFINITY;
-  ctx->gauss.has_spare = 0;
-  ctx->gauss.spare = 0.0;
+  ctx->board_pub = INFINITY;
 
   memset(ctx->rabbit_keys, 0, ctx->dim * sizeof(double));
 
-  for (size_t i = 0; i < ctx->n_agents; ++i) {
-    double *const x = HAWK_PTR(ctx, i);
-    for (size_t j = 0; j < ctx->dim; ++j) {
-      x[j] = hscopt_rng_next_u01(ctx->rng);
+  // Sorteios: (iter, agente, sorteio) -> Philox com esta chave.
+  hscopt_ctr_rng_seed(&ctx->ctr, hscopt_rng_next_u64(ctx->rng));
+
+  // Cada thread inicializa as suas linhas (first-touch no nó NUMA local).
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(ctx->eff_threads)
+#endif
+  {
+    hscopt_hho_impl_pin(ctx);
+    size_t lo, hi;
+    hscopt_hho_impl_agent_range(ctx, &lo, &hi);
+    for (size_t i = lo; i < hi; ++i) {
+      double *const x = HSCOPT_HHO_HAWK_PTR(ctx, i);
+      hscopt_ctr_rng_fill_u01(&ctx->ctr, HHO_INIT_ITER, (uint32_t)i, 0, x,
+                              ctx->dim);
+      HSCOPT_CLAMP_KEY_VEC(x, ctx->dim);
+      ctx->fitness[i] = INFINITY;
+      ctx->row_state[i] = HSCOPT_HHO_ROW_DIRTY;
     }
+    hscopt_hho_impl_unpin(ctx);
   }
 
-  hho_eval_all_and_update_rabbit(ctx);
+  hscopt_hho_impl_stats_resync(ctx, ctx->dim);
+  if (ctx->async.submit) {
+    if (hho_async_eval_all(ctx) != 0) {
+      return 2;
+    }
+  } else {
+    hscopt_hho_impl_eval_all(ctx, hho_rows);
+  }
+  if (ctx->surrogate) {
+    hscopt_hho_impl_feed(ctx);
+  }
+  hscopt_hho_impl_update_rabbit(ctx, ctx->dim);
   return 0;
 }
 
-int hscopt_hho_iterate(hscopt_hho_ctx *ctx, unsigned int iters) {
-  if (!ctx || iters == 0) {
+int hscopt_hho_reconfigure(hscopt_hho_ctx *ctx, size_t dim, size_t n_agents,
+                           unsigned max_iters, hscopt_decoder_fn decoder,
+                           hscopt_decode_ctx *dctx) {
+  if (!ctx || !decoder || dim == 0 || n_agents == 0 || max_iters == 0) {
+    return 1;
+  }
+  if (hho_reserve(ctx, dim, n_agents) != 0) {
+    return 1;
+  }
+
+  if (dim != ctx->dim) {
+    ctx->kernel = hho_select_kernel(dim);
+  }
+  if (ctx->surrogate && hscopt_surrogate_dim(ctx->surrogate) != dim) {
+    ctx->surrogate = NULL;
+  }
+  if (ctx->board && hscopt_board_dim(ctx->board) != dim) {
+    hscopt_hho_set_board(ctx, NULL);
+  }
+  ctx->dim = dim;
+  ctx->n_agents = n_agents;
+  ctx->max_iters = max_iters;
+  ctx->decoder = decoder;
+  ctx->dctx = dctx;
+  return hscopt_hho_reset(ctx);
+}
+
+int hscopt_hho_set_async(hscopt_hho_ctx *ctx, const hscopt_async_decoder *ad) {
+  if (!ctx || (ad && (!ad->submit || !ad->wait_any))) {
+    return 1;
+  }
+
+  hho_async_release(ctx);
+  if (!ad) {
+    return 0;
+  }
+
+  hho_buffers b = {0};
+  if (hho_async_bufs_alloc(&ctx->alloc, ctx->cap_dim, ctx->cap_agents,
+                           &b) != 0) {
     return 1;
   }
-  if (ctx->iter >= ctx->max_iters || ctx->iter + iters > ctx->max_iters) {
-    return 2;
+  ctx->async_y = b.async_y;
+  ctx->async_rows = b.async_rows;
+  ctx->async_idx = b.async_idx;
+  ctx->async_fit = b.async_fit;
+  ctx->async = *ad;
+  return 0;
+}
+
+int hscopt_hho_set_surrogate(hscopt_hho_ctx *ctx, hscopt_surrogate *s) {
+  if (!ctx || (s && hscopt_surrogate_dim(s) != ctx->dim)) {
+    return 1;
   }
 
-  for (unsigned it = 0; it < iters; ++it) {
+  if (s && !ctx->surr_v) {
+    ctx->surr_v =
+        (unsigned char *)hscopt_alloc(&ctx->alloc, ctx->cap_agents);
+    if (!ctx->surr_v) {
+      return 1;
+    }
+  }
+  ctx->surrogate = s;
+  if (s) {
     for (size_t i = 0; i < ctx->n_agents; ++i) {
-      HSCOPT_CLAMP_KEY_VEC(HAWK_PTR(ctx, i), ctx->dim);
+      hscopt_surrogate_add(s, HSCOPT_HHO_HAWK_PTR(ctx, i), ctx->fitness[i]);
     }
+  }
+  return 0;
+}
 
-    const double e1 = HHO_E1(ctx->iter, ctx->max_iters);
-    hho_mean_pos(ctx);
+int hscopt_hho_set_cutoff(hscopt_hho_ctx *ctx, int enable) {
+  if (!ctx) {
+    return 1;
+  }
+  ctx->cutoff = (enable != 0);
+  return 0;
+}
 
-    for (size_t i = 0; i < ctx->n_agents; ++i) {
-      double *const Xi = HAWK_PTR(ctx, i);
-      const double e0 = HHO_E0(hscopt_rng_next_u01(ctx->rng));
-      const double e = e1 * e0;
-      const double abs_e = fabs(e);
-
-      if (abs_e >= 1.0) {
-        const double q = hscopt_rng_next_u01(ctx->rng);
-        const size_t r_idx = hscopt_rng_random_index(ctx->rng, ctx->n_agents);
-        const double *const Xrand = HAWK_PTR(ctx, r_idx);
-
-        if (q >= 0.5) {
-          const double r1 = hscopt_rng_next_u01(ctx->rng);
-          const double r2 = hscopt_rng_next_u01(ctx->rng);
-          for (size_t j = 0; j < ctx->dim; ++j) {
-            const double val = Xrand[j] - r1 * fabs(Xrand[j] - 2.0 * r2 * Xi[j]);
-            Xi[j] = HSCOPT_CLAMP_KEY(val);
-          }
-        } else {
-          const double s = hscopt_rng_next_u01(ctx->rng) *
-                           hscopt_rng_next_u01(ctx->rng);
-          for (size_t j = 0; j < ctx->dim; ++j) {
-            const double val = (ctx->rabbit_keys[j] - ctx->mean_pos[j]) - s;
-            Xi[j] = HSCOPT_CLAMP_KEY(val);
-          }
-        }
-        continue;
-      }
+int hscopt_hho_set_block(hscopt_hho_ctx *ctx, size_t block) {
+  if (!ctx) {
+    return 1;
+  }
 
-      const double r = hscopt_rng_next_u01(ctx->rng);
+  hho_buffers b = {0};
+  if (block > 0 &&
+      hho_block_bufs_alloc(&ctx->alloc, ctx->cap_agents, block, &b) != 0) {
+    return 1;
+  }
+  hho_buffers old = {
+      .blk_old = ctx->blk_old,
+      .blk_dctx = ctx->blk_dctx,
+      .blk_delta = ctx->blk_delta,
+  };
+  hho_block_bufs_free(&ctx->alloc, &old);
+  ctx->blk_old = b.blk_old;
+  ctx->blk_dctx = b.blk_dctx;
+  ctx->blk_delta = b.blk_delta;
+  ctx->block = block;
+  return 0;
+}
 
-      if (r >= 0.5 && abs_e >= 0.5) {
-        const double jump_strength = 2.0 * (1.0 - hscopt_rng_next_u01(ctx->rng));
-        for (size_t j = 0; j < ctx->dim; ++j) {
-          const double val =
-              (ctx->rabbit_keys[j] - Xi[j]) -
-              e * fabs(jump_strength * ctx->rabbit_keys[j] - Xi[j]);
-          Xi[j] = HSCOPT_CLAMP_KEY(val);
-        }
-        continue;
-      }
+size_t hscopt_hho_block(const hscopt_hho_ctx *ctx) {
+  return ctx ? ctx->block : 0u;
+}
 
-      if (r >= 0.5 && abs_e < 0.5) {
-        for (size_t j = 0; j < ctx->dim; ++j) {
-          const double val =
-              ctx->rabbit_keys[j] - e * fabs(ctx->rabbit_keys[j] - Xi[j]);
-          Xi[j] = HSCOPT_CLAMP_KEY(val);
-        }
-        continue;
-      }
+int hscopt_hho_set_board(hscopt_hho_ctx *ctx, hscopt_board *b) {
+  if (!ctx || (b && hscopt_board_dim(b) != ctx->dim)) {
+    return 1;
+  }
+
+  hscopt_free(&ctx->alloc, ctx->board_keys);
+  ctx->board_keys = NULL;
+  ctx->board = NULL;
+  if (!b) {
+    return 0;
+  }
+
+  ctx->board_keys =
+      (double *)hscopt_alloc(&ctx->alloc, ctx->dim * sizeof(double));
+  if (!ctx->board_keys) {
+    return 1;
+  }
+  ctx->board = b;
+  ctx->board_pub = INFINITY;
+  ctx->board_seen = 0u;
+  return 0;
+}
 
-      if (r < 0.5 && abs_e >= 0.5) {
-        const double jump_strength = 2.0 * (1.0 - hscopt_rng_next_u01(ctx->rng));
-
-        for (size_t j = 0; j < ctx->dim; ++j) {
-          ctx->tmp1[j] = ctx->rabbit_keys[j] -
-                         e * fabs(jump_strength * ctx->rabbit_keys[j] - Xi[j]);
-        }
-        HSCOPT_CLAMP_KEY_VEC(ctx->tmp1, ctx->dim);
-
-        const double fcur = ctx->decoder(Xi, ctx->dim, ctx->dctx);
-        const double f1 = ctx->decoder(ctx->tmp1, ctx->dim, ctx->dctx);
-
-        if (f1 < fcur) {
-          memcpy(Xi, ctx->tmp1, ctx->dim * sizeof(double));
-        } else {
-          hho_levy(ctx);
-          for (size_t j = 0; j < ctx->dim; ++j) {
-            ctx->tmp2[j] =
-                ctx->tmp1[j] + hho_randn(ctx->rng, ctx) * ctx->levy[j];
-          }
-          HSCOPT_CLAMP_KEY_VEC(ctx->tmp2, ctx->dim);
-
-          const double f2 = ctx->decoder(ctx->tmp2, ctx->dim, ctx->dctx);
-          if (f2 < fcur) {
-            memcpy(Xi, ctx->tmp2, ctx->dim * sizeof(double));
-          }
-        }
+// Triagem dos candidatos (w = 0: Y1, 1: Y2) dos mergulhos async_idx[0, n):
+// move os descartados para o fim e retorna quantos vão ao avaliador.
+static size_t hho_async_screen(hscopt_hho_ctx *ctx, size_t n, size_t w) {
+  if (!ctx->surrogate) {
+    return n;
+  }
+  size_t keep = 0;
+  for (size_t k = 0; k < n; ++k) {
+    const size_t i = ctx->async_idx[k];
+    const hscopt_surrogate_verdict v =
+        hscopt_surrogate_screen(ctx->surrogate, HHO_Y(ctx, i, w),
+                                ctx->fitness[i]);
+    ctx->surr_v[i] = (unsigned char)v;
+    if (v != HSCOPT_SURROGATE_SKIP) {
+      ctx->async_idx[k] = ctx->async_idx[keep];
+      ctx->async_idx[keep++] = i;
+    }
+  }
+  return keep;
+}
+
+static void hho_async_record(hscopt_hho_ctx *ctx, size_t i, const double *y,
+                             double f) {
+  if (ctx->surrogate) {
+    hscopt_surrogate_record(ctx->surrogate, y, f, ctx->fitness[i],
+                            (hscopt_surrogate_verdict)ctx->surr_v[i]);
+  }
+}
+
+// Uma iteração com o avaliador assíncrono. Lote 1: novas posições dos
+// hawks fora de mergulho e Y1 dos mergulhos; lote 2: Y2 dos mergulhos em
+// que Y1 não melhorou o hawk. O fitness de um hawk em mergulho já é o da
+// sua posição (avaliada na iteração anterior). Com modelo substituto, os Y1
+// e Y2 descartados pela triagem ficam fora dos lotes.
+static int hho_iterate_async_once(hscopt_hho_ctx *ctx) {
+  const size_t dim = ctx->dim;
+  const size_t n = ctx->n_agents;
+
+  if (ctx->iter % HSCOPT_HHO_RESYNC_PERIOD == 0) {
+    hscopt_hho_impl_stats_resync(ctx, dim);
+  }
+  const double e1 = HSCOPT_HHO_E1(ctx->iter, ctx->max_iters);
+  hscopt_hho_impl_mean_pos(ctx, dim);
+
+  // Mergulhos no início de async_idx, demais hawks no fim.
+  size_t n_dive = 0, n_move = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (hscopt_hho_impl_update_agent(ctx, i, e1, HHO_Y1(ctx, i),
+                                     HHO_Y2(ctx, i), dim, NULL)) {
+      ctx->async_idx[n_dive++] = i;
+    } else {
+      ctx->async_idx[n - 1u - n_move++] = i;
+    }
+  }
+
+  // Mergulhos com Y1 a avaliar em [0, n_y1); descartados em [n_y1, n_dive).
+  const size_t n_y1 = hho_async_screen(ctx, n_dive, 0u);
+  for (size_t k = 0; k < n_y1; ++k) {
+    ctx->async_rows[k] = HHO_Y1(ctx, ctx->async_idx[k]);
+  }
+  for (size_t k = n_dive; k < n; ++k) {
+    ctx->async_rows[n_y1 + (k - n_dive)] =
+        HSCOPT_HHO_HAWK_PTR(ctx, ctx->async_idx[k]);
+  }
+  if (hscopt_async_eval(&ctx->async, ctx->async_rows, dim,
+                        n_y1 + (n - n_dive), ctx->async_fit) != 0) {
+    return 3;
+  }
+  for (size_t k = n_dive; k < n; ++k) {
+    const size_t i = ctx->async_idx[k];
+    ctx->fitness[i] = ctx->async_fit[n_y1 + (k - n_dive)];
+    ctx->row_state[i] = HSCOPT_HHO_ROW_FRESH;
+  }
+
+  // Y1 aceito ou Y2 pendente (compacta os pendentes no início).
+  size_t n_retry = 0;
+  for (size_t k = 0; k < n_dive; ++k) {
+    const size_t i = ctx->async_idx[k];
+    if (k < n_y1) {
+      hho_async_record(ctx, i, HHO_Y1(ctx, i), ctx->async_fit[k]);
+      if (ctx->async_fit[k] < ctx->fitness[i]) {
+        hscopt_hho_impl_accept(ctx, i, HSCOPT_HHO_HAWK_PTR(ctx, i),
+                               HHO_Y1(ctx, i), ctx->async_fit[k], dim);
         continue;
       }
+    }
+    ctx->async_idx[n_retry++] = i;
+  }
 
-      const double jump_strength = 2.0 * (1.0 - hscopt_rng_next_u01(ctx->rng));
-      for (size_t j = 0; j < ctx->dim; ++j) {
-        ctx->tmp1[j] = ctx->rabbit_keys[j] -
-                       e * fabs(jump_strength * ctx->rabbit_keys[j] -
-                                ctx->mean_pos[j]);
-      }
-      HSCOPT_CLAMP_KEY_VEC(ctx->tmp1, ctx->dim);
-
-      const double fcur = ctx->decoder(Xi, ctx->dim, ctx->dctx);
-      const double f1 = ctx->decoder(ctx->tmp1, ctx->dim, ctx->dctx);
-
-      if (f1 < fcur) {
-        memcpy(Xi, ctx->tmp1, ctx->dim * sizeof(double));
-      } else {
-        hho_levy(ctx);
-        for (size_t j = 0; j < ctx->dim; ++j) {
-          ctx->tmp2[j] = ctx->tmp1[j] + hho_randn(ctx->rng, ctx) * ctx->levy[j];
-        }
-        HSCOPT_CLAMP_KEY_VEC(ctx->tmp2, ctx->dim);
-
-        const double f2 = ctx->decoder(ctx->tmp2, ctx->dim, ctx->dctx);
-        if (f2 < fcur) {
-          memcpy(Xi, ctx->tmp2, ctx->dim * sizeof(double));
-        }
+  const size_t n_y2 = hho_async_screen(ctx, n_retry, 1u);
+  if (n_y2 > 0) {
+    for (size_t k = 0; k < n_y2; ++k) {
+      ctx->async_rows[k] = HHO_Y2(ctx, ctx->async_idx[k]);
+    }
+    if (hscopt_async_eval(&ctx->async, ctx->async_rows, dim, n_y2,
+                          ctx->async_fit) != 0) {
+      return 3;
+    }
+    for (size_t k = 0; k < n_y2; ++k) {
+      const size_t i = ctx->async_idx[k];
+      hho_async_record(ctx, i, HHO_Y2(ctx, i), ctx->async_fit[k]);
+      if (ctx->async_fit[k] < ctx->fitness[i]) {
+        hscopt_hho_impl_accept(ctx, i, HSCOPT_HHO_HAWK_PTR(ctx, i),
+                               HHO_Y2(ctx, i), ctx->async_fit[k], dim);
       }
     }
+  }
 
-    hho_eval_all_and_update_rabbit(ctx);
-    ++ctx->iter;
+  if (ctx->surrogate) {
+    hscopt_hho_impl_feed(ctx);
+  }
+  hscopt_hho_impl_update_rabbit(ctx, dim);
+  if (ctx->board) {
+    hscopt_hho_impl_board_sync(ctx);
+  }
+  ++ctx->iter;
+  return 0;
+}
+
+// Instancia o núcleo de hho_impl.h com dim = D. Os kernels são clonados por
+// nível de ISA (HSCOPT_TARGET_CLONES) e escolhidos pela CPU em runtime.
+#define HHO_FIXED_DIM_KERNEL(D)                                          \
+  HSCOPT_TARGET_CLONES static void hho_iterate_d##D(hscopt_hho_ctx *ctx, \
+                                                    unsigned iters) {    \
+    hscopt_hho_impl_iterate(ctx, iters, (size_t)(D), ctx->decoder,       \
+                            hho_rows);                                   \
+  }
+HSCOPT_FOR_EACH_FIXED_DIM(HHO_FIXED_DIM_KERNEL)
+#undef HHO_FIXED_DIM_KERNEL
+
+HSCOPT_TARGET_CLONES static void hho_iterate_any(hscopt_hho_ctx *ctx,
+                                                 unsigned iters) {
+  hscopt_hho_impl_iterate(ctx, iters, ctx->dim, ctx->decoder, hho_rows);
+}
+
+static hscopt_hho_kernel_fn hho_select_kernel(size_t dim) {
+#define HHO_FIXED_DIM_CASE(D) \
+  case D:                     \
+    return hho_iterate_d##D;
+  switch (dim) {
+    HSCOPT_FOR_EACH_FIXED_DIM(HHO_FIXED_DIM_CASE)
+    default:
+      return hho_iterate_any;
+  }
+#undef HHO_FIXED_DIM_CASE
+}
+
+int hscopt_hho_iterate(hscopt_hho_ctx *ctx, unsigned int iters) {
+  const int rc = hscopt_hho_impl_begin(ctx, iters);
+  if (rc != 0) {
+    return rc;
   }
 
+  if (ctx->async.submit) {
+    for (unsigned it = 0; it < iters; ++it) {
+      const int arc = hho_iterate_async_once(ctx);
+      if (arc != 0) {
+        return arc;
+      }
+    }
+    return 0;
+  }
+
+  ctx->kernel(ctx, iters);
   return 0;
 }
 
@@ -393,12 +721,38 @@ unsigned hscopt_hho_max_threads(const hscopt_hho_ctx *ctx) {
   return ctx ? ctx->eff_threads : 1u;
 }
 
+double hscopt_hho_diversity(const hscopt_hho_ctx *ctx) {
+  if (!ctx) {
+    return 0.0;
+  }
+
+  // (1/N) sum_i ||x_i - c||^2 = sum_j (sumsq_j / N - (sum_j / N)^2)
+  const double inv = 1.0 / (double)ctx->n_agents;
+  double var = 0.0;
+  for (size_t j = 0; j < ctx->dim; ++j) {
+    const double m = ctx->sum[j] * inv;
+    const double v = ctx->sumsq[j] * inv - m * m;
+    var += (v > 0.0 ? v : 0.0);
+  }
+  return sqrt(var);
+}
+
 int hscopt_hho_try_update_rabbit(hscopt_hho_ctx *ctx, const double *keys) {
   if (!ctx || !keys || !ctx->decoder) {
     return -1;
   }
 
-  const double f = ctx->decoder(keys, ctx->dim, ctx->dctx);
+  hscopt_decode_ctx *dc = ctx->dctx;
+  hscopt_decode_ctx cut;
+  if (ctx->cutoff) {
+    // Só interessa um objetivo menor que o do rabbit.
+    hscopt_hho_impl_cut_sync(ctx);
+    cut = ctx->dctx_cut;
+    cut.cutoff = ctx->rabbit_fitness;
+    dc = &cut;
+  }
+
+  const double f = ctx->decoder(keys, ctx->dim, dc);
   if (f < ctx->rabbit_fitness) {
     ctx->rabbit_fitness = f;
     memcpy(ctx->rabbit_keys, keys, ctx->dim * sizeof(double));
@@ -407,3 +761,67 @@ int hscopt_hho_try_update_rabbit(hscopt_hho_ctx *ctx, const double *keys) {
 
   return 0;
 }
+
+static void *hho_solver_create(const hscopt_solver_config *cfg) {
+  const hscopt_hho_params *p = (const hscopt_hho_params *)cfg->params;
+  if (!p) return NULL;
+  return hscopt_hho_create_with_allocator(cfg->dim, p->n_agents,
+                                          cfg->max_iters, cfg->max_threads,
+                                          cfg->decoder, cfg->dctx, cfg->rng,
+                                          cfg->alloc);
+}
+
+static int hho_solver_reconfigure(void *solver,
+                                  const hscopt_solver_config *cfg) {
+  hscopt_hho_ctx *const ctx = (hscopt_hho_ctx *)solver;
+  const hscopt_hho_params *p = (const hscopt_hho_params *)cfg->params;
+  const unsigned threads = (cfg->max_threads == 0u ? 1u : cfg->max_threads);
+  if (!p || !cfg->rng || threads != ctx->max_threads) {
+    return 1;
+  }
+  hscopt_rng *const old = ctx->rng;
+  ctx->rng = cfg->rng;
+  const int rc = hscopt_hho_reconfigure(ctx, cfg->dim, p->n_agents,
+                                        cfg->max_iters, cfg->decoder,
+                                        cfg->dctx);
+  if (rc == 1) {
+    ctx->rng = old;
+  }
+  return rc;
+}
+
+static void hho_solver_destroy(void *solver) {
+  hscopt_hho_destroy((hscopt_hho_ctx *)solver);
+}
+
+static int hho_solver_iterate(void *solver, unsigned iters) {
+  return hscopt_hho_iterate((hscopt_hho_ctx *)solver, iters);
+}
+
+static double hho_solver_best_fitness(const void *solver) {
+  return hscopt_hho_best_fitness((const hscopt_hho_ctx *)solver);
+}
+
+static const double *hho_solver_best_keys(const void *solver) {
+  return hscopt_hho_best_keys((const hscopt_hho_ctx *)solver);
+}
+
+static unsigned hho_solver_iteration(const void *solver) {
+  return hscopt_hho_iteration((const hscopt_hho_ctx *)solver);
+}
+
+static int hho_solver_inject(void *solver, const double *keys) {
+  return hscopt_hho_try_update_rabbit((hscopt_hho_ctx *)solver, keys);
+}
+
+const hscopt_solver_vtable hscopt_hho_solver = {
+    .name = "hho",
+    .create = hho_solver_create,
+    .destroy = hho_solver_destroy,
+    .iterate = hho_solver_iterate,
+    .best_fitness = hho_solver_best_fitness,
+    .best_keys = hho_solver_best_keys,
+    .iteration = hho_solver_iteration,
+    .inject = hho_solver_inject,
+    .reconfigure = hho_solver_reconfigure,
+};
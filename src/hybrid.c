@@ -0,0 +1,370 @@
+#include "hscopt/hybrid.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <threads.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/hho.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+
+struct hscopt_hybrid_ctx {
+  size_t dim;
+  unsigned rvns_iters;   // orçamento do RVNS por reinício
+  unsigned max_threads;  // orçamento total de threads
+  int concurrent;        // 1 se o RVNS roda em thread dedicada
+
+  hscopt_hho_ctx *hho;
+  hscopt_rvns_ctx *rvns;
+  hscopt_rng rvns_rng;  // stream próprio do RVNS
+
+  // Estado compartilhado entre HHO e RVNS (protegido por lock).
+  mtx_t lock;
+  cnd_t wake;  // acorda a thread do RVNS
+  cnd_t idle;  // avisa que a thread do RVNS parou de usar o RVNS
+  thrd_t worker;
+  int running;  // a thread do RVNS existe (criada no primeiro iterate)
+  int active;   // dentro de hscopt_hybrid_iterate(): o RVNS pode rodar
+  int busy;     // a thread do RVNS está usando o RVNS
+  int stop;
+  unsigned long long seed_version;  // incrementa a cada novo rabbit
+  double *seed_keys;                // rabbit publicado para o RVNS
+  int found_pending;                // há solução do RVNS a injetar
+  double found_fit;
+  double *found_keys;               // melhor solução do RVNS a injetar
+
+  double *inject_buf;     // cópia local usada pela thread do HHO
+  double *rvns_seed_buf;  // cópia local usada pela thread do RVNS
+  double seed_fit;        // fitness do último rabbit publicado
+
+  hscopt_hybrid_stats stats;
+
+  hscopt_allocator alloc;
+};
+
+hscopt_hybrid_ctx *hscopt_hybrid_create(size_t dim, size_t n_agents,
+                                        unsigned max_iters, size_t k_max,
+                                        unsigned rvns_iters,
+                                        unsigned max_threads,
+                                        hscopt_decoder_fn decoder,
+                                        hscopt_decode_ctx *dctx,
+                                        hscopt_rng *rng) {
+  return hscopt_hybrid_create_with_allocator(dim, n_agents, max_iters, k_max,
+                                             rvns_iters, max_threads, decoder,
+                                             dctx, rng, NULL);
+}
+
+hscopt_hybrid_ctx *hscopt_hybrid_create_with_allocator(
+    size_t dim, size_t n_agents, unsigned max_iters, size_t k_max,
+    unsigned rvns_iters, unsigned max_threads, hscopt_decoder_fn decoder,
+    hscopt_decode_ctx *dctx, hscopt_rng *rng, const hscopt_allocator *alloc) {
+  if (!decoder || !rng || dim == 0 || n_agents == 0 || max_iters == 0 ||
+      k_max == 0 || rvns_iters == 0) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_hybrid_ctx *ctx =
+      (hscopt_hybrid_ctx *)hscopt_calloc(&resolved, 1, sizeof(*ctx));
+  if (!ctx) {
+    return NULL;
+  }
+  ctx->alloc = resolved;
+
+  ctx->dim = dim;
+  ctx->rvns_iters = rvns_iters;
+  ctx->max_threads = (max_threads == 0u ? 1u : max_threads);
+  ctx->concurrent = ctx->max_threads >= 2u;
+
+  if (mtx_init(&ctx->lock, mtx_plain) != thrd_success) {
+    hscopt_free(&ctx->alloc, ctx);
+    return NULL;
+  }
+  if (cnd_init(&ctx->wake) != thrd_success) {
+    mtx_destroy(&ctx->lock);
+    hscopt_free(&ctx->alloc, ctx);
+    return NULL;
+  }
+  if (cnd_init(&ctx->idle) != thrd_success) {
+    cnd_destroy(&ctx->wake);
+    mtx_destroy(&ctx->lock);
+    hscopt_free(&ctx->alloc, ctx);
+    return NULL;
+  }
+
+  ctx->seed_keys = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  ctx->found_keys = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  ctx->inject_buf = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  ctx->rvns_seed_buf =
+      (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  if (!ctx->seed_keys || !ctx->found_keys || !ctx->inject_buf ||
+      !ctx->rvns_seed_buf) {
+    hscopt_hybrid_destroy(ctx);
+    return NULL;
+  }
+
+  const unsigned hho_threads =
+      ctx->concurrent ? ctx->max_threads - 1u : ctx->max_threads;
+  ctx->hho = hscopt_hho_create_with_allocator(dim, n_agents, max_iters,
+                                              hho_threads, decoder, dctx, rng,
+                                              &ctx->alloc);
+  if (!ctx->hho) {
+    hscopt_hybrid_destroy(ctx);
+    return NULL;
+  }
+
+  // O RVNS parte de um stream distante do usado pelo HHO.
+  ctx->rvns_rng = *rng;
+  hscopt_rng_long_jump(&ctx->rvns_rng);
+  ctx->rvns = hscopt_rvns_create_with_allocator(
+      hscopt_hho_best_keys(ctx->hho), dim, k_max, rvns_iters, 1u, decoder,
+      dctx, &ctx->rvns_rng, &ctx->alloc);
+  if (!ctx->rvns) {
+    hscopt_hybrid_destroy(ctx);
+    return NULL;
+  }
+
+  ctx->seed_fit = hscopt_hho_best_fitness(ctx->hho);
+  return ctx;
+}
+
+void hscopt_hybrid_destroy(hscopt_hybrid_ctx *ctx) {
+  if (!ctx) return;
+
+  if (ctx->running) {
+    mtx_lock(&ctx->lock);
+    ctx->stop = 1;
+    cnd_signal(&ctx->wake);
+    mtx_unlock(&ctx->lock);
+    thrd_join(ctx->worker, NULL);
+  }
+  hscopt_rvns_destroy(ctx->rvns);
+  hscopt_hho_destroy(ctx->hho);
+  cnd_destroy(&ctx->idle);
+  cnd_destroy(&ctx->wake);
+  mtx_destroy(&ctx->lock);
+
+  hscopt_free(&ctx->alloc, ctx->seed_keys);
+  hscopt_free(&ctx->alloc, ctx->found_keys);
+  hscopt_free(&ctx->alloc, ctx->inject_buf);
+  hscopt_free(&ctx->alloc, ctx->rvns_seed_buf);
+  hscopt_free(&ctx->alloc, ctx);
+}
+
+int hscopt_hybrid_reset(hscopt_hybrid_ctx *ctx) {
+  if (!ctx) {
+    return 1;
+  }
+
+  if (hscopt_hho_reset(ctx->hho) != 0) {
+    return 1;
+  }
+  if (hscopt_rvns_reset(ctx->rvns, hscopt_hho_best_keys(ctx->hho)) != 0) {
+    return 1;
+  }
+
+  // A thread do RVNS está parada fora de iterate; ela recomeça do novo
+  // rabbit na próxima chamada (e descarta o que tinha a publicar).
+  mtx_lock(&ctx->lock);
+  memcpy(ctx->seed_keys, hscopt_hho_best_keys(ctx->hho),
+         ctx->dim * sizeof(double));
+  if (ctx->running) ++ctx->seed_version;
+  ctx->found_pending = 0;
+  mtx_unlock(&ctx->lock);
+
+  ctx->seed_fit = hscopt_hho_best_fitness(ctx->hho);
+  memset(&ctx->stats, 0, sizeof(ctx->stats));
+  return 0;
+}
+
+// Publica o rabbit atual como nova semente do RVNS se ele melhorou.
+static void hybrid_publish_rabbit(hscopt_hybrid_ctx *ctx) {
+  const double f = hscopt_hho_best_fitness(ctx->hho);
+  if (!(f < ctx->seed_fit)) return;
+
+  mtx_lock(&ctx->lock);
+  memcpy(ctx->seed_keys, hscopt_hho_best_keys(ctx->hho),
+         ctx->dim * sizeof(double));
+  ++ctx->seed_version;
+  cnd_signal(&ctx->wake);
+  mtx_unlock(&ctx->lock);
+
+  ctx->seed_fit = f;
+  ++ctx->stats.reseeds;
+}
+
+// Oferece ao HHO a solução pendente do RVNS (se houver).
+static void hybrid_inject_found(hscopt_hybrid_ctx *ctx) {
+  mtx_lock(&ctx->lock);
+  const int pending = ctx->found_pending;
+  if (pending) {
+    memcpy(ctx->inject_buf, ctx->found_keys, ctx->dim * sizeof(double));
+    ctx->found_pending = 0;
+  }
+  mtx_unlock(&ctx->lock);
+
+  if (pending && hscopt_hho_try_update_rabbit(ctx->hho, ctx->inject_buf) == 1) {
+    // O RVNS já está nesse ponto: não precisa ser reiniciado por ele.
+    ctx->seed_fit = hscopt_hho_best_fitness(ctx->hho);
+    ++ctx->stats.injections;
+  }
+}
+
+// Uma iteração do RVNS; registra a melhor solução se ela melhorou.
+static void hybrid_rvns_step(hscopt_hybrid_ctx *ctx, double *pushed_fit) {
+  if (hscopt_rvns_iterate(ctx->rvns, 1) != 0) return;
+
+  const double f = hscopt_rvns_best_fitness(ctx->rvns);
+  mtx_lock(&ctx->lock);
+  ++ctx->stats.rvns_iters;
+  if (f < *pushed_fit) {
+    memcpy(ctx->found_keys, hscopt_rvns_best_keys(ctx->rvns),
+           ctx->dim * sizeof(double));
+    ctx->found_fit = f;
+    ctx->found_pending = 1;
+    *pushed_fit = f;
+  }
+  mtx_unlock(&ctx->lock);
+}
+
+// Thread do RVNS: vive do primeiro iterate até o destroy e só usa o RVNS
+// (e o decoder) enquanto uma chamada de iterate está em andamento.
+static int hybrid_rvns_main(void *arg) {
+  hscopt_hybrid_ctx *const ctx = (hscopt_hybrid_ctx *)arg;
+
+  mtx_lock(&ctx->lock);
+  unsigned long long version = ctx->seed_version;
+  double pushed_fit = hscopt_rvns_best_fitness(ctx->rvns);
+  while (!ctx->stop) {
+    if (!ctx->active ||
+        (ctx->seed_version == version &&
+         hscopt_rvns_iteration(ctx->rvns) >= ctx->rvns_iters)) {
+      // Fora de iterate, ou orçamento esgotado: espera novo rabbit, a
+      // próxima chamada ou o fim.
+      cnd_wait(&ctx->wake, &ctx->lock);
+      continue;
+    }
+
+    ctx->busy = 1;
+    if (ctx->seed_version != version) {
+      version = ctx->seed_version;
+      memcpy(ctx->rvns_seed_buf, ctx->seed_keys, ctx->dim * sizeof(double));
+      mtx_unlock(&ctx->lock);
+
+      hscopt_rvns_reset(ctx->rvns, ctx->rvns_seed_buf);
+      pushed_fit = hscopt_rvns_best_fitness(ctx->rvns);
+    } else {
+      mtx_unlock(&ctx->lock);
+      hybrid_rvns_step(ctx, &pushed_fit);
+    }
+    mtx_lock(&ctx->lock);
+    ctx->busy = 0;
+    cnd_signal(&ctx->idle);
+  }
+  mtx_unlock(&ctx->lock);
+
+  return 0;
+}
+
+// Libera a thread do RVNS para rodar (@p on = 1) ou a para e espera ela
+// largar o RVNS (@p on = 0).
+static void hybrid_set_active(hscopt_hybrid_ctx *ctx, int on) {
+  mtx_lock(&ctx->lock);
+  ctx->active = on;
+  if (on) {
+    cnd_signal(&ctx->wake);
+  } else {
+    while (ctx->busy) cnd_wait(&ctx->idle, &ctx->lock);
+  }
+  mtx_unlock(&ctx->lock);
+}
+
+int hscopt_hybrid_iterate(hscopt_hybrid_ctx *ctx, unsigned iters) {
+  if (!ctx || iters == 0) {
+    return 1;
+  }
+  const unsigned it0 = hscopt_hho_iteration(ctx->hho);
+  const unsigned max_iters = hscopt_hho_max_iters(ctx->hho);
+  if (it0 >= max_iters || it0 + iters > max_iters) {
+    return 2;
+  }
+
+  if (!ctx->concurrent) {
+    double pushed_fit = hscopt_rvns_best_fitness(ctx->rvns);
+    for (unsigned it = 0; it < iters; ++it) {
+      const int rc = hscopt_hho_iterate(ctx->hho, 1);
+      if (rc != 0) {
+        return rc;
+      }
+      hybrid_publish_rabbit(ctx);
+      if (ctx->seed_version != 0) {
+        hscopt_rvns_reset(ctx->rvns, ctx->seed_keys);
+        pushed_fit = hscopt_rvns_best_fitness(ctx->rvns);
+        ctx->seed_version = 0;
+      }
+      if (hscopt_rvns_iteration(ctx->rvns) < ctx->rvns_iters) {
+        hybrid_rvns_step(ctx, &pushed_fit);
+      }
+      hybrid_inject_found(ctx);
+    }
+    return 0;
+  }
+
+  // A thread do RVNS é criada uma vez e mantém o RVNS entre as chamadas;
+  // ele só é reiniciado quando o rabbit melhora (hybrid_publish_rabbit).
+  if (!ctx->running) {
+    if (thrd_create(&ctx->worker, hybrid_rvns_main, ctx) != thrd_success) {
+      return 3;
+    }
+    ctx->running = 1;
+  }
+  hybrid_set_active(ctx, 1);
+
+  int rc = 0;
+  for (unsigned it = 0; it < iters && rc == 0; ++it) {
+    rc = hscopt_hho_iterate(ctx->hho, 1);
+    hybrid_inject_found(ctx);
+    hybrid_publish_rabbit(ctx);
+  }
+
+  hybrid_set_active(ctx, 0);
+  hybrid_inject_found(ctx);
+  return rc;
+}
+
+double hscopt_hybrid_best_fitness(const hscopt_hybrid_ctx *ctx) {
+  return ctx ? hscopt_hho_best_fitness(ctx->hho) : INFINITY;
+}
+
+const double *hscopt_hybrid_best_keys(const hscopt_hybrid_ctx *ctx) {
+  return ctx ? hscopt_hho_best_keys(ctx->hho) : NULL;
+}
+
+void hscopt_hybrid_get_stats(const hscopt_hybrid_ctx *ctx,
+                             hscopt_hybrid_stats *out) {
+  if (!out) return;
+  if (!ctx) {
+    memset(out, 0, sizeof(*out));
+    return;
+  }
+  *out = ctx->stats;
+}
+
+hscopt_hho_ctx *hscopt_hybrid_hho(hscopt_hybrid_ctx *ctx) {
+  return ctx ? ctx->hho : NULL;
+}
+
+hscopt_rvns_ctx *hscopt_hybrid_rvns(hscopt_hybrid_ctx *ctx) {
+  return ctx ? ctx->rvns : NULL;
+}
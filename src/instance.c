@@ -0,0 +1,468 @@
+#include "hscopt/instance.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define HSCOPT_INSTANCE_MMAP 1
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#define INST_MAGIC "HSCINST"
+#define INST_ENDIAN UINT32_C(0x01020304)
+#define INST_ALIGN 64u
+
+// Cabeçalho no início do arquivo.
+typedef struct inst_file_hdr {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian;
+  uint64_t n_sections;
+  uint64_t table_offset;
+  uint64_t file_size;
+  uint8_t reserved[24];
+} inst_file_hdr;
+
+// Entrada da tabela de seções (no fim do arquivo).
+typedef struct inst_entry {
+  char name[HSCOPT_INSTANCE_NAME_MAX];
+  uint32_t kind;
+  uint32_t elem;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t nnz;
+  uint64_t data_off;     // elementos ou valores CSR (0 = ausente)
+  uint64_t row_ptr_off;  // CSR
+  uint64_t col_idx_off;  // CSR
+  uint64_t reserved[3];
+} inst_entry;
+
+_Static_assert(sizeof(inst_file_hdr) == 64, "cabecalho deve ter 64 bytes");
+_Static_assert(sizeof(inst_entry) == 128, "entrada deve ter 128 bytes");
+
+struct hscopt_instance_writer {
+  FILE *f;
+  uint64_t pos;
+  inst_entry *entries;
+  size_t n;
+  size_t cap;
+  int err;
+  hscopt_allocator alloc;
+};
+
+struct hscopt_instance {
+  const unsigned char *base;
+  size_t size;
+  const inst_entry *table;
+  size_t n;
+  hscopt_allocator alloc;
+};
+
+size_t hscopt_elem_size(hscopt_elem_type elem) {
+  switch (elem) {
+    case HSCOPT_ELEM_F64:
+    case HSCOPT_ELEM_I64:
+    case HSCOPT_ELEM_U64:
+      return 8u;
+    case HSCOPT_ELEM_F32:
+    case HSCOPT_ELEM_I32:
+    case HSCOPT_ELEM_U32:
+      return 4u;
+    case HSCOPT_ELEM_U8:
+      return 1u;
+    default:
+      return 0u;
+  }
+}
+
+// a * b com detecção de overflow.
+static int inst_mul(uint64_t a, uint64_t b, uint64_t *out) {
+  if (a != 0 && b > UINT64_MAX / a) return 1;
+  *out = a * b;
+  return 0;
+}
+
+static int inst_write_raw(hscopt_instance_writer *w, const void *p,
+                          uint64_t n) {
+  if (n > 0 && fwrite(p, 1, (size_t)n, w->f) != (size_t)n) {
+    w->err = 2;
+    return 2;
+  }
+  w->pos += n;
+  return 0;
+}
+
+// Completa com zeros até o próximo múltiplo de INST_ALIGN.
+static int inst_pad(hscopt_instance_writer *w) {
+  static const unsigned char zeros[INST_ALIGN];
+  const uint64_t r = w->pos % INST_ALIGN;
+  return r ? inst_write_raw(w, zeros, INST_ALIGN - r) : 0;
+}
+
+// Grava um bloco alinhado e retorna o seu offset em *off.
+static int inst_write_block(hscopt_instance_writer *w, const void *p,
+                            uint64_t n, uint64_t *off) {
+  if (inst_pad(w) != 0) return 2;
+  *off = w->pos;
+  return inst_write_raw(w, p, n);
+}
+
+hscopt_instance_writer *hscopt_instance_writer_open(const char *path) {
+  if (!path) {
+    return NULL;
+  }
+
+  hscopt_allocator alloc;
+  hscopt_get_allocator(&alloc);
+  hscopt_instance_writer *w = (hscopt_instance_writer *)hscopt_calloc(
+      &alloc, 1, sizeof(*w));
+  if (!w) {
+    return NULL;
+  }
+  w->alloc = alloc;
+
+  w->f = fopen(path, "wb");
+  if (!w->f) {
+    hscopt_free(&w->alloc, w);
+    return NULL;
+  }
+
+  // Cabeçalho provisório; o definitivo é gravado no close.
+  const inst_file_hdr hdr = {0};
+  inst_write_raw(w, &hdr, sizeof(hdr));
+  return w;
+}
+
+// Valida o nome e reserva a próxima entrada da tabela.
+static inst_entry *inst_new_entry(hscopt_instance_writer *w,
+                                  const char *name) {
+  const size_t len = strlen(name);
+  if (len == 0 || len >= HSCOPT_INSTANCE_NAME_MAX) {
+    return NULL;
+  }
+  for (size_t i = 0; i < w->n; ++i) {
+    if (strcmp(w->entries[i].name, name) == 0) return NULL;
+  }
+
+  if (w->n == w->cap) {
+    const size_t cap = (w->cap ? 2u * w->cap : 16u);
+    inst_entry *e = (inst_entry *)hscopt_calloc(&w->alloc, cap, sizeof(*e));
+    if (!e) return NULL;
+    if (w->n) memcpy(e, w->entries, w->n * sizeof(*e));
+    hscopt_free(&w->alloc, w->entries);
+    w->entries = e;
+    w->cap = cap;
+  }
+
+  inst_entry *const e = &w->entries[w->n];
+  memset(e, 0, sizeof(*e));
+  memcpy(e->name, name, len + 1u);
+  return e;
+}
+
+static int inst_write_array(hscopt_instance_writer *w, const char *name,
+                            hscopt_section_kind kind, hscopt_elem_type elem,
+                            const void *data, size_t rows, size_t cols) {
+  if (!w || !name || (!data && rows * cols > 0)) {
+    return 1;
+  }
+  if (w->err) {
+    return w->err;
+  }
+
+  const size_t es = hscopt_elem_size(elem);
+  uint64_t count, bytes;
+  if (es == 0 || inst_mul(rows, cols, &count) != 0 ||
+      inst_mul(count, es, &bytes) != 0) {
+    return 1;
+  }
+
+  inst_entry *const e = inst_new_entry(w, name);
+  if (!e) {
+    return 1;
+  }
+  e->kind = (uint32_t)kind;
+  e->elem = (uint32_t)elem;
+  e->rows = rows;
+  e->cols = cols;
+  if (inst_write_block(w, data, bytes, &e->data_off) != 0) {
+    return 2;
+  }
+  ++w->n;
+  return 0;
+}
+
+int hscopt_instance_write_vector(hscopt_instance_writer *w, const char *name,
+                                 hscopt_elem_type elem, const void *data,
+                                 size_t n) {
+  return inst_write_array(w, name, HSCOPT_SECTION_VECTOR, elem, data, n, 1u);
+}
+
+int hscopt_instance_write_dense(hscopt_instance_writer *w, const char *name,
+                                hscopt_elem_type elem, const void *data,
+                                size_t rows, size_t cols) {
+  return inst_write_array(w, name, HSCOPT_SECTION_DENSE, elem, data, rows,
+                          cols);
+}
+
+// Estrutura CSR válida: row_ptr começa em 0, não decresce e termina em
+// nnz, e toda coluna é < cols. Garante que col_idx[row_ptr[i], row_ptr[i+1])
+// e as colunas estão dentro dos limites.
+static int inst_csr_ok(const uint64_t *rp, const uint32_t *ci, uint64_t rows,
+                       uint64_t cols, uint64_t nnz) {
+  if (rp[0] != 0 || rp[rows] != nnz) {
+    return 0;
+  }
+  for (uint64_t i = 0; i < rows; ++i) {
+    if (rp[i + 1] < rp[i]) {
+      return 0;
+    }
+  }
+  for (uint64_t k = 0; k < nnz; ++k) {
+    if (ci[k] >= cols) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int hscopt_instance_write_csr(hscopt_instance_writer *w, const char *name,
+                              hscopt_elem_type elem, const uint64_t *row_ptr,
+                              const uint32_t *col_idx, const void *values,
+                              size_t rows, size_t cols) {
+  if (!w || !name || !row_ptr || row_ptr[0] != 0) {
+    return 1;
+  }
+  if (w->err) {
+    return w->err;
+  }
+
+  const uint64_t nnz = row_ptr[rows];
+  const size_t es = hscopt_elem_size(elem);
+  uint64_t rp_bytes, ci_bytes, val_bytes;
+  if (inst_mul((uint64_t)rows + 1u, sizeof(uint64_t), &rp_bytes) != 0 ||
+      inst_mul(nnz, sizeof(uint32_t), &ci_bytes) != 0 ||
+      inst_mul(nnz, es, &val_bytes) != 0) {
+    return 1;
+  }
+  if ((nnz > 0 && !col_idx) || (es > 0 && nnz > 0 && !values) ||
+      (elem != HSCOPT_ELEM_NONE && es == 0) ||
+      !inst_csr_ok(row_ptr, col_idx, rows, cols, nnz)) {
+    return 1;
+  }
+
+  inst_entry *const e = inst_new_entry(w, name);
+  if (!e) {
+    return 1;
+  }
+  e->kind = (uint32_t)HSCOPT_SECTION_CSR;
+  e->elem = (uint32_t)elem;
+  e->rows = rows;
+  e->cols = cols;
+  e->nnz = nnz;
+  if (inst_write_block(w, row_ptr, rp_bytes, &e->row_ptr_off) != 0 ||
+      inst_write_block(w, col_idx, ci_bytes, &e->col_idx_off) != 0) {
+    return 2;
+  }
+  if (es > 0 && inst_write_block(w, values, val_bytes, &e->data_off) != 0) {
+    return 2;
+  }
+  ++w->n;
+  return 0;
+}
+
+int hscopt_instance_writer_close(hscopt_instance_writer *w) {
+  if (!w) {
+    return 1;
+  }
+
+  int rc = w->err;
+  if (rc == 0) {
+    uint64_t table_offset = 0;
+    rc = inst_write_block(w, w->entries, (uint64_t)w->n * sizeof(inst_entry),
+                          &table_offset);
+
+    inst_file_hdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, INST_MAGIC, sizeof(INST_MAGIC));
+    hdr.version = HSCOPT_INSTANCE_VERSION;
+    hdr.endian = INST_ENDIAN;
+    hdr.n_sections = w->n;
+    hdr.table_offset = table_offset;
+    hdr.file_size = w->pos;
+    if (rc == 0 && (fseek(w->f, 0, SEEK_SET) != 0 ||
+                    fwrite(&hdr, sizeof(hdr), 1, w->f) != 1)) {
+      rc = 2;
+    }
+  }
+
+  if (fclose(w->f) != 0 && rc == 0) {
+    rc = 2;
+  }
+  hscopt_free(&w->alloc, w->entries);
+  hscopt_free(&w->alloc, w);
+  return rc;
+}
+
+// Bloco [off, off + bytes) alinhado e dentro da área de dados.
+static int inst_block_ok(uint64_t off, uint64_t bytes, uint64_t limit) {
+  return off >= sizeof(inst_file_hdr) && off % INST_ALIGN == 0 &&
+         off <= limit && bytes <= limit - off;
+}
+
+static int inst_entry_ok(const hscopt_instance *inst, const inst_entry *e,
+                         uint64_t limit) {
+  if (memchr(e->name, '\0', sizeof(e->name)) == NULL || e->name[0] == '\0') {
+    return 0;
+  }
+
+  const size_t es = hscopt_elem_size((hscopt_elem_type)e->elem);
+  uint64_t count, bytes;
+  switch ((hscopt_section_kind)e->kind) {
+    case HSCOPT_SECTION_VECTOR:
+    case HSCOPT_SECTION_DENSE:
+      return es > 0 && inst_mul(e->rows, e->cols, &count) == 0 &&
+             inst_mul(count, es, &bytes) == 0 &&
+             inst_block_ok(e->data_off, bytes, limit);
+    case HSCOPT_SECTION_CSR: {
+      if (e->elem != HSCOPT_ELEM_NONE && es == 0) return 0;
+      if (e->rows == UINT64_MAX ||
+          inst_mul(e->rows + 1u, sizeof(uint64_t), &bytes) != 0 ||
+          !inst_block_ok(e->row_ptr_off, bytes, limit) ||
+          inst_mul(e->nnz, sizeof(uint32_t), &bytes) != 0 ||
+          !inst_block_ok(e->col_idx_off, bytes, limit)) {
+        return 0;
+      }
+      if (es > 0 && (inst_mul(e->nnz, es, &bytes) != 0 ||
+                     !inst_block_ok(e->data_off, bytes, limit))) {
+        return 0;
+      }
+      const uint64_t *rp =
+          (const uint64_t *)(const void *)(inst->base + e->row_ptr_off);
+      const uint32_t *ci =
+          (const uint32_t *)(const void *)(inst->base + e->col_idx_off);
+      return inst_csr_ok(rp, ci, e->rows, e->cols, e->nnz);
+    }
+    default:
+      return 0;
+  }
+}
+
+hscopt_instance *hscopt_instance_open(const char *path) {
+#ifdef HSCOPT_INSTANCE_MMAP
+  if (!path) {
+    return NULL;
+  }
+
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(inst_file_hdr)) {
+    close(fd);
+    return NULL;
+  }
+
+  const size_t size = (size_t)st.st_size;
+  void *p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+
+  hscopt_allocator alloc;
+  hscopt_get_allocator(&alloc);
+  hscopt_instance *inst =
+      (hscopt_instance *)hscopt_calloc(&alloc, 1, sizeof(*inst));
+  if (!inst) {
+    munmap(p, size);
+    return NULL;
+  }
+  inst->alloc = alloc;
+  inst->base = (const unsigned char *)p;
+  inst->size = size;
+
+  const inst_file_hdr *hdr = (const inst_file_hdr *)p;
+  int ok = memcmp(hdr->magic, INST_MAGIC, sizeof(INST_MAGIC)) == 0 &&
+           hdr->version == HSCOPT_INSTANCE_VERSION &&
+           hdr->endian == INST_ENDIAN && hdr->file_size == (uint64_t)size;
+
+  uint64_t table_bytes = 0;
+  ok = ok && inst_mul(hdr->n_sections, sizeof(inst_entry), &table_bytes) == 0 &&
+       inst_block_ok(hdr->table_offset, table_bytes, (uint64_t)size);
+  if (ok) {
+    inst->table =
+        (const inst_entry *)(const void *)(inst->base + hdr->table_offset);
+    inst->n = (size_t)hdr->n_sections;
+    for (size_t i = 0; ok && i < inst->n; ++i) {
+      ok = inst_entry_ok(inst, &inst->table[i], hdr->table_offset);
+    }
+  }
+
+  if (!ok) {
+    hscopt_instance_close(inst);
+    return NULL;
+  }
+  return inst;
+#else
+  (void)path;
+  return NULL;
+#endif /* HSCOPT_INSTANCE_MMAP */
+}
+
+void hscopt_instance_close(hscopt_instance *inst) {
+  if (!inst) return;
+#ifdef HSCOPT_INSTANCE_MMAP
+  munmap((void *)(uintptr_t)inst->base, inst->size);
+#endif
+  hscopt_free(&inst->alloc, inst);
+}
+
+size_t hscopt_instance_n_sections(const hscopt_instance *inst) {
+  return inst ? inst->n : 0u;
+}
+
+int hscopt_instance_section(const hscopt_instance *inst, size_t i,
+                            hscopt_section *out) {
+  if (!inst || !out || i >= inst->n) {
+    return 1;
+  }
+
+  const inst_entry *const e = &inst->table[i];
+  memset(out, 0, sizeof(*out));
+  out->name = e->name;
+  out->kind = (hscopt_section_kind)e->kind;
+  out->elem = (hscopt_elem_type)e->elem;
+  out->rows = (size_t)e->rows;
+  out->cols = (size_t)e->cols;
+  out->nnz = (size_t)e->nnz;
+  if (e->data_off) out->data = inst->base + e->data_off;
+  if (out->kind == HSCOPT_SECTION_CSR) {
+    out->row_ptr = (const uint64_t *)(const void *)(inst->base +
+                                                    e->row_ptr_off);
+    out->col_idx = (const uint32_t *)(const void *)(inst->base +
+                                                    e->col_idx_off);
+  }
+  return 0;
+}
+
+int hscopt_instance_find(const hscopt_instance *inst, const char *name,
+                         hscopt_section *out) {
+  if (!inst || !name) {
+    return 1;
+  }
+  for (size_t i = 0; i < inst->n; ++i) {
+    if (strcmp(inst->table[i].name, name) == 0) {
+      return hscopt_instance_section(inst, i, out);
+    }
+  }
+  return 1;
+}
@@ -0,0 +1,609 @@
+#include "hscopt/keys.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/defs.h"
+
+#define KEYS_RADIX_BITS 8
+#define KEYS_RADIX_BINS (1u << KEYS_RADIX_BITS)
+#define KEYS_RADIX_PASSES (64 / KEYS_RADIX_BITS)
+#define KEYS_SMALL_N 32
+
+struct hscopt_workspace {
+  size_t capacity;  // maior n suportado
+  uint64_t *bits;   // chaves transformadas [2 * capacity] (ping-pong)
+  size_t *idx;      // índices auxiliares [capacity]
+  size_t hist[KEYS_RADIX_PASSES][KEYS_RADIX_BINS];
+
+  hscopt_allocator alloc;
+};
+
+hscopt_workspace *hscopt_workspace_create(size_t capacity) {
+  return hscopt_workspace_create_with_allocator(capacity, NULL);
+}
+
+hscopt_workspace *hscopt_workspace_create_with_allocator(
+    size_t capacity, const hscopt_allocator *alloc) {
+  if (capacity == 0) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_workspace *ws =
+      (hscopt_workspace *)hscopt_calloc(&resolved, 1, sizeof(*ws));
+  if (!ws) {
+    return NULL;
+  }
+  ws->alloc = resolved;
+  ws->capacity = capacity;
+
+  ws->bits =
+      (uint64_t *)hscopt_alloc(&ws->alloc, 2 * capacity * sizeof(uint64_t));
+  ws->idx = (size_t *)hscopt_alloc(&ws->alloc, capacity * sizeof(size_t));
+  if (!ws->bits || !ws->idx) {
+    hscopt_workspace_destroy(ws);
+    return NULL;
+  }
+
+  return ws;
+}
+
+void hscopt_workspace_destroy(hscopt_workspace *ws) {
+  if (!ws) return;
+  hscopt_free(&ws->alloc, ws->bits);
+  hscopt_free(&ws->alloc, ws->idx);
+  hscopt_free(&ws->alloc, ws);
+}
+
+size_t hscopt_workspace_capacity(const hscopt_workspace *ws) {
+  return ws ? ws->capacity : 0u;
+}
+
+// Mapeia o double para um inteiro sem sinal com a mesma ordem numérica:
+// positivos têm o bit de sinal ligado, negativos têm todos os bits invertidos.
+HSCOPT_INLINE uint64_t keys_bits(double d) {
+  uint64_t u;
+  memcpy(&u, &d, sizeof(u));
+  const uint64_t mask =
+      (uint64_t)((int64_t)u >> 63) | UINT64_C(0x8000000000000000);
+  return u ^ mask;
+}
+
+// Sem desvios, para que o compilador vetorize a conversão.
+HSCOPT_INLINE void keys_to_bits(const double *keys, size_t n, uint64_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = keys_bits(keys[i]);
+  }
+}
+
+// Comparação total por (bits, índice).
+HSCOPT_INLINE int keys_less(uint64_t ba, size_t ia, uint64_t bb, size_t ib) {
+  return ba < bb || (ba == bb && ia < ib);
+}
+
+// Inserção estável sobre pares (bits, índice) já em ordem de índice.
+static void keys_insertion_sort(uint64_t *bits, size_t *idx, size_t n) {
+  for (size_t i = 1; i < n; ++i) {
+    const uint64_t b = bits[i];
+    const size_t x = idx[i];
+    size_t j = i;
+    while (j > 0 && keys_less(b, x, bits[j - 1], idx[j - 1])) {
+      bits[j] = bits[j - 1];
+      idx[j] = idx[j - 1];
+      --j;
+    }
+    bits[j] = b;
+    idx[j] = x;
+  }
+}
+
+/*
+ * Radix sort LSD estável de (bits, idx). Os dados de entrada estão em
+ * (bits, idx) e (bits_tmp, idx_tmp) é usado como buffer de troca. O resultado
+ * final é garantidamente escrito em idx (os bits não são copiados de volta).
+ */
+static void keys_radix_sort(hscopt_workspace *ws, uint64_t *bits,
+                            uint64_t *bits_tmp, size_t *idx, size_t *idx_tmp,
+                            size_t n) {
+  if (n <= KEYS_SMALL_N) {
+    keys_insertion_sort(bits, idx, n);
+    return;
+  }
+
+  // Todos os histogramas em uma única leitura das chaves.
+  memset(ws->hist, 0, sizeof(ws->hist));
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t u = bits[i];
+    for (unsigned p = 0; p < KEYS_RADIX_PASSES; ++p) {
+      ++ws->hist[p][(u >> (p * KEYS_RADIX_BITS)) & (KEYS_RADIX_BINS - 1)];
+    }
+  }
+
+  uint64_t *src_b = bits, *dst_b = bits_tmp;
+  size_t *src_i = idx, *dst_i = idx_tmp;
+
+  for (unsigned p = 0; p < KEYS_RADIX_PASSES; ++p) {
+    size_t *const h = ws->hist[p];
+    const unsigned shift = p * KEYS_RADIX_BITS;
+
+    // Passada trivial: todas as chaves têm o mesmo dígito.
+    if (h[(src_b[0] >> shift) & (KEYS_RADIX_BINS - 1)] == n) continue;
+
+    size_t sum = 0;
+    for (unsigned b = 0; b < KEYS_RADIX_BINS; ++b) {
+      const size_t c = h[b];
+      h[b] = sum;
+      sum += c;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      const uint64_t u = src_b[i];
+      const size_t pos = h[(u >> shift) & (KEYS_RADIX_BINS - 1)]++;
+      dst_b[pos] = u;
+      dst_i[pos] = src_i[i];
+    }
+
+    HSCOPT_SWAP(uint64_t *, src_b, dst_b);
+    HSCOPT_SWAP(size_t *, src_i, dst_i);
+  }
+
+  if (src_i != idx) {
+    memcpy(idx, src_i, n * sizeof(size_t));
+  }
+}
+
+// Argsort de um bloco contíguo, índices locais escritos em perm.
+static void keys_argsort_block(const double *keys, size_t n, size_t *perm,
+                               hscopt_workspace *ws) {
+  uint64_t *const bits = ws->bits;
+  keys_to_bits(keys, n, bits);
+  for (size_t i = 0; i < n; ++i) perm[i] = i;
+  keys_radix_sort(ws, bits, bits + ws->capacity, perm, ws->idx, n);
+}
+
+/*
+ * Retorna o par (bits, idx) de posto k (0-based) pela ordem total.
+ * Quickselect com mediana de três; destrói a ordem de (bits, idx).
+ */
+static void keys_select_kth(uint64_t *bits, size_t *idx, size_t n, size_t k,
+                            uint64_t *kb, size_t *ki) {
+  size_t lo = 0, hi = n - 1;
+
+  while (hi > lo) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (keys_less(bits[mid], idx[mid], bits[lo], idx[lo])) {
+      HSCOPT_SWAP(uint64_t, bits[mid], bits[lo]);
+      HSCOPT_SWAP(size_t, idx[mid], idx[lo]);
+    }
+    if (keys_less(bits[hi], idx[hi], bits[lo], idx[lo])) {
+      HSCOPT_SWAP(uint64_t, bits[hi], bits[lo]);
+      HSCOPT_SWAP(size_t, idx[hi], idx[lo]);
+    }
+    if (keys_less(bits[hi], idx[hi], bits[mid], idx[mid])) {
+      HSCOPT_SWAP(uint64_t, bits[hi], bits[mid]);
+      HSCOPT_SWAP(size_t, idx[hi], idx[mid]);
+    }
+
+    const uint64_t pb = bits[mid];
+    const size_t pi = idx[mid];
+    size_t i = lo, j = hi;
+    while (i <= j) {
+      while (keys_less(bits[i], idx[i], pb, pi)) ++i;
+      while (keys_less(pb, pi, bits[j], idx[j])) --j;
+      if (i <= j) {
+        HSCOPT_SWAP(uint64_t, bits[i], bits[j]);
+        HSCOPT_SWAP(size_t, idx[i], idx[j]);
+        ++i;
+        if (j == 0) break;
+        --j;
+      }
+    }
+
+    if (k <= j) {
+      hi = j;
+    } else if (k >= i) {
+      lo = i;
+    } else {
+      break;
+    }
+  }
+
+  *kb = bits[k];
+  *ki = idx[k];
+}
+
+/*
+ * Escreve em out, em ordem crescente de índice, os k índices de menor
+ * (chave, índice). Deixa em ws->bits[capacity..] os bits correspondentes.
+ */
+static void keys_gather_topk(const double *keys, size_t n, size_t k,
+                             size_t *out, hscopt_workspace *ws) {
+  uint64_t *const bits = ws->bits;
+  size_t *const idx = ws->idx;
+
+  keys_to_bits(keys, n, bits);
+  for (size_t i = 0; i < n; ++i) idx[i] = i;
+
+  uint64_t tb;
+  size_t ti;
+  keys_select_kth(bits, idx, n, k - 1, &tb, &ti);
+
+  uint64_t *const sel = bits + ws->capacity;
+  size_t m = 0;
+  for (size_t i = 0; i < n && m < k; ++i) {
+    const uint64_t b = keys_bits(keys[i]);
+    if (!keys_less(tb, ti, b, i)) {
+      sel[m] = b;
+      out[m] = i;
+      ++m;
+    }
+  }
+}
+
+int hscopt_keys_argsort(const double *keys, size_t n, size_t *perm,
+                        hscopt_workspace *ws) {
+  if (!keys || !perm || !ws) {
+    return 1;
+  }
+  if (n > ws->capacity) {
+    return 2;
+  }
+  if (n == 0) {
+    return 0;
+  }
+
+  keys_argsort_block(keys, n, perm, ws);
+  return 0;
+}
+
+int hscopt_keys_partial_argsort(const double *keys, size_t n, size_t k,
+                                size_t *perm, hscopt_workspace *ws) {
+  if (!keys || !perm || !ws) {
+    return 1;
+  }
+  if (n > ws->capacity) {
+    return 2;
+  }
+  if (k > n) k = n;
+  if (k == 0) {
+    return 0;
+  }
+  if (k == n) {
+    keys_argsort_block(keys, n, perm, ws);
+    return 0;
+  }
+
+  keys_gather_topk(keys, n, k, perm, ws);
+
+  // Os k selecionados estão em ordem de índice: o radix estável sobre os
+  // bits reproduz a ordem (chave, índice). O espaço de bits[0..capacity) e
+  // idx já foram usados pela seleção e podem ser reaproveitados.
+  uint64_t *const sel = ws->bits + ws->capacity;
+  keys_radix_sort(ws, sel, ws->bits, perm, ws->idx, k);
+  return 0;
+}
+
+int hscopt_keys_select_topk(const double *keys, size_t n, size_t k,
+                            size_t *out, hscopt_workspace *ws) {
+  if (!keys || !out || !ws) {
+    return 1;
+  }
+  if (n > ws->capacity) {
+    return 2;
+  }
+  if (k > n) k = n;
+  if (k == 0) {
+    return 0;
+  }
+  if (k == n) {
+    for (size_t i = 0; i < n; ++i) out[i] = i;
+    return 0;
+  }
+
+  keys_gather_topk(keys, n, k, out, ws);
+  return 0;
+}
+
+int hscopt_keys_argsort_grouped(const double *keys, const size_t *offsets,
+                                size_t n_groups, size_t *perm,
+                                hscopt_workspace *ws) {
+  if (!keys || !offsets || !perm || !ws || offsets[0] != 0) {
+    return 1;
+  }
+
+  for (size_t g = 0; g < n_groups; ++g) {
+    if (offsets[g + 1] < offsets[g]) {
+      return 1;
+    }
+    if (offsets[g + 1] - offsets[g] > ws->capacity) {
+      return 2;
+    }
+  }
+
+  for (size_t g = 0; g < n_groups; ++g) {
+    const size_t off = offsets[g];
+    const size_t len = offsets[g + 1] - off;
+    if (len == 0) continue;
+    keys_argsort_block(keys + off, len, perm + off, ws);
+  }
+
+  return 0;
+}
+
+#define PERM_NIL SIZE_MAX
+
+struct hscopt_keys_perm {
+  size_t n;
+  size_t root;
+  uint64_t *bits;  // chave transformada por índice [n]
+  size_t *left;    // filho esquerdo por índice [n]
+  size_t *right;   // filho direito por índice [n]
+  size_t *size;    // tamanho da subárvore por índice [n]
+  hscopt_workspace *ws;
+
+  hscopt_allocator alloc;
+};
+
+// Prioridade da treap: hash fixo do índice (árvore determinística).
+HSCOPT_INLINE uint64_t perm_prio(size_t j) {
+  uint64_t z = (uint64_t)j + UINT64_C(0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+  return z ^ (z >> 31);
+}
+
+HSCOPT_INLINE int perm_prio_less(size_t a, size_t b) {
+  const uint64_t pa = perm_prio(a), pb = perm_prio(b);
+  return pa < pb || (pa == pb && a > b);
+}
+
+HSCOPT_INLINE size_t perm_sz(const hscopt_keys_perm *p, size_t t) {
+  return t == PERM_NIL ? 0u : p->size[t];
+}
+
+HSCOPT_INLINE void perm_pull(hscopt_keys_perm *p, size_t t) {
+  p->size[t] = 1u + perm_sz(p, p->left[t]) + perm_sz(p, p->right[t]);
+}
+
+hscopt_keys_perm *hscopt_keys_perm_create(size_t n) {
+  return hscopt_keys_perm_create_with_allocator(n, NULL);
+}
+
+hscopt_keys_perm *hscopt_keys_perm_create_with_allocator(
+    size_t n, const hscopt_allocator *alloc) {
+  if (n == 0) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_keys_perm *p =
+      (hscopt_keys_perm *)hscopt_calloc(&resolved, 1, sizeof(*p));
+  if (!p) {
+    return NULL;
+  }
+  p->alloc = resolved;
+  p->n = n;
+  p->root = PERM_NIL;
+
+  p->bits = (uint64_t *)hscopt_alloc(&p->alloc, n * sizeof(uint64_t));
+  p->left = (size_t *)hscopt_alloc(&p->alloc, n * sizeof(size_t));
+  p->right = (size_t *)hscopt_alloc(&p->alloc, n * sizeof(size_t));
+  p->size = (size_t *)hscopt_alloc(&p->alloc, n * sizeof(size_t));
+  p->ws = hscopt_workspace_create_with_allocator(n, &p->alloc);
+
+  if (!p->bits || !p->left || !p->right || !p->size || !p->ws) {
+    hscopt_keys_perm_destroy(p);
+    return NULL;
+  }
+
+  return p;
+}
+
+void hscopt_keys_perm_destroy(hscopt_keys_perm *p) {
+  if (!p) return;
+  hscopt_free(&p->alloc, p->bits);
+  hscopt_free(&p->alloc, p->left);
+  hscopt_free(&p->alloc, p->right);
+  hscopt_free(&p->alloc, p->size);
+  hscopt_workspace_destroy(p->ws);
+  hscopt_free(&p->alloc, p);
+}
+
+size_t hscopt_keys_perm_size(const hscopt_keys_perm *p) {
+  return p ? p->n : 0u;
+}
+
+static size_t perm_fix_sizes(hscopt_keys_perm *p, size_t t) {
+  if (t == PERM_NIL) return 0;
+  p->size[t] =
+      1u + perm_fix_sizes(p, p->left[t]) + perm_fix_sizes(p, p->right[t]);
+  return p->size[t];
+}
+
+int hscopt_keys_perm_build(hscopt_keys_perm *p, const double *keys) {
+  if (!p || !keys) {
+    return 1;
+  }
+
+  // O vetor size serve de saída temporária do argsort.
+  size_t *const order = p->size;
+  keys_argsort_block(keys, p->n, order, p->ws);
+  keys_to_bits(keys, p->n, p->bits);
+
+  // Árvore cartesiana em O(n) a partir da ordem, pilha em ws->idx.
+  size_t *const stack = p->ws->idx;
+  size_t top = 0;
+  for (size_t r = 0; r < p->n; ++r) {
+    const size_t j = order[r];
+    size_t last = PERM_NIL;
+    while (top > 0 && perm_prio_less(stack[top - 1], j)) {
+      last = stack[--top];
+    }
+    p->left[j] = last;
+    p->right[j] = PERM_NIL;
+    if (top > 0) p->right[stack[top - 1]] = j;
+    stack[top++] = j;
+  }
+  p->root = stack[0];
+
+  perm_fix_sizes(p, p->root);
+  return 0;
+}
+
+// Junta a e b (todas as chaves de a menores que as de b).
+static size_t perm_merge(hscopt_keys_perm *p, size_t a, size_t b) {
+  if (a == PERM_NIL) return b;
+  if (b == PERM_NIL) return a;
+  if (perm_prio_less(b, a)) {
+    p->right[a] = perm_merge(p, p->right[a], b);
+    perm_pull(p, a);
+    return a;
+  }
+  p->left[b] = perm_merge(p, a, p->left[b]);
+  perm_pull(p, b);
+  return b;
+}
+
+// Divide t em (< j) e (>= j) pela ordem (bits, índice).
+static void perm_split(hscopt_keys_perm *p, size_t t, uint64_t b, size_t j,
+                       size_t *l, size_t *r) {
+  if (t == PERM_NIL) {
+    *l = *r = PERM_NIL;
+    return;
+  }
+  if (keys_less(p->bits[t], t, b, j)) {
+    perm_split(p, p->right[t], b, j, &p->right[t], r);
+    *l = t;
+  } else {
+    perm_split(p, p->left[t], b, j, l, &p->left[t]);
+    *r = t;
+  }
+  perm_pull(p, t);
+}
+
+// Remove j da subárvore t (j precisa estar presente).
+static size_t perm_erase(hscopt_keys_perm *p, size_t t, size_t j) {
+  if (t == j) {
+    return perm_merge(p, p->left[t], p->right[t]);
+  }
+  if (keys_less(p->bits[j], j, p->bits[t], t)) {
+    p->left[t] = perm_erase(p, p->left[t], j);
+  } else {
+    p->right[t] = perm_erase(p, p->right[t], j);
+  }
+  --p->size[t];
+  return t;
+}
+
+static size_t perm_insert(hscopt_keys_perm *p, size_t t, size_t j) {
+  if (t == PERM_NIL) {
+    return j;
+  }
+  if (perm_prio_less(t, j)) {
+    perm_split(p, t, p->bits[j], j, &p->left[j], &p->right[j]);
+    perm_pull(p, j);
+    return j;
+  }
+  if (keys_less(p->bits[j], j, p->bits[t], t)) {
+    p->left[t] = perm_insert(p, p->left[t], j);
+  } else {
+    p->right[t] = perm_insert(p, p->right[t], j);
+  }
+  ++p->size[t];
+  return t;
+}
+
+int hscopt_keys_perm_update(hscopt_keys_perm *p, size_t j, double key) {
+  if (!p || j >= p->n || p->root == PERM_NIL) {
+    return 1;
+  }
+
+  const uint64_t b = keys_bits(key);
+  if (b == p->bits[j]) {
+    return 0;
+  }
+
+  p->root = perm_erase(p, p->root, j);
+  p->bits[j] = b;
+  p->left[j] = p->right[j] = PERM_NIL;
+  p->size[j] = 1;
+  p->root = perm_insert(p, p->root, j);
+  return 0;
+}
+
+size_t hscopt_keys_perm_select(const hscopt_keys_perm *p, size_t r) {
+  if (!p || r >= p->n || p->root == PERM_NIL) {
+    return SIZE_MAX;
+  }
+
+  size_t t = p->root;
+  for (;;) {
+    const size_t ls = perm_sz(p, p->left[t]);
+    if (r < ls) {
+      t = p->left[t];
+    } else if (r == ls) {
+      return t;
+    } else {
+      r -= ls + 1;
+      t = p->right[t];
+    }
+  }
+}
+
+size_t hscopt_keys_perm_rank(const hscopt_keys_perm *p, size_t j) {
+  if (!p || j >= p->n || p->root == PERM_NIL) {
+    return SIZE_MAX;
+  }
+
+  const uint64_t b = p->bits[j];
+  size_t t = p->root;
+  size_t rank = 0;
+  while (t != j) {
+    if (keys_less(b, j, p->bits[t], t)) {
+      t = p->left[t];
+    } else {
+      rank += perm_sz(p, p->left[t]) + 1;
+      t = p->right[t];
+    }
+  }
+  return rank + perm_sz(p, p->left[j]);
+}
+
+static size_t perm_inorder(const hscopt_keys_perm *p, size_t t, size_t *out,
+                           size_t pos) {
+  while (t != PERM_NIL) {
+    pos = perm_inorder(p, p->left[t], out, pos);
+    out[pos++] = t;
+    t = p->right[t];
+  }
+  return pos;
+}
+
+int hscopt_keys_perm_to_array(const hscopt_keys_perm *p, size_t *perm) {
+  if (!p || !perm || p->root == PERM_NIL) {
+    return 1;
+  }
+  perm_inorder(p, p->root, perm, 0);
+  return 0;
+}
@@ -0,0 +1,331 @@
+#ifdef __linux__
+  #define _GNU_SOURCE
+#endif
+
+#include "hscopt/mmap_alloc.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define HSCOPT_MMAP_POSIX 1
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#define MMAP_MAGIC UINT64_C(0x31706d6d61637368)  // "hscammp1"
+#define MMAP_HUGE_SIZE ((size_t)2u << 20)        // 2 MiB
+#define MMAP_MIN_ALIGN ((size_t)64u)
+#define MMAP_PATH_MAX 4096
+#define MMAP_FILE_TRIES 1024u  // arquivos existentes pulados por alocação
+
+enum {
+  MMAP_KIND_HEAP = 0,
+  MMAP_KIND_HUGETLB,
+  MMAP_KIND_THP,
+  MMAP_KIND_PAGES,
+  MMAP_KIND_FILE,
+  MMAP_KIND_COUNT
+};
+
+// Cabeçalho gravado imediatamente antes do ponteiro retornado.
+typedef struct mmap_hdr {
+  uint64_t magic;
+  uint32_t kind;
+  uint32_t zeroed;   // conteúdo já zerado (mapeamento novo)
+  void *base;        // início do mapeamento (ou do bloco do heap)
+  size_t len;        // tamanho do mapeamento
+  uint64_t file_id;  // n do arquivo "<prefix>.<n>" (modo arquivo)
+} mmap_hdr;
+
+struct hscopt_mmap_allocator {
+  hscopt_mmap_opts opts;
+  char *prefix;  // cópia de opts.file_prefix
+  atomic_ullong next_file;
+  atomic_size_t bytes[MMAP_KIND_COUNT];
+};
+
+static size_t mmap_round_up(size_t x, size_t a) {
+  return (x + a - 1u) / a * a;
+}
+
+static size_t mmap_align(size_t alignment) {
+  size_t a = MMAP_MIN_ALIGN;
+  while (a < alignment) a <<= 1;
+  return a;
+}
+
+void hscopt_mmap_opts_default(hscopt_mmap_opts *out) {
+  if (!out) return;
+  out->min_size = MMAP_HUGE_SIZE;
+  out->huge_pages = 0;
+  out->file_prefix = NULL;
+  out->keep_files = 0;
+}
+
+#ifdef HSCOPT_MMAP_POSIX
+
+static int mmap_file_path(const hscopt_mmap_allocator *m, uint64_t id,
+                          char *path) {
+  const int n = snprintf(path, MMAP_PATH_MAX, "%s.%llu", m->prefix,
+                         (unsigned long long)id);
+  return n > 0 && n < MMAP_PATH_MAX ? 0 : 1;
+}
+
+// Mapeamento anônimo: hugetlb → THP (alinhado a 2 MiB) → páginas normais.
+static void *mmap_anon(const hscopt_mmap_allocator *m, size_t total,
+                       mmap_hdr *h) {
+  void *p;
+  if (m->opts.huge_pages) {
+  #ifdef MAP_HUGETLB
+    h->len = mmap_round_up(total, MMAP_HUGE_SIZE);
+    p = mmap(NULL, h->len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      h->kind = MMAP_KIND_HUGETLB;
+      return p;
+    }
+  #endif
+  #ifdef MADV_HUGEPAGE
+    h->len = mmap_round_up(total, MMAP_HUGE_SIZE);
+    const size_t raw_len = h->len + MMAP_HUGE_SIZE;
+    char *raw = (char *)mmap(NULL, raw_len, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void *)raw != MAP_FAILED) {
+      char *a = (char *)mmap_round_up((size_t)(uintptr_t)raw, MMAP_HUGE_SIZE);
+      if (a > raw) munmap(raw, (size_t)(a - raw));
+      const size_t tail = (size_t)(raw + raw_len - (a + h->len));
+      if (tail > 0) munmap(a + h->len, tail);
+      h->kind = (madvise(a, h->len, MADV_HUGEPAGE) == 0 ? MMAP_KIND_THP
+                                                         : MMAP_KIND_PAGES);
+      return a;
+    }
+  #endif
+  }
+
+  h->len = mmap_round_up(total, (size_t)sysconf(_SC_PAGESIZE));
+  p = mmap(NULL, h->len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+           -1, 0);
+  if (p == MAP_FAILED) return NULL;
+  h->kind = MMAP_KIND_PAGES;
+  return p;
+}
+
+// Abre "<prefix>.<n>" para a próxima alocação. Sem keep_files, o arquivo é
+// sempre criado (O_EXCL): um n já existente, de outro alocador ou processo
+// com o mesmo prefixo, é pulado, para que os buffers nunca se sobreponham.
+static int mmap_file_open(hscopt_mmap_allocator *m, mmap_hdr *h,
+                          char *path) {
+  const int flags = O_RDWR | O_CREAT | (m->opts.keep_files ? 0 : O_EXCL);
+  for (unsigned t = 0; t < MMAP_FILE_TRIES; ++t) {
+    h->file_id = (uint64_t)atomic_fetch_add(&m->next_file, 1u);
+    if (mmap_file_path(m, h->file_id, path) != 0) return -1;
+    const int fd = open(path, flags, 0600);
+    if (fd >= 0 || errno != EEXIST) return fd;
+  }
+  return -1;
+}
+
+// Mapeamento compartilhado de "<prefix>.<n>"; reaproveita o arquivo se
+// keep_files e o tamanho coincidir.
+static void *mmap_file(hscopt_mmap_allocator *m, size_t total, mmap_hdr *h) {
+  char path[MMAP_PATH_MAX];
+  const int fd = mmap_file_open(m, h, path);
+  if (fd < 0) return NULL;
+
+  h->len = mmap_round_up(total, (size_t)sysconf(_SC_PAGESIZE));
+  struct stat st;
+  const int reuse = m->opts.keep_files && fstat(fd, &st) == 0 &&
+                    (size_t)st.st_size == h->len;
+  if (!reuse && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)h->len) != 0)) {
+    close(fd);
+    unlink(path);
+    return NULL;
+  }
+
+  void *p = mmap(NULL, h->len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    if (!reuse) unlink(path);
+    return NULL;
+  }
+  #ifdef MADV_HUGEPAGE
+  if (m->opts.huge_pages) madvise(p, h->len, MADV_HUGEPAGE);
+  #endif
+
+  h->kind = MMAP_KIND_FILE;
+  h->zeroed = !reuse;
+  return p;
+}
+
+static void mmap_unmap(const hscopt_mmap_allocator *m, const mmap_hdr *h) {
+  munmap(h->base, h->len);
+  if (h->kind == MMAP_KIND_FILE && !m->opts.keep_files) {
+    char path[MMAP_PATH_MAX];
+    if (mmap_file_path(m, h->file_id, path) == 0) unlink(path);
+  }
+}
+
+#else /* !HSCOPT_MMAP_POSIX */
+
+static void *mmap_anon(const hscopt_mmap_allocator *m, size_t total,
+                       mmap_hdr *h) {
+  (void)m;
+  (void)total;
+  (void)h;
+  return NULL;
+}
+
+static void *mmap_file(hscopt_mmap_allocator *m, size_t total, mmap_hdr *h) {
+  (void)m;
+  (void)total;
+  (void)h;
+  return NULL;
+}
+
+static void mmap_unmap(const hscopt_mmap_allocator *m, const mmap_hdr *h) {
+  (void)m;
+  (void)h;
+}
+
+#endif /* HSCOPT_MMAP_POSIX */
+
+static void *mmap_backend_alloc_hdr(hscopt_mmap_allocator *m, size_t size,
+                                    size_t alignment, int *zeroed) {
+  const size_t align = mmap_align(alignment);
+  const size_t off = mmap_round_up(sizeof(mmap_hdr), align);
+  if (size > SIZE_MAX - off - align) {
+    return NULL;
+  }
+  const size_t total = off + size;
+
+  mmap_hdr h;
+  memset(&h, 0, sizeof(h));
+  h.magic = MMAP_MAGIC;
+  h.base = NULL;
+
+  if (size >= m->opts.min_size) {
+    if (m->prefix) h.base = mmap_file(m, total, &h);
+    if (!h.base) {
+      h.zeroed = 1;
+      h.base = mmap_anon(m, total, &h);
+    }
+  }
+  if (!h.base) {
+    h.kind = MMAP_KIND_HEAP;
+    h.zeroed = 0;
+    h.len = mmap_round_up(total, align);
+    h.base = aligned_alloc(align, h.len);
+    if (!h.base) return NULL;
+  }
+
+  atomic_fetch_add(&m->bytes[h.kind], h.len);
+  char *ptr = (char *)h.base + off;
+  memcpy(ptr - sizeof(mmap_hdr), &h, sizeof(h));
+  *zeroed = (int)h.zeroed;
+  return ptr;
+}
+
+static void *mmap_backend_alloc(size_t size, size_t alignment, void *user) {
+  int zeroed;
+  return mmap_backend_alloc_hdr((hscopt_mmap_allocator *)user, size,
+                                alignment, &zeroed);
+}
+
+static void *mmap_backend_calloc(size_t count, size_t size, size_t alignment,
+                                 void *user) {
+  if (size != 0 && count > SIZE_MAX / size) {
+    return NULL;
+  }
+  int zeroed;
+  void *p = mmap_backend_alloc_hdr((hscopt_mmap_allocator *)user,
+                                   count * size, alignment, &zeroed);
+  if (p && !zeroed) memset(p, 0, count * size);
+  return p;
+}
+
+static void mmap_backend_free(void *ptr, void *user) {
+  if (!ptr) return;
+  hscopt_mmap_allocator *const m = (hscopt_mmap_allocator *)user;
+
+  mmap_hdr h;
+  memcpy(&h, (char *)ptr - sizeof(mmap_hdr), sizeof(h));
+  if (h.magic != MMAP_MAGIC || h.kind >= MMAP_KIND_COUNT) {
+    return;  // não veio deste backend
+  }
+
+  atomic_fetch_sub(&m->bytes[h.kind], h.len);
+  if (h.kind == MMAP_KIND_HEAP) {
+    free(h.base);
+  } else {
+    mmap_unmap(m, &h);
+  }
+}
+
+hscopt_mmap_allocator *hscopt_mmap_allocator_create(
+    const hscopt_mmap_opts *opts) {
+  hscopt_mmap_allocator *m =
+      (hscopt_mmap_allocator *)calloc(1, sizeof(*m));
+  if (!m) {
+    return NULL;
+  }
+
+  if (opts) {
+    m->opts = *opts;
+  } else {
+    hscopt_mmap_opts_default(&m->opts);
+  }
+
+  if (m->opts.file_prefix) {
+    const size_t n = strlen(m->opts.file_prefix);
+    m->prefix = (char *)malloc(n + 1u);
+    if (!m->prefix) {
+      free(m);
+      return NULL;
+    }
+    memcpy(m->prefix, m->opts.file_prefix, n + 1u);
+  }
+  m->opts.file_prefix = m->prefix;
+
+  atomic_init(&m->next_file, 0u);
+  for (int k = 0; k < MMAP_KIND_COUNT; ++k) {
+    atomic_init(&m->bytes[k], 0u);
+  }
+  return m;
+}
+
+void hscopt_mmap_allocator_destroy(hscopt_mmap_allocator *m) {
+  if (!m) return;
+  free(m->prefix);
+  free(m);
+}
+
+void hscopt_mmap_allocator_get(hscopt_mmap_allocator *m,
+                               hscopt_allocator *out) {
+  if (!m || !out) return;
+  out->alloc = mmap_backend_alloc;
+  out->calloc = mmap_backend_calloc;
+  out->free = mmap_backend_free;
+  out->alignment = 0;
+  out->user = m;
+}
+
+void hscopt_mmap_allocator_stats(const hscopt_mmap_allocator *m,
+                                 hscopt_mmap_stats *out) {
+  if (!out) return;
+  memset(out, 0, sizeof(*out));
+  if (!m) return;
+  hscopt_mmap_allocator *const mm = (hscopt_mmap_allocator *)m;
+  out->hugetlb = atomic_load(&mm->bytes[MMAP_KIND_HUGETLB]);
+  out->thp = atomic_load(&mm->bytes[MMAP_KIND_THP]);
+  out->pages = atomic_load(&mm->bytes[MMAP_KIND_PAGES]);
+  out->file = atomic_load(&mm->bytes[MMAP_KIND_FILE]);
+  out->heap = atomic_load(&mm->bytes[MMAP_KIND_HEAP]);
+}
@@ -0,0 +1,150 @@
+#include "hscopt/pool.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <threads.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/solver.h"
+
+struct hscopt_solver_pool {
+  const hscopt_solver_vtable *vt;
+  size_t capacity;
+  size_t n_idle;
+  void **idle;  // pilha de solvers ociosos [capacity]
+
+  mtx_t lock;  // protege idle, n_idle e stats
+  hscopt_solver_pool_stats stats;
+
+  hscopt_allocator alloc;
+};
+
+hscopt_solver_pool *hscopt_solver_pool_create(const hscopt_solver_vtable *vt,
+                                              size_t capacity) {
+  return hscopt_solver_pool_create_with_allocator(vt, capacity, NULL);
+}
+
+hscopt_solver_pool *hscopt_solver_pool_create_with_allocator(
+    const hscopt_solver_vtable *vt, size_t capacity,
+    const hscopt_allocator *alloc) {
+  if (!vt || !vt->create || !vt->destroy || !vt->reconfigure ||
+      capacity == 0) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_solver_pool *pool =
+      (hscopt_solver_pool *)hscopt_calloc(&resolved, 1, sizeof(*pool));
+  if (!pool) {
+    return NULL;
+  }
+  pool->alloc = resolved;
+  pool->vt = vt;
+  pool->capacity = capacity;
+
+  if (mtx_init(&pool->lock, mtx_plain) != thrd_success) {
+    hscopt_free(&pool->alloc, pool);
+    return NULL;
+  }
+  pool->idle = (void **)hscopt_calloc(&pool->alloc, capacity, sizeof(void *));
+  if (!pool->idle) {
+    hscopt_solver_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void hscopt_solver_pool_destroy(hscopt_solver_pool *pool) {
+  if (!pool) return;
+  for (size_t i = 0; i < pool->n_idle; ++i) {
+    pool->vt->destroy(pool->idle[i]);
+  }
+  mtx_destroy(&pool->lock);
+  hscopt_free(&pool->alloc, pool->idle);
+  hscopt_free(&pool->alloc, pool);
+}
+
+void *hscopt_solver_pool_acquire(hscopt_solver_pool *pool,
+                                 const hscopt_solver_config *cfg) {
+  if (!pool || !cfg) {
+    return NULL;
+  }
+
+  mtx_lock(&pool->lock);
+  void *solver = (pool->n_idle > 0 ? pool->idle[--pool->n_idle] : NULL);
+  mtx_unlock(&pool->lock);
+
+  // Reconfiguração e criação ficam fora do lock: reavaliam a população.
+  int reused = 0, dropped = 0;
+  if (solver) {
+    if (pool->vt->reconfigure(solver, cfg) == 0) {
+      reused = 1;
+    } else {
+      pool->vt->destroy(solver);
+      solver = NULL;
+      dropped = 1;
+    }
+  }
+  if (!solver) {
+    solver = pool->vt->create(cfg);
+  }
+
+  mtx_lock(&pool->lock);
+  pool->stats.drops += (uint64_t)dropped;
+  if (solver) {
+    ++pool->stats.acquires;
+    if (reused) {
+      ++pool->stats.reuses;
+    } else {
+      ++pool->stats.creates;
+    }
+  }
+  mtx_unlock(&pool->lock);
+  return solver;
+}
+
+void hscopt_solver_pool_release(hscopt_solver_pool *pool, void *solver) {
+  if (!pool || !solver) return;
+
+  mtx_lock(&pool->lock);
+  const int kept = (pool->n_idle < pool->capacity);
+  if (kept) {
+    pool->idle[pool->n_idle++] = solver;
+  } else {
+    ++pool->stats.drops;
+  }
+  mtx_unlock(&pool->lock);
+
+  if (!kept) {
+    pool->vt->destroy(solver);
+  }
+}
+
+size_t hscopt_solver_pool_idle(hscopt_solver_pool *pool) {
+  if (!pool) return 0u;
+  mtx_lock(&pool->lock);
+  const size_t n = pool->n_idle;
+  mtx_unlock(&pool->lock);
+  return n;
+}
+
+void hscopt_solver_pool_get_stats(hscopt_solver_pool *pool,
+                                  hscopt_solver_pool_stats *out) {
+  if (!out) return;
+  if (!pool) {
+    memset(out, 0, sizeof(*out));
+    return;
+  }
+  mtx_lock(&pool->lock);
+  *out = pool->stats;
+  mtx_unlock(&pool->lock);
+}
@@ -0,0 +1,250 @@
+#include "hscopt/portfolio.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <threads.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/solver.h"
+
+typedef struct portfolio_slot {
+  const hscopt_solver_vtable *vt;
+  void *solver;
+  unsigned max_iters;
+  unsigned round;  // iterações da rodada atual (0 = parada)
+  double start;    // melhor fitness do slot no início da rodada
+  double score;    // melhor fitness próprio ao fim da rodada
+  int rc;          // retorno de iterate na rodada
+  int alive;
+  thrd_t thread;
+  int joinable;
+} portfolio_slot;
+
+void hscopt_portfolio_opts_default(hscopt_portfolio_opts *out) {
+  if (!out) return;
+  out->max_threads = 1u;
+  out->round_iters = 10u;
+  out->keep_fraction = 0.5;
+  out->share_incumbent = 1;
+}
+
+static int portfolio_run_slot(void *arg) {
+  portfolio_slot *const s = (portfolio_slot *)arg;
+  s->rc = s->vt->iterate(s->solver, s->round);
+  return 0;
+}
+
+static void portfolio_kill(portfolio_slot *s) {
+  s->alive = 0;
+  s->vt->destroy(s->solver);
+  s->solver = NULL;
+}
+
+static void portfolio_release(portfolio_slot *slots, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (slots[i].solver) slots[i].vt->destroy(slots[i].solver);
+    slots[i].solver = NULL;
+  }
+}
+
+// Roda os slots [lo, hi) com rodada pendente, em paralelo. O último roda
+// na própria thread chamadora.
+static int portfolio_wave(portfolio_slot *slots, size_t lo, size_t hi) {
+  size_t last = hi;
+  for (size_t i = lo; i < hi; ++i) {
+    if (slots[i].alive && slots[i].round > 0) last = i;
+  }
+
+  int err = 0;
+  for (size_t i = lo; i < hi; ++i) {
+    portfolio_slot *const s = &slots[i];
+    if (!s->alive || s->round == 0) continue;
+    if (i == last) {
+      portfolio_run_slot(s);
+    } else if (thrd_create(&s->thread, portfolio_run_slot, s) ==
+               thrd_success) {
+      s->joinable = 1;
+    } else {
+      err = 1;
+      portfolio_run_slot(s);
+    }
+  }
+
+  for (size_t i = lo; i < hi; ++i) {
+    if (slots[i].joinable) {
+      thrd_join(slots[i].thread, NULL);
+      slots[i].joinable = 0;
+    }
+  }
+
+  return err;
+}
+
+// Roda a rodada atual de todos os slots ativos, no máximo @p cap ao mesmo
+// tempo: com mais slots que threads, em ondas de @p cap slots.
+static int portfolio_round(portfolio_slot *slots, size_t n, unsigned cap) {
+  int err = 0;
+  size_t lo = 0;
+  while (lo < n) {
+    size_t hi = lo, running = 0;
+    while (hi < n && running < cap) {
+      running += (size_t)(slots[hi].alive && slots[hi].round > 0);
+      ++hi;
+    }
+    err |= portfolio_wave(slots, lo, hi);
+    lo = hi;
+  }
+  return err;
+}
+
+int hscopt_portfolio_run(const hscopt_portfolio_entry *entries, size_t n,
+                         const hscopt_portfolio_opts *opts, double *best_keys,
+                         hscopt_portfolio_result *out) {
+  if (!entries || n == 0 || !best_keys) {
+    return 1;
+  }
+
+  hscopt_portfolio_opts o;
+  if (opts) {
+    o = *opts;
+  } else {
+    hscopt_portfolio_opts_default(&o);
+  }
+  if (o.max_threads == 0) o.max_threads = 1u;
+  if (o.round_iters == 0) o.round_iters = 1u;
+  if (!(o.keep_fraction > 0.0) || o.keep_fraction > 1.0) o.keep_fraction = 0.5;
+
+  const size_t dim = entries[0].cfg.dim;
+  for (size_t i = 0; i < n; ++i) {
+    if (!entries[i].vt || entries[i].cfg.dim != dim) {
+      return 1;
+    }
+  }
+
+  hscopt_allocator alloc;
+  hscopt_get_allocator(&alloc);
+  portfolio_slot *slots =
+      (portfolio_slot *)hscopt_calloc(&alloc, n, sizeof(portfolio_slot));
+  if (!slots) {
+    return 2;
+  }
+
+  // Divide o orçamento de threads entre as entradas; com mais entradas que
+  // threads, cada uma usa uma thread e as rodadas andam em ondas.
+  const unsigned share =
+      (o.max_threads >= n ? o.max_threads / (unsigned)n : 1u);
+  int rc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    hscopt_solver_config cfg = entries[i].cfg;
+    cfg.max_threads = share;
+    slots[i].vt = entries[i].vt;
+    slots[i].solver = entries[i].vt->create(&cfg);
+    slots[i].max_iters = cfg.max_iters;
+    slots[i].alive = 1;
+    slots[i].start = INFINITY;
+    if (!slots[i].solver) rc = 2;
+  }
+
+  double best = INFINITY;
+  size_t winner = 0;
+  unsigned rounds = 0;
+  unsigned budget = o.round_iters;
+
+  while (rc == 0) {
+    size_t n_alive = 0, n_run = 0;
+    for (size_t i = 0; i < n; ++i) n_alive += (size_t)slots[i].alive;
+
+    for (size_t i = 0; i < n; ++i) {
+      portfolio_slot *const s = &slots[i];
+      if (!s->alive) continue;
+      const unsigned it = s->vt->iteration(s->solver);
+      const unsigned left = (it < s->max_iters ? s->max_iters - it : 0u);
+      // A sobrevivente única roda até o fim.
+      s->round = (n_alive == 1 || left < budget ? left : budget);
+      s->rc = 0;
+      if (s->round > 0) ++n_run;
+    }
+    if (n_run == 0) break;
+
+    if (portfolio_round(slots, n, o.max_threads) != 0) rc = 3;
+    ++rounds;
+
+    // Fitness próprio de cada slot, antes do compartilhamento, e o melhor
+    // global.
+    for (size_t i = 0; i < n; ++i) {
+      portfolio_slot *const s = &slots[i];
+      if (!s->alive) continue;
+      s->score = s->vt->best_fitness(s->solver);
+      if (s->score < best) {
+        best = s->score;
+        winner = i;
+        memcpy(best_keys, s->vt->best_keys(s->solver), dim * sizeof(double));
+      }
+    }
+
+    // Solver cujo iterate falhou sai do portfólio (o seu melhor até aqui
+    // ainda conta); sem sobreviventes, o portfólio termina com erro.
+    for (size_t i = 0; i < n; ++i) {
+      if (slots[i].alive && slots[i].rc != 0) {
+        portfolio_kill(&slots[i]);
+        --n_alive;
+      }
+    }
+    if (n_alive == 0) {
+      rc = 4;
+      break;
+    }
+
+    // Eliminação: mantém as ceil(keep * n_alive) melhores pelo fitness
+    // próprio. A dona do melhor global nunca sai; nos empates (ex.: slots
+    // que partiram do incumbente compartilhado e não melhoraram), sai a que
+    // menos melhorou na rodada e, depois, o maior índice.
+    if (n_alive > 1) {
+      size_t keep = (size_t)ceil(o.keep_fraction * (double)n_alive);
+      if (keep < 1) keep = 1;
+      while (n_alive > keep) {
+        size_t worst = n;
+        double fw = -INFINITY, gw = INFINITY;
+        for (size_t i = 0; i < n; ++i) {
+          portfolio_slot *const s = &slots[i];
+          if (!s->alive || i == winner) continue;
+          const double f = s->score;
+          const double g = (s->start < INFINITY ? s->start - f : INFINITY);
+          if (worst == n || f > fw ||
+              (f == fw && (g < gw || (g == gw && i > worst)))) {
+            worst = i;
+            fw = f;
+            gw = g;
+          }
+        }
+        portfolio_kill(&slots[worst]);
+        --n_alive;
+      }
+    }
+
+    // Compartilha o incumbente com as sobreviventes.
+    for (size_t i = 0; i < n; ++i) {
+      portfolio_slot *const s = &slots[i];
+      if (!s->alive) continue;
+      if (o.share_incumbent && i != winner && s->score > best) {
+        s->vt->inject(s->solver, best_keys);
+      }
+      s->start = s->vt->best_fitness(s->solver);
+    }
+
+    // Sobreviventes recebem rodadas proporcionalmente mais longas.
+    const double next = ceil((double)budget / o.keep_fraction);
+    budget = (next > (double)0x7fffffffu ? 0x7fffffffu : (unsigned)next);
+  }
+
+  portfolio_release(slots, n);
+  hscopt_free(&alloc, slots);
+
+  if (out) {
+    out->best_fitness = best;
+    out->winner = winner;
+    out->rounds = rounds;
+  }
+  return rc;
+}
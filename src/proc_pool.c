@@ -0,0 +1,408 @@
+#ifdef __linux__
+  #define _GNU_SOURCE
+#endif
+
+#include "hscopt/proc_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+
+#ifdef __linux__
+  #include <errno.h>
+  #include <limits.h>
+  #include <linux/futex.h>
+  #include <signal.h>
+  #include <stdatomic.h>
+  #include <sys/mman.h>
+  #include <sys/prctl.h>
+  #include <sys/syscall.h>
+  #include <sys/wait.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+#define PP_DEFAULT_SLOTS 64u    // pendentes por processo
+#define PP_ALIGN ((size_t)64u)
+#define PP_WAIT_NS 50000000L    // 50 ms entre verificações dos processos
+
+// Célula de uma fila limitada MPMC (Vyukov): seq diz de quem é a vez.
+typedef struct pp_cell {
+  _Atomic uint64_t seq;
+  uint64_t slot;
+} pp_cell;
+
+typedef struct pp_ring {
+  _Alignas(64) _Atomic uint64_t head;
+  _Alignas(64) _Atomic uint64_t tail;
+} pp_ring;
+
+// Cabeçalho da região compartilhada; seguido por anel de pedidos, anel de
+// respostas, objetivos [cap] e chaves [cap * n_keys].
+typedef struct pp_shm {
+  _Alignas(64) _Atomic uint32_t sub_seq;  // campainha dos processos
+  _Atomic uint32_t sub_waiters;
+  _Atomic uint32_t stop;
+  _Alignas(64) _Atomic uint32_t done_seq;  // campainha do pai
+  _Atomic uint32_t done_waiters;
+} pp_shm;
+
+struct hscopt_proc_pool {
+  void *shm_base;
+  size_t shm_len;
+  pp_shm *shm;
+  pp_ring *req;
+  pp_ring *done;
+  pp_cell *req_cells;
+  pp_cell *done_cells;
+  double *fit;   // [cap]
+  double *keys;  // [cap * n_keys]
+
+  size_t n_keys;
+  size_t cap;
+  unsigned n_procs;
+  pid_t *pids;
+
+  uint64_t *tags;       // tag de cada slot (só no pai)
+  uint32_t *free_slot;  // pilha de slots livres (só no pai)
+  size_t n_free;
+  hscopt_allocator alloc;
+};
+
+static size_t pp_round_up(size_t x, size_t a) {
+  return (x + a - 1u) / a * a;
+}
+
+static void pp_futex_wait(_Atomic uint32_t *addr, uint32_t val,
+                          const struct timespec *ts) {
+  syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT, val, ts, NULL, 0);
+}
+
+static void pp_futex_wake(_Atomic uint32_t *addr, int n) {
+  syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE, n, NULL, NULL, 0);
+}
+
+static void pp_ring_init(pp_ring *r, pp_cell *cells, size_t cap) {
+  atomic_init(&r->head, 0u);
+  atomic_init(&r->tail, 0u);
+  for (size_t i = 0; i < cap; ++i) {
+    atomic_init(&cells[i].seq, (uint64_t)i);
+    cells[i].slot = 0;
+  }
+}
+
+static int pp_ring_push(pp_ring *r, pp_cell *cells, size_t cap,
+                        uint64_t slot) {
+  const uint64_t mask = (uint64_t)cap - 1u;
+  uint64_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  for (;;) {
+    pp_cell *const c = &cells[pos & mask];
+    const uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    const int64_t dif = (int64_t)(seq - pos);
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1u,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        c->slot = slot;
+        atomic_store_explicit(&c->seq, pos + 1u, memory_order_release);
+        return 0;
+      }
+    } else if (dif < 0) {
+      return 1;  // cheia
+    } else {
+      pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    }
+  }
+}
+
+static int pp_ring_pop(pp_ring *r, pp_cell *cells, size_t cap,
+                       uint64_t *slot) {
+  const uint64_t mask = (uint64_t)cap - 1u;
+  uint64_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+  for (;;) {
+    pp_cell *const c = &cells[pos & mask];
+    const uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    const int64_t dif = (int64_t)(seq - (pos + 1u));
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1u,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        *slot = c->slot;
+        atomic_store_explicit(&c->seq, pos + mask + 1u, memory_order_release);
+        return 0;
+      }
+    } else if (dif < 0) {
+      return 1;  // vazia
+    } else {
+      pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    }
+  }
+}
+
+// Laço de um processo avaliador.
+static void pp_worker(hscopt_proc_pool *pp, hscopt_decoder_fn decoder,
+                      hscopt_decode_ctx *dctx) {
+  pp_shm *const sh = pp->shm;
+  for (;;) {
+    const uint32_t seq = atomic_load(&sh->sub_seq);
+    uint64_t slot;
+    if (pp_ring_pop(pp->req, pp->req_cells, pp->cap, &slot) == 0) {
+      pp->fit[slot] = decoder(&pp->keys[slot * pp->n_keys], pp->n_keys, dctx);
+      // Cabe sempre: há no máximo cap slots em circulação.
+      pp_ring_push(pp->done, pp->done_cells, pp->cap, slot);
+      atomic_fetch_add(&sh->done_seq, 1u);
+      if (atomic_load(&sh->done_waiters) > 0) {
+        pp_futex_wake(&sh->done_seq, 1);
+      }
+      continue;
+    }
+    if (atomic_load(&sh->stop)) {
+      return;
+    }
+
+    atomic_fetch_add(&sh->sub_waiters, 1u);
+    pp_futex_wait(&sh->sub_seq, seq, NULL);
+    atomic_fetch_sub(&sh->sub_waiters, 1u);
+  }
+}
+
+static int pp_submit(void *self, const double *keys, size_t n, uint64_t tag) {
+  hscopt_proc_pool *const pp = (hscopt_proc_pool *)self;
+  if (!keys || n != pp->n_keys) {
+    return 2;
+  }
+  if (pp->n_free == 0) {
+    return 1;
+  }
+
+  const uint32_t slot = pp->free_slot[--pp->n_free];
+  memcpy(&pp->keys[(size_t)slot * n], keys, n * sizeof(double));
+  pp->tags[slot] = tag;
+  pp_ring_push(pp->req, pp->req_cells, pp->cap, slot);
+
+  atomic_fetch_add(&pp->shm->sub_seq, 1u);
+  if (atomic_load(&pp->shm->sub_waiters) > 0) {
+    pp_futex_wake(&pp->shm->sub_seq, 1);
+  }
+  return 0;
+}
+
+static size_t pp_drain(hscopt_proc_pool *pp, hscopt_async_result *out,
+                       size_t max) {
+  size_t got = 0;
+  uint64_t slot;
+  while (got < max &&
+         pp_ring_pop(pp->done, pp->done_cells, pp->cap, &slot) == 0) {
+    out[got].tag = pp->tags[slot];
+    out[got].fitness = pp->fit[slot];
+    ++got;
+    pp->free_slot[pp->n_free++] = (uint32_t)slot;
+  }
+  return got;
+}
+
+// 1 se algum processo terminou (o pool não consegue mais avaliar).
+static int pp_lost_worker(const hscopt_proc_pool *pp) {
+  for (unsigned k = 0; k < pp->n_procs; ++k) {
+    if (waitpid(pp->pids[k], NULL, WNOHANG) != 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int pp_poll(void *self, hscopt_async_result *out, size_t max) {
+  return (int)pp_drain((hscopt_proc_pool *)self, out, max);
+}
+
+static int pp_wait_any(void *self, hscopt_async_result *out, size_t max) {
+  hscopt_proc_pool *const pp = (hscopt_proc_pool *)self;
+  pp_shm *const sh = pp->shm;
+  const struct timespec ts = {0, PP_WAIT_NS};
+
+  for (;;) {
+    const uint32_t seq = atomic_load(&sh->done_seq);
+    const size_t got = pp_drain(pp, out, max);
+    if (got > 0 || pp->n_free == pp->cap) {
+      return (int)got;
+    }
+
+    atomic_fetch_add(&sh->done_waiters, 1u);
+    pp_futex_wait(&sh->done_seq, seq, &ts);
+    atomic_fetch_sub(&sh->done_waiters, 1u);
+    if (atomic_load(&sh->done_seq) == seq && pp_lost_worker(pp)) {
+      return -1;
+    }
+  }
+}
+
+hscopt_proc_pool *hscopt_proc_pool_create(size_t n_keys, unsigned n_procs,
+                                          size_t capacity,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx) {
+  return hscopt_proc_pool_create_with_allocator(n_keys, n_procs, capacity,
+                                                decoder, dctx, NULL);
+}
+
+hscopt_proc_pool *hscopt_proc_pool_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t capacity,
+    hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+    const hscopt_allocator *alloc) {
+  if (!decoder || n_keys == 0) {
+    return NULL;
+  }
+  const unsigned procs = (n_procs == 0 ? 1u : n_procs);
+  size_t cap = 1;
+  const size_t want = (capacity == 0 ? (size_t)procs * PP_DEFAULT_SLOTS
+                                     : capacity);
+  while (cap < want) cap <<= 1;
+  if (cap > UINT32_MAX || n_keys > SIZE_MAX / sizeof(double) / cap) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_proc_pool *pp =
+      (hscopt_proc_pool *)hscopt_calloc(&resolved, 1, sizeof(*pp));
+  if (!pp) {
+    return NULL;
+  }
+  pp->alloc = resolved;
+  pp->n_keys = n_keys;
+  pp->cap = cap;
+
+  const size_t ring_len = pp_round_up(sizeof(pp_ring), PP_ALIGN);
+  const size_t cells_len = pp_round_up(cap * sizeof(pp_cell), PP_ALIGN);
+  const size_t off_req = pp_round_up(sizeof(pp_shm), PP_ALIGN);
+  const size_t off_done = off_req + ring_len + cells_len;
+  const size_t off_fit = off_done + ring_len + cells_len;
+  const size_t off_keys =
+      off_fit + pp_round_up(cap * sizeof(double), PP_ALIGN);
+  pp->shm_len = off_keys + cap * n_keys * sizeof(double);
+
+  pp->shm_base = mmap(NULL, pp->shm_len, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  pp->pids = (pid_t *)hscopt_calloc(&pp->alloc, procs, sizeof(pid_t));
+  pp->tags = (uint64_t *)hscopt_calloc(&pp->alloc, cap, sizeof(uint64_t));
+  pp->free_slot =
+      (uint32_t *)hscopt_calloc(&pp->alloc, cap, sizeof(uint32_t));
+  if (pp->shm_base == MAP_FAILED) {
+    pp->shm_base = NULL;
+  }
+  if (!pp->shm_base || !pp->pids || !pp->tags || !pp->free_slot) {
+    hscopt_proc_pool_destroy(pp);
+    return NULL;
+  }
+
+  char *const base = (char *)pp->shm_base;
+  pp->shm = (pp_shm *)base;
+  pp->req = (pp_ring *)(base + off_req);
+  pp->req_cells = (pp_cell *)(base + off_req + ring_len);
+  pp->done = (pp_ring *)(base + off_done);
+  pp->done_cells = (pp_cell *)(base + off_done + ring_len);
+  pp->fit = (double *)(base + off_fit);
+  pp->keys = (double *)(base + off_keys);
+
+  atomic_init(&pp->shm->sub_seq, 0u);
+  atomic_init(&pp->shm->sub_waiters, 0u);
+  atomic_init(&pp->shm->stop, 0u);
+  atomic_init(&pp->shm->done_seq, 0u);
+  atomic_init(&pp->shm->done_waiters, 0u);
+  pp_ring_init(pp->req, pp->req_cells, cap);
+  pp_ring_init(pp->done, pp->done_cells, cap);
+  for (size_t s = 0; s < cap; ++s) {
+    pp->free_slot[s] = (uint32_t)(cap - 1u - s);
+  }
+  pp->n_free = cap;
+
+  const pid_t parent = getpid();
+  for (unsigned k = 0; k < procs; ++k) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+      hscopt_proc_pool_destroy(pp);
+      return NULL;
+    }
+    if (pid == 0) {
+      // Termina junto com o pai, em vez de ficar preso no futex.
+      prctl(PR_SET_PDEATHSIG, SIGKILL);
+      if (getppid() != parent) _exit(0);
+      pp_worker(pp, decoder, dctx);
+      _exit(0);
+    }
+    pp->pids[k] = pid;
+    pp->n_procs = k + 1u;
+  }
+  return pp;
+}
+
+void hscopt_proc_pool_destroy(hscopt_proc_pool *pp) {
+  if (!pp) return;
+  if (pp->shm) {
+    atomic_store(&pp->shm->stop, 1u);
+    atomic_fetch_add(&pp->shm->sub_seq, 1u);
+    pp_futex_wake(&pp->shm->sub_seq, INT_MAX);
+  }
+  for (unsigned k = 0; k < pp->n_procs; ++k) {
+    while (waitpid(pp->pids[k], NULL, 0) < 0 && errno == EINTR) {
+    }
+  }
+  if (pp->shm_base) munmap(pp->shm_base, pp->shm_len);
+  hscopt_allocator alloc = pp->alloc;
+  hscopt_free(&alloc, pp->pids);
+  hscopt_free(&alloc, pp->tags);
+  hscopt_free(&alloc, pp->free_slot);
+  hscopt_free(&alloc, pp);
+}
+
+void hscopt_proc_pool_get(hscopt_proc_pool *pp, hscopt_async_decoder *out) {
+  if (!pp || !out) return;
+  out->submit = pp_submit;
+  out->poll = pp_poll;
+  out->wait_any = pp_wait_any;
+  out->max_in_flight = pp->cap;
+  out->self = pp;
+}
+
+#else /* !__linux__ */
+
+hscopt_proc_pool *hscopt_proc_pool_create(size_t n_keys, unsigned n_procs,
+                                          size_t capacity,
+                                          hscopt_decoder_fn decoder,
+                                          hscopt_decode_ctx *dctx) {
+  (void)n_keys;
+  (void)n_procs;
+  (void)capacity;
+  (void)decoder;
+  (void)dctx;
+  return NULL;
+}
+
+hscopt_proc_pool *hscopt_proc_pool_create_with_allocator(
+    size_t n_keys, unsigned n_procs, size_t capacity,
+    hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+    const hscopt_allocator *alloc) {
+  (void)alloc;
+  return hscopt_proc_pool_create(n_keys, n_procs, capacity, decoder, dctx);
+}
+
+void hscopt_proc_pool_destroy(hscopt_proc_pool *pp) { (void)pp; }
+
+void hscopt_proc_pool_get(hscopt_proc_pool *pp, hscopt_async_decoder *out) {
+  (void)pp;
+  (void)out;
+}
+
+#endif /* __linux__ */
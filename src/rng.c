@@ -111,3 +111,43 @@ void hscopt_rng_long_jump(hscopt_rng *rng) {
   rng->s[2] = s2;
   rng->s[3] = s3;
 }
+
+void hscopt_ctr_rng_seed(hscopt_ctr_rng *g, uint64_t seed) {
+  if (!g) return;
+
+  uint64_t x = seed;
+  const uint64_t k = hscopt_splitmix64_next(&x);
+  g->key[0] = (uint32_t)k;
+  g->key[1] = (uint32_t)(k >> 32);
+}
+
+HSCOPT_TARGET_CLONES void hscopt_ctr_rng_fill_u01(const hscopt_ctr_rng *g,
+                                                  uint64_t iter, uint32_t agent,
+                                                  uint64_t draw0, double *out,
+                                                  size_t n) {
+  if (!g || !out) return;
+
+  const double scale = 1.0 / 9007199254740992.0; /* 2^53 */
+  size_t i = 0;
+
+  // Sorteio inicial ímpar: completa o primeiro bloco.
+  if ((draw0 & 1u) && n > 0) {
+    out[i++] = hscopt_ctr_rng_u01(g, iter, agent, draw0);
+    ++draw0;
+  }
+
+  const uint32_t b0 = (uint32_t)(draw0 >> 1);
+  const size_t n_blocks = (n - i) / 2;
+  for (size_t b = 0; b < n_blocks; ++b) {
+    uint32_t c[4] = {b0 + (uint32_t)b, agent, (uint32_t)iter,
+                     (uint32_t)(iter >> 32)};
+    hscopt_philox4x32_10(c, g->key);
+    out[i + 2 * b] = (double)(((uint64_t)c[1] << 32 | c[0]) >> 11) * scale;
+    out[i + 2 * b + 1] = (double)(((uint64_t)c[3] << 32 | c[2]) >> 11) * scale;
+  }
+  i += 2 * n_blocks;
+
+  if (i < n) {
+    out[i] = hscopt_ctr_rng_u01(g, iter, agent, draw0 + 2 * n_blocks);
+  }
+}
@@ -1,35 +1,103 @@
 #include "hscopt/rvns.h"
+#include "hscopt/rvns_impl.h"
 
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "hscopt/affinity.h"
 #include "hscopt/alloc.h"
 #include "hscopt/decoder.h"
+#include "hscopt/keys.h"
 #include "hscopt/rng.h"
+#include "hscopt/solver.h"
 
-#define CAND_PTR(ctx, tid) (&(ctx)->cand_keys[(size_t)(tid) * (ctx)->dim])
-
-struct hscopt_rvns_ctx {
-  size_t dim;                 // tamanho do vetor de chaves aleatórias
-  size_t k_max;               // pertubação máxima
-  unsigned iter;              // iteração atual
-  unsigned max_iters;         // número máximo de iterações
-  unsigned max_threads;       // número máximo de threads
-  unsigned eff_threads;       // número real de threads usadas
-  hscopt_decoder_fn decoder;  // decoder
-  hscopt_decode_ctx *dctx;    // contexto do decder
-  hscopt_rng *rng_tls;        // vetor de rng[eff_threads]
-  double *x;                  // melhor atual
-  double fx;                  // melhor função objetivo
-  double *best;               // melhor global
-  double fbest;               // função objetivo do melhor global
-  double *cand_keys;          // candidatos de tamanho [dim * eff_threads]
-  double *cand_fit;           // candidatos de tamanho [eff_threads]
-
-  hscopt_allocator alloc;
-};
+#ifdef _OPENMP
+#include <omp.h>
+#endif /* ifdef _OPENMP */
+
+static hscopt_rvns_kernel_fn rvns_select_kernel(size_t dim);
+
+static void rvns_surrogate_release(hscopt_rvns_ctx *ctx) {
+  hscopt_free(&ctx->alloc, ctx->surr_v);
+  hscopt_free(&ctx->alloc, ctx->surr_idx);
+  hscopt_free(&ctx->alloc, ctx->surr_fit);
+  ctx->surr_v = NULL;
+  ctx->surr_idx = NULL;
+  ctx->surr_fit = NULL;
+}
+
+// Troca os buffers da triagem por buffers para n_cand candidatos; em falta
+// de memória, mantém os atuais e retorna 1.
+static int rvns_surrogate_alloc(hscopt_rvns_ctx *ctx, size_t n_cand) {
+  unsigned char *v = (unsigned char *)hscopt_alloc(&ctx->alloc, n_cand);
+  size_t *idx = (size_t *)hscopt_alloc(&ctx->alloc, n_cand * sizeof(size_t));
+  double *fit = (double *)hscopt_alloc(&ctx->alloc, n_cand * sizeof(double));
+  if (!v || !idx || !fit) {
+    hscopt_free(&ctx->alloc, v);
+    hscopt_free(&ctx->alloc, idx);
+    hscopt_free(&ctx->alloc, fit);
+    return 1;
+  }
+  rvns_surrogate_release(ctx);
+  ctx->surr_v = v;
+  ctx->surr_idx = idx;
+  ctx->surr_fit = fit;
+  return 0;
+}
+
+// Cria uma permutação de n chaves por thread em out[eff_threads], cada uma
+// alocada e, se x != NULL, construída a partir de x pela sua thread
+// (first-touch). Em falta de memória, libera as já criadas e retorna 1.
+static int rvns_perm_create_all(hscopt_rvns_ctx *ctx, size_t n,
+                                const double *x, hscopt_keys_perm **out) {
+  for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+    out[t] = NULL;
+  }
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ctx->eff_threads)
+#endif
+  {
+    hscopt_rvns_impl_pin(ctx);
+    const unsigned t = hscopt_rvns_impl_thread_id();
+    out[t] = hscopt_keys_perm_create_with_allocator(n, &ctx->alloc);
+    if (out[t] && x) hscopt_keys_perm_build(out[t], x);
+    hscopt_rvns_impl_unpin(ctx);
+  }
+
+  // Time menor que eff_threads (ex.: OMP_DYNAMIC): completa na chamadora.
+  int rc = 0;
+  for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+    if (!out[t]) {
+      out[t] = hscopt_keys_perm_create_with_allocator(n, &ctx->alloc);
+      if (out[t] && x) hscopt_keys_perm_build(out[t], x);
+      rc = rc || !out[t];
+    }
+  }
+  if (rc) {
+    for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+      hscopt_keys_perm_destroy(out[t]);
+      out[t] = NULL;
+    }
+  }
+  return rc;
+}
+
+static void rvns_perm_release(hscopt_rvns_ctx *ctx) {
+  if (ctx->perm_tls) {
+    for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+      hscopt_keys_perm_destroy(ctx->perm_tls[t]);
+    }
+  }
+  hscopt_free(&ctx->alloc, ctx->perm_tls);
+  hscopt_free(&ctx->alloc, ctx->dctx_tls);
+  hscopt_free(&ctx->alloc, ctx->shake_idx);
+  ctx->perm_tls = NULL;
+  ctx->dctx_tls = NULL;
+  ctx->shake_idx = NULL;
+}
 
 int hscopt_rvns_reset(hscopt_rvns_ctx *ctx, const double *x0) {
   if (!ctx) {
@@ -44,24 +112,54 @@ int hscopt_rvns_reset(hscopt_rvns_ctx *ctx, const double *x0) {
     }
   } else {
     for (size_t i = 0; i < ctx->dim; ++i) {
-      ctx->x[i] = hscopt_rng_next_u01(&ctx->rng_tls[0]);
+      ctx->x[i] = hscopt_rng_next_u01(&ctx->rng);
     }
   }
 
-  ctx->fx = ctx->decoder(ctx->x, ctx->dim, ctx->dctx);
+  // Nova chave a cada reset: o shaking depende só de (chave, step, candidato).
+  hscopt_ctr_rng_seed(&ctx->ctr, hscopt_rng_next_u64(&ctx->rng));
+  ctx->step = 0;
+  memset(ctx->nbhd, 0, ctx->k_max * sizeof(*ctx->nbhd));
+
+  hscopt_decode_ctx *dc = ctx->dctx;
+  if (ctx->perm_tls) {
+    hscopt_rvns_impl_perm_sync(ctx);
+    for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+      if (hscopt_keys_perm_build(ctx->perm_tls[t], ctx->x) != 0) {
+        return 1;
+      }
+    }
+    dc = &ctx->dctx_tls[0];
+  }
+
+  if (ctx->async.submit) {
+    const double *rows[1] = {ctx->x};
+    if (hscopt_async_eval(&ctx->async, rows, ctx->dim, 1, &ctx->fx) != 0) {
+      return 2;
+    }
+  } else {
+    ctx->fx = ctx->decoder(ctx->x, ctx->dim, dc);
+  }
+  hscopt_surrogate_add(ctx->surrogate, ctx->x, ctx->fx);
   memcpy(ctx->best, ctx->x, ctx->dim * sizeof(double));
   ctx->fbest = ctx->fx;
+  ctx->board_pub = INFINITY;
 
   return 0;
 }
 
 void hscopt_rvns_destroy(hscopt_rvns_ctx *ctx) {
   if (!ctx) return;
-  hscopt_free(&ctx->alloc, ctx->rng_tls);
+  rvns_perm_release(ctx);
   hscopt_free(&ctx->alloc, ctx->x);
   hscopt_free(&ctx->alloc, ctx->best);
   hscopt_free(&ctx->alloc, ctx->cand_keys);
   hscopt_free(&ctx->alloc, ctx->cand_fit);
+  hscopt_free(&ctx->alloc, ctx->nbhd);
+  hscopt_free(&ctx->alloc, ctx->cpus);
+  hscopt_free(&ctx->alloc, ctx->async_rows);
+  hscopt_free(&ctx->alloc, ctx->board_keys);
+  rvns_surrogate_release(ctx);
   hscopt_free(&ctx->alloc, ctx);
 }
 
@@ -78,6 +176,15 @@ hscopt_rvns_ctx *hscopt_rvns_create_with_allocator(
     const double *x0, size_t dim, size_t k_max, unsigned max_iters,
     unsigned max_threads, hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
     hscopt_rng *rng, const hscopt_allocator *alloc) {
+  return hscopt_rvns_create_with_affinity(x0, dim, k_max, max_iters,
+                                          max_threads, decoder, dctx, rng,
+                                          alloc, HSCOPT_AFFINITY_NONE);
+}
+
+hscopt_rvns_ctx *hscopt_rvns_create_with_affinity(
+    const double *x0, size_t dim, size_t k_max, unsigned max_iters,
+    unsigned max_threads, hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+    hscopt_rng *rng, const hscopt_allocator *alloc, hscopt_affinity affinity) {
   if (!decoder || !rng || max_iters == 0 || k_max == 0 || dim == 0) {
     return NULL;
   }
@@ -100,10 +207,14 @@ hscopt_rvns_ctx *hscopt_rvns_create_with_allocator(
   ctx->alloc = resolved;
 
   ctx->dim = dim;
+  ctx->kernel = rvns_select_kernel(dim);
   ctx->k_max = k_max;
+  ctx->cap_dim = dim;
+  ctx->cap_k = k_max;
   ctx->iter = 0;
   ctx->max_iters = max_iters;
   ctx->max_threads = (max_threads == 0u ? 1u : max_threads);
+  ctx->n_spec = 1u;
 
 #ifdef _OPENMP
   ctx->eff_threads = (max_threads == 0u ? 1u : max_threads);
@@ -113,32 +224,39 @@ hscopt_rvns_ctx *hscopt_rvns_create_with_allocator(
 
   ctx->decoder = decoder;
   ctx->dctx = dctx;
-  ctx->x = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
-  ctx->best = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
-  ctx->cand_keys = (double *)hscopt_alloc(
-      &ctx->alloc, (size_t)ctx->eff_threads * dim * sizeof(double));
-  ctx->cand_fit = (double *)hscopt_alloc(
-      &ctx->alloc, (size_t)ctx->eff_threads * sizeof(double));
+  ctx->rng = *rng;
 
-  if (!ctx->x || !ctx->best || !ctx->cand_keys || !ctx->cand_fit) {
-    hscopt_rvns_destroy(ctx);
-    return NULL;
+#ifdef _OPENMP
+  if (affinity != HSCOPT_AFFINITY_NONE) {
+    ctx->cpus = (int *)hscopt_alloc(&ctx->alloc,
+                                    sizeof(int) * ctx->eff_threads);
+    if (!ctx->cpus) {
+      hscopt_rvns_destroy(ctx);
+      return NULL;
+    }
+    // Plataforma sem suporte: segue sem afinidade.
+    if (hscopt_affinity_plan(affinity, ctx->eff_threads, ctx->cpus) != 0) {
+      hscopt_free(&ctx->alloc, ctx->cpus);
+      ctx->cpus = NULL;
+    }
   }
+#else
+  (void)affinity;
+#endif
+
+  ctx->x = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  ctx->best = (double *)hscopt_alloc(&ctx->alloc, dim * sizeof(double));
+  ctx->nbhd = (hscopt_rvns_nbhd_stats *)hscopt_calloc(&ctx->alloc, k_max,
+                                                       sizeof(*ctx->nbhd));
 
-  // alocação das instâncias de RNG
-  ctx->rng_tls = (hscopt_rng *)hscopt_calloc(
-      &ctx->alloc, (size_t)ctx->eff_threads, sizeof(hscopt_rng));
-  if (!ctx->rng_tls) {
+  // O número de candidatos segue max_threads (e não eff_threads) para que o
+  // resultado seja o mesmo com ou sem OpenMP.
+  if (!ctx->x || !ctx->best || !ctx->nbhd ||
+      hscopt_rvns_set_candidates(ctx, ctx->max_threads) != 0) {
     hscopt_rvns_destroy(ctx);
     return NULL;
   }
 
-  ctx->rng_tls[0] = *rng;
-  for (unsigned i = 1; i < ctx->eff_threads; ++i) {
-    ctx->rng_tls[i] = ctx->rng_tls[i - 1];
-    hscopt_rng_long_jump(&ctx->rng_tls[i]);
-  }
-
   if (hscopt_rvns_reset(ctx, x0) != 0) {
     hscopt_rvns_destroy(ctx);
     return NULL;
@@ -171,70 +289,504 @@ unsigned hscopt_rvns_max_threads(const hscopt_rvns_ctx *ctx) {
   return ctx ? ctx->eff_threads : 1u;
 }
 
-// Shaking em N_k(x), primeiro copia x para y e pertuba k posições
-HSCOPT_INLINE void rvns_shake(double *y, const double *x, size_t dim, size_t k,
-                              hscopt_rng *rng) {
-  memcpy(y, x, dim * sizeof(double));
-  if (k > dim) k = dim;
-  for (size_t t = 0; t < k; ++t) {
-    size_t j = (size_t)(hscopt_rng_next_u01(rng) * (double)dim);
-    if (j >= dim) j = dim - 1;
-    y[j] = HSCOPT_CLAMP_KEY(hscopt_rng_next_u01(rng));
+int hscopt_rvns_set_track_perm(hscopt_rvns_ctx *ctx, int enable) {
+  if (!ctx) {
+    return 1;
+  }
+  if (!enable) {
+    rvns_perm_release(ctx);
+    return 0;
+  }
+  if (ctx->perm_tls) {
+    return 0;
+  }
+
+  ctx->perm_tls = (hscopt_keys_perm **)hscopt_calloc(
+      &ctx->alloc, (size_t)ctx->eff_threads, sizeof(hscopt_keys_perm *));
+  ctx->dctx_tls = (hscopt_decode_ctx *)hscopt_calloc(
+      &ctx->alloc, (size_t)ctx->eff_threads, sizeof(hscopt_decode_ctx));
+  ctx->shake_idx = (size_t *)hscopt_alloc(
+      &ctx->alloc, ctx->n_cand * ctx->n_spec * ctx->cap_k * sizeof(size_t));
+  if (!ctx->perm_tls || !ctx->dctx_tls || !ctx->shake_idx ||
+      rvns_perm_create_all(ctx, ctx->dim, ctx->x, ctx->perm_tls) != 0) {
+    rvns_perm_release(ctx);
+    return 1;
   }
+  return 0;
 }
 
-int hscopt_rvns_iterate(hscopt_rvns_ctx *ctx, unsigned iters) {
-  if (!ctx || iters == 0) {
-    return 1;  // o núemro de itereações executadas não pode ser 0
+int hscopt_rvns_try_update_best(hscopt_rvns_ctx *ctx, const double *keys) {
+  if (!ctx || !keys) {
+    return -1;
+  }
+
+  hscopt_decode_ctx *dc = ctx->dctx;
+  if (ctx->perm_tls) {
+    hscopt_rvns_impl_perm_sync(ctx);
+    hscopt_keys_perm_build(ctx->perm_tls[0], keys);
+    dc = &ctx->dctx_tls[0];
+  }
+  hscopt_decode_ctx cut;
+  if (ctx->cutoff) {
+    // Só interessa um objetivo menor que o da incumbente.
+    if (dc) {
+      cut = *dc;
+    } else {
+      memset(&cut, 0, sizeof(cut));
+    }
+    cut.bounded = 1;
+    cut.cutoff = ctx->fx;
+    dc = &cut;
+  }
+
+  const double f = ctx->decoder(keys, ctx->dim, dc);
+  if (!(f < ctx->fx)) {
+    if (ctx->perm_tls) hscopt_keys_perm_build(ctx->perm_tls[0], ctx->x);
+    return 0;
   }
 
-  if (ctx->iter >= ctx->max_iters) {
-    return 2;  // iter já ultrapassou o maximo de iterações
+  memcpy(ctx->x, keys, ctx->dim * sizeof(double));
+  ctx->fx = f;
+  if (ctx->perm_tls) {
+    for (unsigned t = 1; t < ctx->eff_threads; ++t) {
+      hscopt_keys_perm_build(ctx->perm_tls[t], ctx->x);
+    }
   }
-  if (ctx->iter + iters > ctx->max_iters) {
-    return 2;  // passa o máximo ao executar as iterações solicitadas
+  if (f < ctx->fbest) {
+    ctx->fbest = f;
+    memcpy(ctx->best, ctx->x, ctx->dim * sizeof(double));
   }
+  return 1;
+}
+
+int hscopt_rvns_track_perm(const hscopt_rvns_ctx *ctx) {
+  return ctx && ctx->perm_tls ? 1 : 0;
+}
 
-  for (unsigned it = 0; it < iters; ++it) {
-    size_t k = 1;  // nível da pertubação
+// Troca os buffers dos candidatos por buffers para n_spec níveis de n_cand
+// candidatos; em falta de memória, mantém os atuais e retorna 1.
+static int rvns_cand_alloc(hscopt_rvns_ctx *ctx, size_t n_cand,
+                           size_t n_spec) {
+  if (n_cand > SIZE_MAX / n_spec / ctx->cap_dim / sizeof(double) ||
+      n_cand > SIZE_MAX / n_spec / ctx->cap_k / sizeof(size_t)) {
+    return 1;
+  }
+  const size_t n_rows = n_cand * n_spec;
+
+  double *keys = (double *)hscopt_alloc(
+      &ctx->alloc, n_rows * ctx->cap_dim * sizeof(double));
+  double *fit = (double *)hscopt_alloc(&ctx->alloc, n_rows * sizeof(double));
+  size_t *idx = NULL;
+  if (ctx->perm_tls) {
+    idx = (size_t *)hscopt_alloc(&ctx->alloc,
+                                 n_rows * ctx->cap_k * sizeof(size_t));
+  }
+  const double **rows = NULL;
+  if (ctx->async.submit) {
+    rows = (const double **)hscopt_alloc(&ctx->alloc,
+                                         n_rows * sizeof(double *));
+  }
+  if (!keys || !fit || (ctx->perm_tls && !idx) ||
+      (ctx->async.submit && !rows) ||
+      (ctx->surrogate && n_cand != ctx->n_cand &&
+       rvns_surrogate_alloc(ctx, n_cand) != 0)) {
+    hscopt_free(&ctx->alloc, keys);
+    hscopt_free(&ctx->alloc, fit);
+    hscopt_free(&ctx->alloc, idx);
+    hscopt_free(&ctx->alloc, rows);
+    return 1;
+  }
 
-    while (k <= ctx->k_max) {
+  // Cada thread toca primeiro os candidatos que vai gerar (mesmo
+  // schedule de hscopt_rvns_iterate).
 #ifdef _OPENMP
-#pragma omp parallel for num_threads(ctx->eff_threads)
+#pragma omp parallel num_threads(ctx->eff_threads)
 #endif
-      for (int tid_i = 0; tid_i < (int)ctx->eff_threads; ++tid_i) {
-        const unsigned tid = (unsigned)tid_i;
-        double *y = CAND_PTR(ctx, tid);
-        rvns_shake(y, ctx->x, ctx->dim, k, &ctx->rng_tls[tid]);
-        ctx->cand_fit[tid] = ctx->decoder(y, ctx->dim, ctx->dctx);
-      }
+  {
+    hscopt_rvns_impl_pin(ctx);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (ptrdiff_t ri = 0; ri < (ptrdiff_t)n_rows; ++ri) {
+      const size_t r = (size_t)ri;
+      memset(&keys[r * ctx->cap_dim], 0, ctx->cap_dim * sizeof(double));
+      fit[r] = INFINITY;
+    }
+    hscopt_rvns_impl_unpin(ctx);
+  }
 
-      unsigned best_tid = 0;
-      double fy_best = ctx->cand_fit[0];
-      for (unsigned tid = 1; tid < ctx->eff_threads; ++tid) {
-        const double fy = ctx->cand_fit[tid];
-        if (fy < fy_best) {
-          fy_best = fy;
-          best_tid = tid;
-        }
-      }
+  hscopt_free(&ctx->alloc, ctx->cand_keys);
+  hscopt_free(&ctx->alloc, ctx->cand_fit);
+  ctx->cand_keys = keys;
+  ctx->cand_fit = fit;
+  if (ctx->perm_tls) {
+    hscopt_free(&ctx->alloc, ctx->shake_idx);
+    ctx->shake_idx = idx;
+  }
+  if (ctx->async.submit) {
+    hscopt_free(&ctx->alloc, ctx->async_rows);
+    ctx->async_rows = rows;
+  }
+  ctx->n_cand = n_cand;
+  ctx->n_spec = n_spec;
+  return 0;
+}
+
+int hscopt_rvns_set_candidates(hscopt_rvns_ctx *ctx, size_t n_cand) {
+  if (!ctx || n_cand == 0) {
+    return 1;
+  }
+  if (n_cand == ctx->n_cand) {
+    return 0;
+  }
+  return rvns_cand_alloc(ctx, n_cand, ctx->n_spec);
+}
+
+int hscopt_rvns_set_speculation(hscopt_rvns_ctx *ctx, size_t levels) {
+  if (!ctx || levels == 0) {
+    return 1;
+  }
+  if (levels == ctx->n_spec) {
+    return 0;
+  }
+  return rvns_cand_alloc(ctx, ctx->n_cand, levels);
+}
+
+size_t hscopt_rvns_speculation(const hscopt_rvns_ctx *ctx) {
+  return ctx ? ctx->n_spec : 0u;
+}
 
-      if (fy_best < ctx->fx) {
-        memcpy(ctx->x, CAND_PTR(ctx, best_tid), ctx->dim * sizeof(double));
-        ctx->fx = fy_best;
+// Garante capacidade para dim chaves e k_max posições sorteadas e recria as
+// permutações se dim mudar. O conteúdo não é preservado (o chamador faz o
+// reset). Em falta de memória, mantém os buffers atuais e retorna 1.
+static int rvns_reserve(hscopt_rvns_ctx *ctx, size_t dim, size_t k_max) {
+  const size_t cd = (dim > ctx->cap_dim ? dim : ctx->cap_dim);
+  const size_t ck = (k_max > ctx->cap_k ? k_max : ctx->cap_k);
+  const int grow_dim = (cd > ctx->cap_dim);
+  const int grow_k = (ck > ctx->cap_k);
+  const int grow_idx = (ctx->perm_tls && grow_k);
+  const int new_perm = (ctx->perm_tls && dim != ctx->dim);
+  const size_t n_rows = ctx->n_cand * ctx->n_spec;
+  if (cd > SIZE_MAX / sizeof(double) / n_rows ||
+      ck > SIZE_MAX / sizeof(size_t) / n_rows) {
+    return 1;
+  }
 
-        if (ctx->fx < ctx->fbest) {
-          ctx->fbest = ctx->fx;
-          memcpy(ctx->best, ctx->x, ctx->dim * sizeof(double));
-        }
+  double *x = NULL, *best = NULL, *keys = NULL;
+  size_t *idx = NULL;
+  hscopt_rvns_nbhd_stats *nbhd = NULL;
+  hscopt_keys_perm **perm = NULL;
+  int rc = 0;
+  if (grow_dim) {
+    x = (double *)hscopt_alloc(&ctx->alloc, cd * sizeof(double));
+    best = (double *)hscopt_alloc(&ctx->alloc, cd * sizeof(double));
+    keys = (double *)hscopt_alloc(&ctx->alloc,
+                                  n_rows * cd * sizeof(double));
+    rc = (!x || !best || !keys);
+  }
+  if (!rc && grow_k) {
+    nbhd = (hscopt_rvns_nbhd_stats *)hscopt_alloc(&ctx->alloc,
+                                                  ck * sizeof(*nbhd));
+    rc = !nbhd;
+  }
+  if (!rc && grow_idx) {
+    idx = (size_t *)hscopt_alloc(&ctx->alloc,
+                                 n_rows * ck * sizeof(size_t));
+    rc = !idx;
+  }
+  if (!rc && new_perm) {
+    perm = (hscopt_keys_perm **)hscopt_calloc(
+        &ctx->alloc, (size_t)ctx->eff_threads, sizeof(hscopt_keys_perm *));
+    rc = (!perm || rvns_perm_create_all(ctx, dim, NULL, perm) != 0);
+  }
+  if (rc) {
+    hscopt_free(&ctx->alloc, x);
+    hscopt_free(&ctx->alloc, best);
+    hscopt_free(&ctx->alloc, keys);
+    hscopt_free(&ctx->alloc, nbhd);
+    hscopt_free(&ctx->alloc, idx);
+    hscopt_free(&ctx->alloc, perm);
+    return 1;
+  }
 
-        k = 1; /* volta para N_1 */
-      } else {
-        ++k;
+  if (grow_dim) {
+    // Mesmo first-touch de hscopt_rvns_set_candidates().
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ctx->eff_threads)
+#endif
+    {
+      hscopt_rvns_impl_pin(ctx);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (ptrdiff_t ri = 0; ri < (ptrdiff_t)n_rows; ++ri) {
+        memset(&keys[(size_t)ri * cd], 0, cd * sizeof(double));
       }
+      hscopt_rvns_impl_unpin(ctx);
     }
+    hscopt_free(&ctx->alloc, ctx->x);
+    hscopt_free(&ctx->alloc, ctx->best);
+    hscopt_free(&ctx->alloc, ctx->cand_keys);
+    ctx->x = x;
+    ctx->best = best;
+    ctx->cand_keys = keys;
+    ctx->cap_dim = cd;
+  }
+  if (grow_k) {
+    hscopt_free(&ctx->alloc, ctx->nbhd);
+    ctx->nbhd = nbhd;
+  }
+  if (grow_idx) {
+    hscopt_free(&ctx->alloc, ctx->shake_idx);
+    ctx->shake_idx = idx;
+  }
+  ctx->cap_k = ck;
+  if (new_perm) {
+    for (unsigned t = 0; t < ctx->eff_threads; ++t) {
+      hscopt_keys_perm_destroy(ctx->perm_tls[t]);
+      ctx->perm_tls[t] = perm[t];
+    }
+    hscopt_free(&ctx->alloc, perm);
+  }
+  return 0;
+}
+
+int hscopt_rvns_reconfigure(hscopt_rvns_ctx *ctx, const double *x0,
+                            size_t dim, size_t k_max, unsigned max_iters,
+                            hscopt_decoder_fn decoder,
+                            hscopt_decode_ctx *dctx) {
+  if (!ctx || !decoder || dim == 0 || k_max == 0 || max_iters == 0) {
+    return 1;
+  }
+  if (rvns_reserve(ctx, dim, k_max) != 0) {
+    return 1;
+  }
 
-    ++ctx->iter;
+  if (dim != ctx->dim) {
+    ctx->kernel = rvns_select_kernel(dim);
+  }
+  if (ctx->surrogate && hscopt_surrogate_dim(ctx->surrogate) != dim) {
+    ctx->surrogate = NULL;
+  }
+  if (ctx->board && hscopt_board_dim(ctx->board) != dim) {
+    hscopt_rvns_set_board(ctx, NULL);
   }
+  ctx->dim = dim;
+  ctx->k_max = k_max;
+  ctx->max_iters = max_iters;
+  ctx->decoder = decoder;
+  ctx->dctx = dctx;
+  return hscopt_rvns_reset(ctx, x0);
+}
+
+int hscopt_rvns_set_async(hscopt_rvns_ctx *ctx,
+                          const hscopt_async_decoder *ad) {
+  if (!ctx || (ad && (!ad->submit || !ad->wait_any))) {
+    return 1;
+  }
+
+  hscopt_free(&ctx->alloc, ctx->async_rows);
+  ctx->async_rows = NULL;
+  memset(&ctx->async, 0, sizeof(ctx->async));
+  if (!ad) {
+    return 0;
+  }
+
+  ctx->async_rows = (const double **)hscopt_alloc(
+      &ctx->alloc, ctx->n_cand * ctx->n_spec * sizeof(double *));
+  if (!ctx->async_rows) {
+    return 1;
+  }
+  ctx->async = *ad;
+  return 0;
+}
+
+int hscopt_rvns_set_cutoff(hscopt_rvns_ctx *ctx, int enable) {
+  if (!ctx) {
+    return 1;
+  }
+  ctx->cutoff = (enable != 0);
+  return 0;
+}
+
+int hscopt_rvns_set_policy(hscopt_rvns_ctx *ctx, hscopt_rvns_policy policy) {
+  if (!ctx ||
+      (policy != HSCOPT_RVNS_LADDER && policy != HSCOPT_RVNS_UCB)) {
+    return 1;
+  }
+  ctx->policy = policy;
+  return 0;
+}
+
+int hscopt_rvns_get_nbhd_stats(const hscopt_rvns_ctx *ctx, size_t k,
+                               hscopt_rvns_nbhd_stats *out) {
+  if (!ctx || !out || k == 0 || k > ctx->k_max) {
+    return 1;
+  }
+  *out = ctx->nbhd[k - 1];
   return 0;
 }
+
+int hscopt_rvns_set_surrogate(hscopt_rvns_ctx *ctx, hscopt_surrogate *s) {
+  if (!ctx || (s && hscopt_surrogate_dim(s) != ctx->dim)) {
+    return 1;
+  }
+
+  if (!s) {
+    rvns_surrogate_release(ctx);
+  } else if (!ctx->surr_v && rvns_surrogate_alloc(ctx, ctx->n_cand) != 0) {
+    return 1;
+  }
+  ctx->surrogate = s;
+  hscopt_surrogate_add(s, ctx->x, ctx->fx);
+  return 0;
+}
+
+int hscopt_rvns_set_board(hscopt_rvns_ctx *ctx, hscopt_board *b) {
+  if (!ctx || (b && hscopt_board_dim(b) != ctx->dim)) {
+    return 1;
+  }
+
+  hscopt_free(&ctx->alloc, ctx->board_keys);
+  ctx->board_keys = NULL;
+  ctx->board = NULL;
+  if (!b) {
+    return 0;
+  }
+
+  ctx->board_keys =
+      (double *)hscopt_alloc(&ctx->alloc, ctx->dim * sizeof(double));
+  if (!ctx->board_keys) {
+    return 1;
+  }
+  ctx->board = b;
+  ctx->board_pub = INFINITY;
+  ctx->board_seen = 0u;
+  return 0;
+}
+
+size_t hscopt_rvns_candidates(const hscopt_rvns_ctx *ctx) {
+  return ctx ? ctx->n_cand : 0u;
+}
+
+// Instancia o núcleo de rvns_impl.h com dim = D: a iteração e as linhas de
+// candidatos (shaking e avaliação), que rodam dentro da região paralela. As
+// duas são clonadas por nível de ISA (HSCOPT_TARGET_CLONES) e escolhidas
+// pela CPU em runtime; o corpo da região paralela, que o compilador extrai
+// sem os clones, só chama as linhas.
+#define RVNS_FIXED_DIM_KERNEL(D)                                            \
+  HSCOPT_TARGET_CLONES static void rvns_rows_d##D(                          \
+      hscopt_rvns_ctx *ctx, const hscopt_rvns_impl_rows *job, size_t lo,    \
+      size_t hi) {                                                          \
+    hscopt_rvns_impl_rows_run(ctx, job, lo, hi, (size_t)(D), ctx->decoder); \
+  }                                                                         \
+  HSCOPT_TARGET_CLONES static void rvns_iterate_d##D(hscopt_rvns_ctx *ctx,  \
+                                                     unsigned iters) {      \
+    hscopt_rvns_impl_iterate(ctx, iters, (size_t)(D), ctx->decoder,         \
+                             rvns_rows_d##D);                               \
+  }
+HSCOPT_FOR_EACH_FIXED_DIM(RVNS_FIXED_DIM_KERNEL)
+#undef RVNS_FIXED_DIM_KERNEL
+
+HSCOPT_TARGET_CLONES static void rvns_rows_any(
+    hscopt_rvns_ctx *ctx, const hscopt_rvns_impl_rows *job, size_t lo,
+    size_t hi) {
+  hscopt_rvns_impl_rows_run(ctx, job, lo, hi, ctx->dim, ctx->decoder);
+}
+
+HSCOPT_TARGET_CLONES static void rvns_iterate_any(hscopt_rvns_ctx *ctx,
+                                                  unsigned iters) {
+  hscopt_rvns_impl_iterate(ctx, iters, ctx->dim, ctx->decoder,
+                           rvns_rows_any);
+}
+
+static hscopt_rvns_kernel_fn rvns_select_kernel(size_t dim) {
+#define RVNS_FIXED_DIM_CASE(D) \
+  case D:                      \
+    return rvns_iterate_d##D;
+  switch (dim) {
+    HSCOPT_FOR_EACH_FIXED_DIM(RVNS_FIXED_DIM_CASE)
+    default:
+      return rvns_iterate_any;
+  }
+#undef RVNS_FIXED_DIM_CASE
+}
+
+int hscopt_rvns_iterate(hscopt_rvns_ctx *ctx, unsigned iters) {
+  const int rc = hscopt_rvns_impl_begin(ctx, iters);
+  if (rc != 0) {
+    return rc;
+  }
+
+  if (ctx->async.submit) {
+    return hscopt_rvns_impl_iterate(ctx, iters, ctx->dim, NULL,
+                                    rvns_rows_any);
+  }
+
+  ctx->kernel(ctx, iters);
+  return 0;
+}
+
+static void *rvns_solver_create(const hscopt_solver_config *cfg) {
+  const hscopt_rvns_params *p = (const hscopt_rvns_params *)cfg->params;
+  if (!p) return NULL;
+  return hscopt_rvns_create_with_allocator(p->x0, cfg->dim, p->k_max,
+                                           cfg->max_iters, cfg->max_threads,
+                                           cfg->decoder, cfg->dctx, cfg->rng,
+                                           cfg->alloc);
+}
+
+static int rvns_solver_reconfigure(void *solver,
+                                   const hscopt_solver_config *cfg) {
+  hscopt_rvns_ctx *const ctx = (hscopt_rvns_ctx *)solver;
+  const hscopt_rvns_params *p = (const hscopt_rvns_params *)cfg->params;
+  const unsigned threads = (cfg->max_threads == 0u ? 1u : cfg->max_threads);
+  if (!p || !cfg->rng || threads != ctx->max_threads) {
+    return 1;
+  }
+  const hscopt_rng old = ctx->rng;
+  ctx->rng = *cfg->rng;
+  const int rc = hscopt_rvns_reconfigure(ctx, p->x0, cfg->dim, p->k_max,
+                                         cfg->max_iters, cfg->decoder,
+                                         cfg->dctx);
+  if (rc == 1) {
+    ctx->rng = old;
+  }
+  return rc;
+}
+
+static void rvns_solver_destroy(void *solver) {
+  hscopt_rvns_destroy((hscopt_rvns_ctx *)solver);
+}
+
+static int rvns_solver_iterate(void *solver, unsigned iters) {
+  return hscopt_rvns_iterate((hscopt_rvns_ctx *)solver, iters);
+}
+
+static double rvns_solver_best_fitness(const void *solver) {
+  return hscopt_rvns_best_fitness((const hscopt_rvns_ctx *)solver);
+}
+
+static const double *rvns_solver_best_keys(const void *solver) {
+  return hscopt_rvns_best_keys((const hscopt_rvns_ctx *)solver);
+}
+
+static unsigned rvns_solver_iteration(const void *solver) {
+  return hscopt_rvns_iteration((const hscopt_rvns_ctx *)solver);
+}
+
+static int rvns_solver_inject(void *solver, const double *keys) {
+  return hscopt_rvns_try_update_best((hscopt_rvns_ctx *)solver, keys);
+}
+
+const hscopt_solver_vtable hscopt_rvns_solver = {
+    .name = "rvns",
+    .create = rvns_solver_create,
+    .destroy = rvns_solver_destroy,
+    .iterate = rvns_solver_iterate,
+    .best_fitness = rvns_solver_best_fitness,
+    .best_keys = rvns_solver_best_keys,
+    .iteration = rvns_solver_iteration,
+    .inject = rvns_solver_inject,
+    .reconfigure = rvns_solver_reconfigure,
+};
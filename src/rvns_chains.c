@@ -0,0 +1,199 @@
+#include "hscopt/rvns_chains.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#include "hscopt/alloc.h"
+#include "hscopt/board.h"
+#include "hscopt/rng.h"
+#include "hscopt/rvns.h"
+
+typedef struct chains_run chains_run;
+
+typedef struct chains_chain {
+  chains_run *run;
+  hscopt_rng rng;
+  hscopt_rvns_ctx *ctx;
+  double *snap;      // cópia do incumbente global [dim]
+  double published;  // último fitness publicado por esta cadeia
+  uint64_t publishes;
+  uint64_t restarts;
+  int rc;
+
+  thrd_t thread;
+  int joinable;
+} chains_chain;
+
+struct chains_run {
+  size_t dim;
+  unsigned max_iters;
+  hscopt_decoder_fn decoder;
+  hscopt_decode_ctx *dctx;
+  hscopt_rvns_chains_opts opts;
+  hscopt_board *inc;  // incumbente global
+  hscopt_allocator alloc;
+};
+
+void hscopt_rvns_chains_opts_default(hscopt_rvns_chains_opts *out) {
+  if (!out) return;
+  out->n_chains = 1u;
+  out->k_max = 5u;
+  out->stall_iters = 50u;
+  out->policy = HSCOPT_RVNS_LADDER;
+}
+
+static int chains_main(void *arg) {
+  chains_chain *const c = (chains_chain *)arg;
+  chains_run *const run = c->run;
+  const size_t dim = run->dim;
+
+  // Contexto e buffers criados na thread da cadeia (first-touch).
+  c->ctx = hscopt_rvns_create_with_allocator(
+      NULL, dim, run->opts.k_max, run->max_iters, 1u, run->decoder,
+      run->dctx, &c->rng, &run->alloc);
+  c->snap = (double *)hscopt_alloc(&run->alloc, dim * sizeof(double));
+  if (!c->ctx || !c->snap) {
+    c->rc = 2;
+    return 0;
+  }
+  hscopt_rvns_set_policy(c->ctx, run->opts.policy);
+
+  double last = INFINITY;
+  unsigned stall = 0;
+  for (unsigned it = 0; it < run->max_iters; ++it) {
+    const double f = hscopt_rvns_best_fitness(c->ctx);
+    if (f < last) {
+      last = f;
+      stall = 0;
+    } else {
+      ++stall;
+    }
+    // Uma publicação que encontrou outra em andamento é refeita aqui.
+    if (f < c->published) {
+      const int p =
+          hscopt_board_offer(run->inc, hscopt_rvns_best_keys(c->ctx), f);
+      if (p >= 0) c->published = f;
+      c->publishes += (uint64_t)(p > 0);
+    }
+
+    const unsigned stall_max = run->opts.stall_iters;
+    if (stall_max > 0 && stall >= stall_max) {
+      stall = 0;
+      if (hscopt_board_fitness(run->inc) < f) {
+        hscopt_board_read(run->inc, c->snap, NULL, NULL);
+        if (hscopt_rvns_try_update_best(c->ctx, c->snap) == 1) {
+          ++c->restarts;
+          last = hscopt_rvns_best_fitness(c->ctx);
+          c->published = last;
+        }
+      }
+    }
+
+    if (hscopt_rvns_iterate(c->ctx, 1) != 0) {
+      c->rc = 2;
+      return 0;
+    }
+  }
+
+  // Melhoria da última iteração; se houver outra escrita em andamento, o
+  // resultado final sai do contexto da cadeia do mesmo jeito.
+  const double f = hscopt_rvns_best_fitness(c->ctx);
+  if (f < c->published &&
+      hscopt_board_offer(run->inc, hscopt_rvns_best_keys(c->ctx), f) > 0) {
+    ++c->publishes;
+  }
+  return 0;
+}
+
+int hscopt_rvns_chains_run(size_t dim, unsigned max_iters,
+                           hscopt_decoder_fn decoder, hscopt_decode_ctx *dctx,
+                           const hscopt_rng *rng,
+                           const hscopt_rvns_chains_opts *opts,
+                           double *best_keys, hscopt_rvns_chains_result *out) {
+  hscopt_rvns_chains_opts o;
+  hscopt_rvns_chains_opts_default(&o);
+  if (opts) {
+    o = *opts;
+  }
+  if (dim == 0 || max_iters == 0 || !decoder || !rng || !best_keys ||
+      o.n_chains == 0 || o.k_max == 0) {
+    return 1;
+  }
+
+  chains_run run = {
+      .dim = dim,
+      .max_iters = max_iters,
+      .decoder = decoder,
+      .dctx = dctx,
+      .opts = o,
+  };
+  hscopt_get_allocator(&run.alloc);
+  run.inc = hscopt_board_create_with_allocator(dim, &run.alloc);
+  chains_chain *chains = (chains_chain *)hscopt_calloc(
+      &run.alloc, o.n_chains, sizeof(chains_chain));
+  if (!run.inc || !chains) {
+    hscopt_board_destroy(run.inc);
+    hscopt_free(&run.alloc, chains);
+    return 2;
+  }
+
+  hscopt_rng r = *rng;
+  for (unsigned i = 0; i < o.n_chains; ++i) {
+    chains[i].run = &run;
+    chains[i].rng = r;
+    chains[i].published = INFINITY;
+    hscopt_rng_jump(&r);
+  }
+
+  // A chamadora roda a cadeia 0; cadeias sem thread rodam depois dela.
+  int rc = 0;
+  for (unsigned i = 1; i < o.n_chains; ++i) {
+    if (thrd_create(&chains[i].thread, chains_main, &chains[i]) ==
+        thrd_success) {
+      chains[i].joinable = 1;
+    } else {
+      rc = 3;
+    }
+  }
+  chains_main(&chains[0]);
+  for (unsigned i = 1; i < o.n_chains; ++i) {
+    if (!chains[i].joinable) chains_main(&chains[i]);
+  }
+
+  hscopt_rvns_chains_result res = {
+      .best_fitness = INFINITY,
+      .chain = 0u,
+      .publishes = 0u,
+      .restarts = 0u,
+  };
+  for (unsigned i = 0; i < o.n_chains; ++i) {
+    chains_chain *const c = &chains[i];
+    if (c->joinable) {
+      thrd_join(c->thread, NULL);
+    }
+    if (c->rc != 0 && rc == 0) {
+      rc = c->rc;
+    }
+    res.publishes += c->publishes;
+    res.restarts += c->restarts;
+    if (c->ctx && hscopt_rvns_best_fitness(c->ctx) < res.best_fitness) {
+      res.best_fitness = hscopt_rvns_best_fitness(c->ctx);
+      res.chain = i;
+      memcpy(best_keys, hscopt_rvns_best_keys(c->ctx), dim * sizeof(double));
+    }
+  }
+  for (unsigned i = 0; i < o.n_chains; ++i) {
+    hscopt_rvns_destroy(chains[i].ctx);
+    hscopt_free(&run.alloc, chains[i].snap);
+  }
+  hscopt_board_destroy(run.inc);
+  hscopt_free(&run.alloc, chains);
+
+  if (out) {
+    *out = res;
+  }
+  return rc;
+}
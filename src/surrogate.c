@@ -0,0 +1,248 @@
+#include "hscopt/surrogate.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hscopt/alloc.h"
+
+#define SURROGATE_DEFAULT_CAPACITY 256u
+#define SURROGATE_DEFAULT_K 8u
+#define SURROGATE_MAX_K 64u
+#define SURROGATE_DEFAULT_AUDIT 16u
+#define SURROGATE_DEFAULT_KAPPA 1.0
+#define SURROGATE_EPS 1e-12  // evita divisão por zero no peso
+
+struct hscopt_surrogate {
+  size_t dim;
+  size_t capacity;
+  size_t k;
+  size_t count;  // pontos válidos
+  size_t head;   // próxima posição a sobrescrever
+  double *keys;  // [capacity * dim]
+  double *fit;   // [capacity]
+
+  unsigned audit;        // período da auditoria (0 = nunca)
+  unsigned since_audit;  // rejeições desde a última auditoria
+  double kappa;          // peso da dispersão no limite inferior
+  hscopt_surrogate_stats stats;
+
+  hscopt_allocator alloc;
+};
+
+hscopt_surrogate *hscopt_surrogate_create(size_t dim, size_t capacity,
+                                          size_t k) {
+  return hscopt_surrogate_create_with_allocator(dim, capacity, k, NULL);
+}
+
+hscopt_surrogate *hscopt_surrogate_create_with_allocator(
+    size_t dim, size_t capacity, size_t k, const hscopt_allocator *alloc) {
+  if (dim == 0 || k > SURROGATE_MAX_K) {
+    return NULL;
+  }
+  const size_t cap = (capacity == 0 ? SURROGATE_DEFAULT_CAPACITY : capacity);
+  if (dim > SIZE_MAX / sizeof(double) / cap) {
+    return NULL;
+  }
+
+  hscopt_allocator resolved;
+  if (alloc) {
+    if (!alloc->alloc || !alloc->calloc || !alloc->free) {
+      return NULL;
+    }
+    resolved = *alloc;
+  } else {
+    hscopt_get_allocator(&resolved);
+  }
+
+  hscopt_surrogate *s =
+      (hscopt_surrogate *)hscopt_calloc(&resolved, 1, sizeof(*s));
+  if (!s) {
+    return NULL;
+  }
+  s->alloc = resolved;
+  s->dim = dim;
+  s->capacity = cap;
+  s->k = (k == 0 ? SURROGATE_DEFAULT_K : k);
+  s->audit = SURROGATE_DEFAULT_AUDIT;
+  s->kappa = SURROGATE_DEFAULT_KAPPA;
+  s->keys = (double *)hscopt_alloc(&s->alloc, cap * dim * sizeof(double));
+  s->fit = (double *)hscopt_alloc(&s->alloc, cap * sizeof(double));
+  if (!s->keys || !s->fit) {
+    hscopt_surrogate_destroy(s);
+    return NULL;
+  }
+  return s;
+}
+
+void hscopt_surrogate_destroy(hscopt_surrogate *s) {
+  if (!s) return;
+  hscopt_free(&s->alloc, s->keys);
+  hscopt_free(&s->alloc, s->fit);
+  hscopt_free(&s->alloc, s);
+}
+
+void hscopt_surrogate_add(hscopt_surrogate *s, const double *keys,
+                          double fitness) {
+  if (!s || !keys || !isfinite(fitness)) return;
+  // Repetidos (ex.: hawks que não se moveram) colapsariam os k vizinhos.
+  for (size_t p = 0; p < s->count; ++p) {
+    if (memcmp(&s->keys[p * s->dim], keys, s->dim * sizeof(double)) == 0) {
+      return;
+    }
+  }
+  memcpy(&s->keys[s->head * s->dim], keys, s->dim * sizeof(double));
+  s->fit[s->head] = fitness;
+  s->head = (s->head + 1u == s->capacity ? 0u : s->head + 1u);
+  if (s->count < s->capacity) ++s->count;
+}
+
+double hscopt_surrogate_predict(const hscopt_surrogate *s, const double *keys,
+                                double *spread) {
+  if (spread) *spread = 0.0;
+  if (!s || !keys || s->count == 0) {
+    return NAN;
+  }
+
+  // Os k menores d², em ordem crescente (inserção: k é pequeno).
+  double best_d[SURROGATE_MAX_K];
+  double best_f[SURROGATE_MAX_K];
+  const size_t k = (s->k < s->count ? s->k : s->count);
+  size_t n = 0;
+
+  for (size_t p = 0; p < s->count; ++p) {
+    const double *const x = &s->keys[p * s->dim];
+    double d2 = 0.0;
+    for (size_t j = 0; j < s->dim; ++j) {
+      const double t = x[j] - keys[j];
+      d2 += t * t;
+    }
+    if (d2 == 0.0) {
+      return s->fit[p];  // ponto já avaliado
+    }
+    if (n == k && d2 >= best_d[k - 1u]) {
+      continue;
+    }
+
+    size_t pos = (n < k ? n++ : k - 1u);
+    while (pos > 0 && best_d[pos - 1u] > d2) {
+      best_d[pos] = best_d[pos - 1u];
+      best_f[pos] = best_f[pos - 1u];
+      --pos;
+    }
+    best_d[pos] = d2;
+    best_f[pos] = s->fit[p];
+  }
+
+  double wsum = 0.0, fsum = 0.0;
+  for (size_t t = 0; t < n; ++t) {
+    const double w = 1.0 / (best_d[t] + SURROGATE_EPS);
+    wsum += w;
+    fsum += w * best_f[t];
+  }
+  const double mean = fsum / wsum;
+
+  if (spread) {
+    double var = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+      const double e = best_f[t] - mean;
+      var += e * e / (best_d[t] + SURROGATE_EPS);
+    }
+    *spread = sqrt(var / wsum);
+  }
+  return mean;
+}
+
+hscopt_surrogate_verdict hscopt_surrogate_screen(hscopt_surrogate *s,
+                                                 const double *keys,
+                                                 double threshold) {
+  if (!s || !keys) {
+    return HSCOPT_SURROGATE_EVAL;
+  }
+  ++s->stats.queries;
+
+  double spread;
+  const double mean = hscopt_surrogate_predict(s, keys, &spread);
+  if (s->count < s->k || mean - s->kappa * spread < threshold) {
+    ++s->stats.passed;
+    return HSCOPT_SURROGATE_EVAL;
+  }
+
+  ++s->stats.rejected;
+  if (s->audit != 0 && ++s->since_audit >= s->audit) {
+    s->since_audit = 0;
+    ++s->stats.audits;
+    return HSCOPT_SURROGATE_AUDIT;
+  }
+  return HSCOPT_SURROGATE_SKIP;
+}
+
+void hscopt_surrogate_record(hscopt_surrogate *s, const double *keys,
+                             double fitness, double threshold,
+                             hscopt_surrogate_verdict v) {
+  if (!s) return;
+  const int below = fitness < threshold;
+  if (v == HSCOPT_SURROGATE_EVAL && below) {
+    ++s->stats.pass_hits;
+  } else if (v == HSCOPT_SURROGATE_AUDIT && below) {
+    ++s->stats.audit_misses;
+  }
+  hscopt_surrogate_add(s, keys, fitness);
+}
+
+int hscopt_surrogate_set_audit(hscopt_surrogate *s, unsigned period) {
+  if (!s) {
+    return 1;
+  }
+  s->audit = period;
+  s->since_audit = 0;
+  return 0;
+}
+
+int hscopt_surrogate_set_kappa(hscopt_surrogate *s, double kappa) {
+  if (!s || !isfinite(kappa) || kappa < 0.0) {
+    return 1;
+  }
+  s->kappa = kappa;
+  return 0;
+}
+
+size_t hscopt_surrogate_size(const hscopt_surrogate *s) {
+  return s ? s->count : 0u;
+}
+
+size_t hscopt_surrogate_dim(const hscopt_surrogate *s) {
+  return s ? s->dim : 0u;
+}
+
+void hscopt_surrogate_get_stats(const hscopt_surrogate *s,
+                                hscopt_surrogate_stats *out) {
+  if (!out) return;
+  if (!s) {
+    memset(out, 0, sizeof(*out));
+    return;
+  }
+  *out = s->stats;
+}
+
+void hscopt_surrogate_reset_stats(hscopt_surrogate *s) {
+  if (!s) return;
+  memset(&s->stats, 0, sizeof(s->stats));
+  s->since_audit = 0;
+}
+
+double hscopt_surrogate_accuracy(const hscopt_surrogate *s) {
+  if (!s || s->stats.queries == 0 ||
+      (s->stats.rejected > 0 && s->stats.audits == 0)) {
+    return NAN;
+  }
+
+  double true_rej = 0.0;
+  if (s->stats.rejected > 0) {
+    const double miss =
+        (double)s->stats.audit_misses / (double)s->stats.audits;
+    true_rej = (double)s->stats.rejected * (1.0 - miss);
+  }
+  return ((double)s->stats.pass_hits + true_rej) / (double)s->stats.queries;
+}